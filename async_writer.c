@@ -0,0 +1,149 @@
+/*
+ * async_writer.c - Background thread writing solution files
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "async_writer.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "job_context.h"
+#include "solution_writer.h"
+
+typedef struct {
+    char* filename;
+    SolveResult result;    // owns the solution vectors
+    ProblemData problem;   // sizes and names only; owns the names
+} WriteRequest;
+
+struct AsyncWriter {
+    JobContext job;        // options and thread pool for formatting
+    pthread_t thread;
+    
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_free;
+    pthread_cond_t request_ready;
+    
+    // Ring buffer of requests waiting to be written
+    WriteRequest ring[ASYNC_WRITER_MAX_PENDING];
+    size_t head;
+    size_t queued;
+    int closing;           // no more requests; exit once the queue is empty
+    
+    AsyncWriterStats stats;
+};
+
+static void* writer_main(void* arg) {
+    AsyncWriter* writer = arg;
+    pthread_mutex_lock(&writer->mutex);
+    for (;;) {
+        while (writer->queued == 0 && !writer->closing) {
+            pthread_cond_wait(&writer->request_ready, &writer->mutex);
+        }
+        if (writer->queued == 0) {
+            break;
+        }
+        WriteRequest request = writer->ring[writer->head];
+        writer->head = (writer->head + 1) % ASYNC_WRITER_MAX_PENDING;
+        writer->queued--;
+        pthread_cond_signal(&writer->slot_free);
+        pthread_mutex_unlock(&writer->mutex);
+        
+        double write_start = wall_clock_seconds();
+        int status = request.filename ?
+            solution_write(&writer->job, request.filename, &request.result, &request.problem) : -1;
+        double busy = wall_clock_seconds() - write_start;
+        free(request.result.primal_solution);
+        free(request.result.dual_solution);
+        free(request.result.reduced_costs);
+        free_problem_data(&request.problem);
+        free(request.filename);
+        
+        pthread_mutex_lock(&writer->mutex);
+        writer->stats.busy += busy;
+        if (status == 0) {
+            writer->stats.written++;
+        } else {
+            writer->stats.failed++;
+        }
+    }
+    pthread_mutex_unlock(&writer->mutex);
+    return NULL;
+}
+
+AsyncWriter* async_writer_create(const JobContext* base) {
+    AsyncWriter* writer = calloc(1, sizeof(AsyncWriter));
+    if (!writer) {
+        printf("Error: Memory allocation failed\n");
+        return NULL;
+    }
+    job_context_init_from(&writer->job, base);
+    pthread_mutex_init(&writer->mutex, NULL);
+    pthread_cond_init(&writer->slot_free, NULL);
+    pthread_cond_init(&writer->request_ready, NULL);
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0) {
+        printf("Error: Could not start the solution writer thread\n");
+        pthread_cond_destroy(&writer->request_ready);
+        pthread_cond_destroy(&writer->slot_free);
+        pthread_mutex_destroy(&writer->mutex);
+        job_context_destroy(&writer->job);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void async_writer_submit(AsyncWriter* writer, const char* filename, SolveResult* result,
+                         ProblemData* problem) {
+    // A failed copy of the name is counted as a failed write by the thread
+    WriteRequest request;
+    memset(&request, 0, sizeof(WriteRequest));
+    request.filename = strdup(filename);
+    if (!request.filename) {
+        printf("Error: Memory allocation failed\n");
+    }
+    request.result = *result;
+    request.problem.num_variables = problem->num_variables;
+    request.problem.num_constraints = problem->num_constraints;
+    request.problem.variable_names = problem->variable_names;
+    request.problem.row_names = problem->row_names;
+    result->primal_solution = NULL;
+    result->dual_solution = NULL;
+    result->reduced_costs = NULL;
+    problem->variable_names = NULL;
+    problem->row_names = NULL;
+    
+    pthread_mutex_lock(&writer->mutex);
+    double wait_start = wall_clock_seconds();
+    while (writer->queued == ASYNC_WRITER_MAX_PENDING) {
+        pthread_cond_wait(&writer->slot_free, &writer->mutex);
+    }
+    writer->stats.submit_stall += wall_clock_seconds() - wait_start;
+    writer->ring[(writer->head + writer->queued) % ASYNC_WRITER_MAX_PENDING] = request;
+    writer->queued++;
+    pthread_cond_signal(&writer->request_ready);
+    pthread_mutex_unlock(&writer->mutex);
+}
+
+int async_writer_finish(AsyncWriter* writer, AsyncWriterStats* stats) {
+    double drain_start = wall_clock_seconds();
+    pthread_mutex_lock(&writer->mutex);
+    writer->closing = 1;
+    pthread_cond_signal(&writer->request_ready);
+    pthread_mutex_unlock(&writer->mutex);
+    pthread_join(writer->thread, NULL);
+    
+    *stats = writer->stats;
+    stats->drain = wall_clock_seconds() - drain_start;
+    
+    pthread_cond_destroy(&writer->request_ready);
+    pthread_cond_destroy(&writer->slot_free);
+    pthread_mutex_destroy(&writer->mutex);
+    job_context_destroy(&writer->job);
+    free(writer);
+    return stats->failed == 0 ? 0 : -1;
+}
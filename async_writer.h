@@ -0,0 +1,49 @@
+/*
+ * async_writer.h - Background thread writing solution files
+ *
+ * Writing a large solution to disk (and compressing and syncing it) would
+ * otherwise hold up cleanup and the next problem of a batch. The writer
+ * takes ownership of a solved problem's solution buffers and names and
+ * writes them with solution_write on its own thread while the caller
+ * moves on.
+ * At most ASYNC_WRITER_MAX_PENDING solutions wait in its queue; a submit
+ * beyond that blocks until the writer catches up, so memory stays bounded
+ * when the disk is slower than the solver. async_writer_finish waits until
+ * every queued file is written and synced.
+ */
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <stddef.h>
+#include "cuopt_json_to_c_api.h"
+
+#define ASYNC_WRITER_MAX_PENDING 4
+
+typedef struct AsyncWriter AsyncWriter;
+
+typedef struct {
+    size_t written;        // files written and synced
+    size_t failed;         // files that could not be written
+    double busy;           // seconds the writer thread spent writing
+    double submit_stall;   // seconds submitters waited for a free queue slot
+    double drain;          // seconds async_writer_finish waited for the queue
+} AsyncWriterStats;
+
+// Start the writer thread. Solutions are formatted on the thread pool of
+// `base` (which must outlive the writer) and errors go to stdout. Returns
+// NULL on failure (an error has been printed).
+AsyncWriter* async_writer_create(const JobContext* base);
+
+// Queue the solution of `result`, sized like `problem`, for `filename`.
+// The writer takes ownership of the result's solution vectors, which must
+// come from malloc, and of the problem's variable and row names, and sets
+// them to NULL. Safe to call from several threads.
+void async_writer_submit(AsyncWriter* writer, const char* filename, SolveResult* result,
+                         ProblemData* problem);
+
+// Wait for every queued solution to be written, stop the thread and free
+// the writer. Returns 0 if every file was written, -1 otherwise.
+int async_writer_finish(AsyncWriter* writer, AsyncWriterStats* stats);
+
+#endif // ASYNC_WRITER_H
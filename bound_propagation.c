@@ -0,0 +1,265 @@
+/*
+ * bound_propagation.c - Activity-based bound tightening for MIPs
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bound_propagation.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Rounds after which propagation stops even if bounds still move;
+// continuous bounds can otherwise creep towards a limit forever
+#define PROPAGATION_MAX_ROUNDS 100
+
+// Slack allowed before rounding integer bounds and when bounds cross
+#define PROPAGATION_FEASIBILITY_TOLERANCE 1e-6
+
+// Continuous bounds only move by at least this fraction of max(1, |bound|)
+#define PROPAGATION_MIN_IMPROVEMENT 1e-3
+
+// Implied bounds beyond this are numerically meaningless and ignored
+#define PROPAGATION_MAX_BOUND 1e15
+
+typedef struct {
+    const ProblemData* data;
+    const cuopt_float_t* lower;      // bounds at the start of the round
+    const cuopt_float_t* upper;
+    cuopt_float_t* new_lower;        // tightened by every row of the round
+    cuopt_float_t* new_upper;
+    const unsigned char* changed;    // variables tightened in the last round, NULL at first
+    size_t count;
+    size_t chunk_size;
+} PropagationJob;
+
+static void atomic_max(cuopt_float_t* target, cuopt_float_t value) {
+    cuopt_float_t current;
+    __atomic_load(target, &current, __ATOMIC_RELAXED);
+    while (value > current &&
+           !__atomic_compare_exchange(target, &current, &value, 1, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+    }
+}
+
+static void atomic_min(cuopt_float_t* target, cuopt_float_t value) {
+    cuopt_float_t current;
+    __atomic_load(target, &current, __ATOMIC_RELAXED);
+    while (value < current &&
+           !__atomic_compare_exchange(target, &current, &value, 1, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+    }
+}
+
+// Contribution of a * x to the smallest activity of its row; infinite if
+// the bound it comes from is
+static cuopt_float_t min_contribution(cuopt_float_t a, cuopt_float_t lower, cuopt_float_t upper) {
+    cuopt_float_t bound = a > 0.0 ? lower : upper;
+    return bound_is_infinite(bound) ? -CUOPT_INFINITY : a * bound;
+}
+
+static cuopt_float_t max_contribution(cuopt_float_t a, cuopt_float_t lower, cuopt_float_t upper) {
+    cuopt_float_t bound = a > 0.0 ? upper : lower;
+    return bound_is_infinite(bound) ? CUOPT_INFINITY : a * bound;
+}
+
+// Fold the bounds implied by row `row` into new_lower/new_upper
+static void propagate_row(PropagationJob* job, size_t row) {
+    const ProblemData* data = job->data;
+    cuopt_int_t first = data->row_offsets[row], last = data->row_offsets[row + 1];
+    cuopt_float_t row_lower = data->constraint_lower_bounds[row];
+    cuopt_float_t row_upper = data->constraint_upper_bounds[row];
+    
+    // Finite part of the activity range, and how many terms are infinite
+    cuopt_float_t min_activity = 0.0, max_activity = 0.0;
+    int min_infinite = 0, max_infinite = 0;
+    for (cuopt_int_t k = first; k < last; k++) {
+        cuopt_int_t j = data->column_indices[k];
+        cuopt_float_t a = data->matrix_values[k];
+        if (a == 0.0) {
+            continue;
+        }
+        cuopt_float_t low = min_contribution(a, job->lower[j], job->upper[j]);
+        cuopt_float_t high = max_contribution(a, job->lower[j], job->upper[j]);
+        if (bound_is_infinite(low)) {
+            min_infinite++;
+        } else {
+            min_activity += low;
+        }
+        if (bound_is_infinite(high)) {
+            max_infinite++;
+        } else {
+            max_activity += high;
+        }
+    }
+    if (min_infinite > 1 && max_infinite > 1) {
+        return;
+    }
+    
+    for (cuopt_int_t k = first; k < last; k++) {
+        cuopt_int_t j = data->column_indices[k];
+        cuopt_float_t a = data->matrix_values[k];
+        if (a == 0.0) {
+            continue;
+        }
+        // Activity range of the rest of the row
+        cuopt_float_t low = min_contribution(a, job->lower[j], job->upper[j]);
+        cuopt_float_t high = max_contribution(a, job->lower[j], job->upper[j]);
+        cuopt_float_t rest_min = -CUOPT_INFINITY, rest_max = CUOPT_INFINITY;
+        if (min_infinite == 0) {
+            rest_min = min_activity - low;
+        } else if (min_infinite == 1 && bound_is_infinite(low)) {
+            rest_min = min_activity;
+        }
+        if (max_infinite == 0) {
+            rest_max = max_activity - high;
+        } else if (max_infinite == 1 && bound_is_infinite(high)) {
+            rest_max = max_activity;
+        }
+        
+        // a * x_j <= row_upper - rest_min and a * x_j >= row_lower - rest_max
+        if (!bound_is_infinite(row_upper) && !bound_is_infinite(rest_min)) {
+            cuopt_float_t bound = (row_upper - rest_min) / a;
+            if (fabs(bound) < PROPAGATION_MAX_BOUND) {
+                if (a > 0.0) {
+                    atomic_min(&job->new_upper[j], bound);
+                } else {
+                    atomic_max(&job->new_lower[j], bound);
+                }
+            }
+        }
+        if (!bound_is_infinite(row_lower) && !bound_is_infinite(rest_max)) {
+            cuopt_float_t bound = (row_lower - rest_max) / a;
+            if (fabs(bound) < PROPAGATION_MAX_BOUND) {
+                if (a > 0.0) {
+                    atomic_max(&job->new_lower[j], bound);
+                } else {
+                    atomic_min(&job->new_upper[j], bound);
+                }
+            }
+        }
+    }
+}
+
+// Propagate every row of one chunk that touches a variable tightened in
+// the last round
+static void propagate_rows(void* arg, size_t chunk) {
+    PropagationJob* job = arg;
+    const ProblemData* data = job->data;
+    size_t begin, end;
+    thread_pool_chunk_range(chunk, job->chunk_size, job->count, &begin, &end);
+    for (size_t row = begin; row < end; row++) {
+        int dirty = job->changed == NULL;
+        for (cuopt_int_t k = data->row_offsets[row]; !dirty && k < data->row_offsets[row + 1]; k++) {
+            dirty = job->changed[data->column_indices[k]];
+        }
+        if (dirty) {
+            propagate_row(job, row);
+        }
+    }
+}
+
+// Take the implied bound of variable j into [lower, upper] if it is worth
+// it. Returns 1 if the bound moved.
+static int accept_lower(const ProblemData* data, cuopt_int_t j, cuopt_float_t implied,
+                        cuopt_float_t* lower) {
+    if (data->variable_types && data->variable_types[j] == CUOPT_INTEGER) {
+        implied = ceil(implied - PROPAGATION_FEASIBILITY_TOLERANCE);
+    } else if (!bound_is_infinite(*lower)) {
+        cuopt_float_t step = PROPAGATION_MIN_IMPROVEMENT * fmax(1.0, fabs(*lower));
+        if (implied < *lower + step) {
+            return 0;
+        }
+    }
+    if (implied > *lower) {
+        *lower = implied;
+        return 1;
+    }
+    return 0;
+}
+
+static int accept_upper(const ProblemData* data, cuopt_int_t j, cuopt_float_t implied,
+                        cuopt_float_t* upper) {
+    if (data->variable_types && data->variable_types[j] == CUOPT_INTEGER) {
+        implied = floor(implied + PROPAGATION_FEASIBILITY_TOLERANCE);
+    } else if (!bound_is_infinite(*upper)) {
+        cuopt_float_t step = PROPAGATION_MIN_IMPROVEMENT * fmax(1.0, fabs(*upper));
+        if (implied > *upper - step) {
+            return 0;
+        }
+    }
+    if (implied < *upper) {
+        *upper = implied;
+        return 1;
+    }
+    return 0;
+}
+
+int bound_propagation_run(JobContext* ctx, const ProblemData* data, cuopt_float_t* lower,
+                          cuopt_float_t* upper, PropagationStats* stats) {
+    memset(stats, 0, sizeof(PropagationStats));
+    if (!data->constraint_lower_bounds || !data->constraint_upper_bounds) {
+        return 0;
+    }
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    ThreadPool* pool = job_thread_pool(ctx);
+    
+    cuopt_float_t* original = malloc((n ? n : 1) * 2 * sizeof(cuopt_float_t));
+    cuopt_float_t* new_lower = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    cuopt_float_t* new_upper = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    unsigned char* changed = calloc(n ? n : 1, 1);
+    if (!original || !new_lower || !new_upper || !changed) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        free(original);
+        free(new_lower);
+        free(new_upper);
+        free(changed);
+        return -1;
+    }
+    memcpy(original, lower, n * sizeof(cuopt_float_t));
+    memcpy(original + n, upper, n * sizeof(cuopt_float_t));
+    
+    PropagationJob job = { data, lower, upper, new_lower, new_upper, NULL, m,
+                           thread_pool_chunk_size(pool, m) };
+    int status = 0;
+    while (status == 0 && stats->rounds < PROPAGATION_MAX_ROUNDS) {
+        stats->rounds++;
+        memcpy(new_lower, lower, n * sizeof(cuopt_float_t));
+        memcpy(new_upper, upper, n * sizeof(cuopt_float_t));
+        thread_pool_parallel_for(pool, thread_pool_chunk_count(m, job.chunk_size), propagate_rows,
+                                 &job);
+    
+        // Rows only read the bounds of the last round, so they are updated
+        // here once the whole round is done
+        int moved = 0;
+        for (size_t j = 0; j < n; j++) {
+            changed[j] = (unsigned char)(accept_lower(data, (cuopt_int_t)j, new_lower[j], &lower[j]) |
+                                         accept_upper(data, (cuopt_int_t)j, new_upper[j], &upper[j]));
+            moved |= changed[j];
+            if (lower[j] > upper[j]) {
+                cuopt_float_t gap = lower[j] - upper[j];
+                if (gap > PROPAGATION_FEASIBILITY_TOLERANCE * (1.0 + fabs(upper[j]))) {
+                    status = 1;
+                    break;
+                }
+                // Crossed by round-off only: meet in the middle
+                lower[j] = upper[j] = upper[j] + gap / 2;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+        job.changed = changed;
+    }
+    
+    for (size_t j = 0; j < n; j++) {
+        stats->tightened_lower += lower[j] > original[j];
+        stats->tightened_upper += upper[j] < original[n + j];
+    }
+    free(original);
+    free(new_lower);
+    free(new_upper);
+    free(changed);
+    return status;
+}
@@ -0,0 +1,38 @@
+/*
+ * bound_propagation.h - Activity-based bound tightening for MIPs
+ *
+ * Every row l <= sum_k a_k x_k <= u bounds each of its variables through
+ * the activity of the others: with the smallest and largest value the rest
+ * of the row can take, a_j x_j has to make up the difference to u and l.
+ * Integer variables have their implied bounds rounded inward, which is
+ * where branch-and-bound gains the most.
+ *
+ * Rounds are Jacobi style: all rows are evaluated in parallel against the
+ * bounds of the previous round, each folding its implied bounds into the
+ * new ones with an atomic min/max, so the result does not depend on the
+ * thread count. Only rows touching a variable tightened in the previous
+ * round are evaluated again, until a round changes nothing or the round
+ * limit is reached.
+ */
+
+#ifndef BOUND_PROPAGATION_H
+#define BOUND_PROPAGATION_H
+
+#include "cuopt_json_to_c_api.h"
+
+typedef struct {
+    cuopt_int_t tightened_lower;   // variables whose lower bound moved
+    cuopt_int_t tightened_upper;
+    int rounds;
+} PropagationStats;
+
+// Tighten `lower` and `upper` (num_variables entries each, holding the
+// variable bounds on entry) using the rows of `data`. Returns 0 on
+// success, 1 if the bounds cross (the problem is infeasible; the arrays
+// are then unspecified) and -1 on failure (an error has been printed).
+// Rows index `lower` and `upper` by their column indices unchecked, so
+// `data` must have passed load_problem's CSR check.
+int bound_propagation_run(JobContext* ctx, const ProblemData* data, cuopt_float_t* lower,
+                          cuopt_float_t* upper, PropagationStats* stats);
+
+#endif // BOUND_PROPAGATION_H
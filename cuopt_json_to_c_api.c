@@ -17,48 +17,40 @@
 #include <math.h>
 #include <cJSON.h>
 #include <time.h>
+#include "cuopt_json_to_c_api.h"
+#include "async_writer.h"
+#include "bound_propagation.h"
+#include "input_file.h"
+#include "input_list.h"
+#include "job_scheduler.h"
+#include "json_number.h"
+#include "name_table.h"
+#include "parse_cache.h"
+#include "pipeline.h"
+#include "problem_binary.h"
+#include "problem_builder.h"
+#include "problem_decompose.h"
+#include "problem_pack.h"
+#include "problem_scaling.h"
+#include "presolve.h"
+#include "shm_handoff.h"
+#include "solution_writer.h"
+#include "solver_service.h"
+#include "thread_pool.h"
+#include "trace.h"
 
-// Global flags to control features (disabled by default)
-static int timing_enabled = 0;
-static char* mps_output_file = NULL;
-
-// Timing utility functions
-typedef struct {
-    struct timespec start_time;
-    struct timespec end_time;
-} Timer;
-
-void start_timer(Timer* timer) {
-    if (timing_enabled) {
-        clock_gettime(CLOCK_MONOTONIC, &timer->start_time);
-    }
-}
-
-double end_timer(Timer* timer) {
-    if (!timing_enabled) {
-        return 0.0;
-    }
-    clock_gettime(CLOCK_MONOTONIC, &timer->end_time);
-    double elapsed = (timer->end_time.tv_sec - timer->start_time.tv_sec) + 
-                    (timer->end_time.tv_nsec - timer->start_time.tv_nsec) / 1e9;
-    return elapsed;
-}
-
-void log_timestamp(const char* phase) {
-    if (!timing_enabled) {
-        return;
-    }
-    struct timespec current_time;
-    clock_gettime(CLOCK_MONOTONIC, &current_time);
-    printf("[TIMESTAMP] %s: %ld.%09ld\n", phase, current_time.tv_sec, current_time.tv_nsec);
-}
-
-void log_phase_duration(const char* phase, double duration) {
-    if (!timing_enabled) {
-        return;
-    }
-    printf("[DURATION] %s: %.6f seconds\n", phase, duration);
-}
+// Command-line settings (per-job options live in JobContext)
+static int num_threads = 1;
+static char* convert_output_file = NULL;
+static char* parse_cache_dir = NULL;
+static uint64_t parse_cache_max_bytes = 4096ULL << 20;
+static int prefetch_depth = 0;   // 0 = batch inputs are loaded and solved in turn
+static int parse_workers = 1;
+static int solve_jobs = 1;       // batch problems loaded and solved concurrently
+static int pack_problems = 0;    // solve batch LPs together as block-diagonal packs
+static int64_t pack_max_nnz = 1000000;
+static int64_t pack_max_variables = 100000;
+static int serve_queue_depth = 8;
 
 // Helper function to convert termination status to string
 const char* termination_status_to_string(cuopt_int_t termination_status)
@@ -90,49 +82,23 @@ cuopt_float_t parse_numeric_value(cJSON* item) {
     if (cJSON_IsNumber(item)) {
         return item->valuedouble;
     } else if (cJSON_IsString(item)) {
-        char* str = item->valuestring;
-        if (strcmp(str, "inf") == 0 || strcmp(str, "infinity") == 0) {
-            return CUOPT_INFINITY;
-        } else if (strcmp(str, "-inf") == 0 || strcmp(str, "-infinity") == 0 || strcmp(str, "ninf") == 0) {
-            return -CUOPT_INFINITY;
-        } else {
-            return strtod(str, NULL);
-        }
+        // Handles "inf"/"-inf" spellings as well as string-encoded numbers
+        return parse_numeric_string(item->valuestring, strlen(item->valuestring));
     }
     return 0.0;
 }
 
-// Structure to hold parsed JSON data
-typedef struct {
-    // CSR matrix data
-    cuopt_int_t* row_offsets;
-    cuopt_int_t* column_indices;
-    cuopt_float_t* matrix_values;
-    cuopt_int_t num_constraints;
-    cuopt_int_t num_variables;
-    cuopt_int_t nnz;
-    
-    // Objective data
-    cuopt_float_t* objective_coefficients;
-    cuopt_float_t objective_offset;
-    cuopt_int_t objective_sense;  // CUOPT_MINIMIZE or CUOPT_MAXIMIZE
-    
-    // Constraint bounds
-    cuopt_float_t* constraint_lower_bounds;
-    cuopt_float_t* constraint_upper_bounds;
-    
-    // Variable bounds
-    cuopt_float_t* variable_lower_bounds;
-    cuopt_float_t* variable_upper_bounds;
-    
-    // Variable types
-    char* variable_types;
-    
-} ProblemData;
-
 // Function to free allocated memory
 void free_problem_data(ProblemData* data) {
     if (data) {
+        // Names are never part of a mapping
+        name_table_free(data->variable_names);
+        name_table_free(data->row_names);
+    }
+    if (data && data->mapping) {
+        problem_binary_unmap(data->mapping, data->mapping_size);
+        memset(data, 0, sizeof(ProblemData));
+    } else if (data) {
         free(data->row_offsets);
         free(data->column_indices);
         free(data->matrix_values);
@@ -146,92 +112,105 @@ void free_problem_data(ProblemData* data) {
     }
 }
 
-// Function to parse cuOpt JSON file
-int parse_cuopt_json(const char* filename, ProblemData* data) {
-    Timer timer;
-    log_timestamp("JSON_PARSE_START");
-    start_timer(&timer);
-    
-    log_timestamp("FILE_READ_START");
-    Timer file_timer;
-    start_timer(&file_timer);
-    
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        printf("Error: Cannot open file %s\n", filename);
+cuopt_float_t problem_variable_lower_bound(const ProblemData* data, cuopt_int_t j) {
+    return data->variable_lower_bounds ? data->variable_lower_bounds[j]
+                                       : DEFAULT_VARIABLE_LOWER_BOUND;
+}
+
+cuopt_float_t problem_variable_upper_bound(const ProblemData* data, cuopt_int_t j) {
+    return data->variable_upper_bounds ? data->variable_upper_bounds[j]
+                                       : DEFAULT_VARIABLE_UPPER_BOUND;
+}
+
+int bound_is_infinite(cuopt_float_t value) {
+    return value >= CUOPT_INFINITY || value <= -CUOPT_INFINITY;
+}
+
+// Function to collect the strings of the array `key`, if present, which
+// must have `count` entries, into a name table
+static int parse_name_array(JobContext* ctx, const cJSON* json, const char* key, cuopt_int_t count,
+                            NameTable** names) {
+    const cJSON* array = cJSON_GetObjectItem(json, key);
+    if (!array) {
+        return 0;
+    }
+    if (!cJSON_IsArray(array) || cJSON_GetArraySize(array) != count) {
+        job_printf(ctx, "Error: %s must be an array of %d strings\n", key, count);
         return -1;
     }
-    
-    // Read file content
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char* file_content = malloc(file_size + 1);
-    if (!file_content) {
-        printf("Error: Memory allocation failed\n");
-        fclose(file);
+    *names = name_table_create(ctx);
+    if (!*names) {
         return -1;
     }
-    
-    size_t bytes_read = fread(file_content, 1, file_size, file);
-    file_content[bytes_read] = '\0';
-    fclose(file);
-    
-    double file_read_time = end_timer(&file_timer);
-    log_timestamp("FILE_READ_END");
-    log_phase_duration("FILE_READ", file_read_time);
-    
-    if (bytes_read != (size_t)file_size) {
-        printf("Warning: Only read %zu bytes out of %ld expected\n", bytes_read, file_size);
+    const cJSON* item;
+    cJSON_ArrayForEach(item, array) {
+        if (!cJSON_IsString(item)) {
+            job_printf(ctx, "Error: Expected strings in %s\n", key);
+            return -1;
+        }
+        if (name_table_append(ctx, *names, item->valuestring, strlen(item->valuestring)) != 0) {
+            return -1;
+        }
     }
-    
-    // Parse JSON
-    log_timestamp("JSON_PARSE_STRUCTURE_START");
-    Timer json_parse_timer;
-    start_timer(&json_parse_timer);
-    
-    cJSON* json = cJSON_Parse(file_content);
-    free(file_content);
-    
-    double json_parse_time = end_timer(&json_parse_timer);
-    log_timestamp("JSON_PARSE_STRUCTURE_END");
-    log_phase_duration("JSON_PARSE_STRUCTURE", json_parse_time);
-    
-    if (!json) {
-        printf("Error: Failed to parse JSON\n");
+    name_table_finish(*names);
+    return 0;
+}
+
+// Function to check that `array`, called `name` in messages, is an array of
+// `expected` entries before it is copied, as the streaming parser does
+static int check_dom_array(JobContext* ctx, const cJSON* array, const char* name,
+                           cuopt_int_t expected) {
+    if (!cJSON_IsArray(array)) {
+        job_printf(ctx, "Error: %s must be an array\n", name);
+        return -1;
+    }
+    int size = cJSON_GetArraySize(array);
+    if (size != expected) {
+        job_printf(ctx, "Error: %s has %d entries, expected %d\n", name, size, expected);
         return -1;
     }
+    return 0;
+}
+
+// Function to extract problem data from a parsed cJSON document (takes ownership of json)
+static int parse_cuopt_json_dom(JobContext* ctx, cJSON* json, ProblemData* data) {
+    memset(data, 0, sizeof(ProblemData));
     
     // Parse CSR constraint matrix
-    log_timestamp("CSR_MATRIX_PARSE_START");
+    log_timestamp(ctx, "CSR_MATRIX_PARSE_START");
     Timer csr_timer;
-    start_timer(&csr_timer);
+    start_timer(ctx, &csr_timer);
     
     cJSON* csr_matrix = cJSON_GetObjectItem(json, "csr_constraint_matrix");
     if (!csr_matrix) {
-        printf("Error: Missing csr_constraint_matrix in JSON\n");
-        cJSON_Delete(json);
-        return -1;
+        job_printf(ctx, "Error: Missing csr_constraint_matrix in JSON\n");
+        goto ERROR;
     }
     
     cJSON* offsets = cJSON_GetObjectItem(csr_matrix, "offsets");
     cJSON* indices = cJSON_GetObjectItem(csr_matrix, "indices");
     cJSON* values = cJSON_GetObjectItem(csr_matrix, "values");
     
-    if (!offsets || !indices || !values) {
-        printf("Error: Invalid CSR matrix format\n");
-        cJSON_Delete(json);
-        return -1;
+    if (!cJSON_IsArray(offsets) || !cJSON_IsArray(indices) || !cJSON_IsArray(values) ||
+        cJSON_GetArraySize(offsets) == 0) {
+        job_printf(ctx, "Error: Invalid CSR matrix format\n");
+        goto ERROR;
     }
     
     data->num_constraints = cJSON_GetArraySize(offsets) - 1;
     data->nnz = cJSON_GetArraySize(indices);
+    if (check_dom_array(ctx, values, "csr_constraint_matrix.values", data->nnz) != 0) {
+        goto ERROR;
+    }
     
     // Allocate memory for CSR data
     data->row_offsets = malloc((data->num_constraints + 1) * sizeof(cuopt_int_t));
-    data->column_indices = malloc(data->nnz * sizeof(cuopt_int_t));
-    data->matrix_values = malloc(data->nnz * sizeof(cuopt_float_t));
+    data->column_indices = malloc((data->nnz ? data->nnz : 1) * sizeof(cuopt_int_t));
+    data->matrix_values = malloc((data->nnz ? data->nnz : 1) * sizeof(cuopt_float_t));
+    if (!data->row_offsets || !data->column_indices || !data->matrix_values) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        goto ERROR;
+    }
     
     // Parse CSR data - OPTIMIZED VERSION
     // Use cJSON_ArrayForEach for O(n) complexity instead of O(n²)
@@ -256,26 +235,34 @@ int parse_cuopt_json(const char* filename, ProblemData* data) {
         i++;
     }
     
-    double csr_time = end_timer(&csr_timer);
-    log_timestamp("CSR_MATRIX_PARSE_END");
-    log_phase_duration("CSR_MATRIX_PARSE", csr_time);
+    double csr_time = end_timer(ctx, &csr_timer);
+    log_timestamp(ctx, "CSR_MATRIX_PARSE_END");
+    log_phase_duration(ctx, "CSR_MATRIX_PARSE", csr_time);
     
     // Parse objective data
-    log_timestamp("OBJECTIVE_PARSE_START");
+    log_timestamp(ctx, "OBJECTIVE_PARSE_START");
     Timer objective_timer;
-    start_timer(&objective_timer);
+    start_timer(ctx, &objective_timer);
     
     cJSON* objective_data = cJSON_GetObjectItem(json, "objective_data");
     if (!objective_data) {
-        printf("Error: Missing objective_data in JSON\n");
-        cJSON_Delete(json);
-        return -1;
+        job_printf(ctx, "Error: Missing objective_data in JSON\n");
+        goto ERROR;
     }
     
     cJSON* obj_coeffs = cJSON_GetObjectItem(objective_data, "coefficients");
+    if (!cJSON_IsArray(obj_coeffs)) {
+        job_printf(ctx, "Error: objective_data.coefficients must be an array\n");
+        goto ERROR;
+    }
     data->num_variables = cJSON_GetArraySize(obj_coeffs);
     
-    data->objective_coefficients = malloc(data->num_variables * sizeof(cuopt_float_t));
+    data->objective_coefficients = malloc((data->num_variables ? data->num_variables : 1) *
+                                          sizeof(cuopt_float_t));
+    if (!data->objective_coefficients) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        goto ERROR;
+    }
     // OPTIMIZED: Use cJSON_ArrayForEach for O(n) complexity
     i = 0;
     cJSON* coeff_item;
@@ -286,29 +273,61 @@ int parse_cuopt_json(const char* filename, ProblemData* data) {
     
     cJSON* offset = cJSON_GetObjectItem(objective_data, "offset");
     data->objective_offset = offset ? offset->valuedouble : 0.0;
+    cJSON* scalability_factor = cJSON_GetObjectItem(objective_data, "scalability_factor");
+    data->objective_scaling_factor = scalability_factor ? scalability_factor->valuedouble : 1.0;
+    if (!(data->objective_scaling_factor > 0.0 && data->objective_scaling_factor < CUOPT_INFINITY)) {
+        job_printf(ctx, "Error: objective_data.scalability_factor must be positive and finite\n");
+        goto ERROR;
+    }
     // Print the objective offset value
-    printf("Objective offset: %g\n", data->objective_offset);   
-
+    job_printf(ctx, "Objective offset: %g\n", data->objective_offset);   
+    
     // Parse maximize flag
     cJSON* maximize = cJSON_GetObjectItem(json, "maximize");
     data->objective_sense = (maximize && cJSON_IsTrue(maximize)) ? CUOPT_MAXIMIZE : CUOPT_MINIMIZE;
     
-    double objective_time = end_timer(&objective_timer);
-    log_timestamp("OBJECTIVE_PARSE_END");
-    log_phase_duration("OBJECTIVE_PARSE", objective_time);
+    double objective_time = end_timer(ctx, &objective_timer);
+    log_timestamp(ctx, "OBJECTIVE_PARSE_END");
+    log_phase_duration(ctx, "OBJECTIVE_PARSE", objective_time);
     
     // Parse constraint bounds
-    log_timestamp("CONSTRAINT_BOUNDS_PARSE_START");
+    log_timestamp(ctx, "CONSTRAINT_BOUNDS_PARSE_START");
     Timer constraint_timer;
-    start_timer(&constraint_timer);
+    start_timer(ctx, &constraint_timer);
     
     cJSON* constraint_bounds = cJSON_GetObjectItem(json, "constraint_bounds");
     if (constraint_bounds) {
-        data->constraint_lower_bounds = malloc(data->num_constraints * sizeof(cuopt_float_t));
-        data->constraint_upper_bounds = malloc(data->num_constraints * sizeof(cuopt_float_t));
-        
         cJSON* lower_bounds = cJSON_GetObjectItem(constraint_bounds, "lower_bounds");
         cJSON* upper_bounds = cJSON_GetObjectItem(constraint_bounds, "upper_bounds");
+        cJSON* bounds = cJSON_GetObjectItem(constraint_bounds, "bounds");
+        cJSON* types = cJSON_GetObjectItem(constraint_bounds, "types");
+        
+        if (lower_bounds && upper_bounds) {
+            if (check_dom_array(ctx, lower_bounds, "constraint_bounds.lower_bounds",
+                                data->num_constraints) != 0 ||
+                check_dom_array(ctx, upper_bounds, "constraint_bounds.upper_bounds",
+                                data->num_constraints) != 0) {
+                goto ERROR;
+            }
+        } else if (bounds && types) {
+            if (check_dom_array(ctx, bounds, "constraint_bounds.bounds",
+                                data->num_constraints) != 0 ||
+                check_dom_array(ctx, types, "constraint_bounds.types",
+                                data->num_constraints) != 0) {
+                goto ERROR;
+            }
+        } else {
+            job_printf(ctx, "Error: constraint_bounds needs lower_bounds/upper_bounds or bounds/types\n");
+            goto ERROR;
+        }
+        
+        size_t m = data->num_constraints ? (size_t)data->num_constraints : 1;
+        data->constraint_lower_bounds = malloc(m * sizeof(cuopt_float_t));
+        data->constraint_upper_bounds = malloc(m * sizeof(cuopt_float_t));
+        if (!data->constraint_lower_bounds || !data->constraint_upper_bounds) {
+            job_printf(ctx, "Error: Memory allocation failed\n");
+            goto ERROR;
+        }
         
         if (lower_bounds && upper_bounds) {
             // OPTIMIZED: Use cJSON_ArrayForEach for O(n) complexity
@@ -327,53 +346,69 @@ int parse_cuopt_json(const char* filename, ProblemData* data) {
             }
         } else {
             // Fallback to bounds and types format
-            cJSON* bounds = cJSON_GetObjectItem(constraint_bounds, "bounds");
-            cJSON* types = cJSON_GetObjectItem(constraint_bounds, "types");
-            
-            if (bounds && types) {
-                // OPTIMIZED: Use parallel iteration with cJSON_ArrayForEach
-                i = 0;
-                cJSON* bound_item = bounds->child;
-                cJSON* type_item = types->child;
-                while (bound_item && type_item && i < data->num_constraints) {
-                    cuopt_float_t bound_value = parse_numeric_value(bound_item);
-                    char* type = type_item->valuestring;
-                    
-                    if (strcmp(type, "L") == 0) {  // Less than or equal
-                        data->constraint_lower_bounds[i] = -CUOPT_INFINITY;
-                        data->constraint_upper_bounds[i] = bound_value;
-                    } else if (strcmp(type, "G") == 0) {  // Greater than or equal
-                        data->constraint_lower_bounds[i] = bound_value;
-                        data->constraint_upper_bounds[i] = CUOPT_INFINITY;
-                    } else if (strcmp(type, "E") == 0) {  // Equal
-                        data->constraint_lower_bounds[i] = bound_value;
-                        data->constraint_upper_bounds[i] = bound_value;
-                    }
-                    
-                    bound_item = bound_item->next;
-                    type_item = type_item->next;
-                    i++;
+            // OPTIMIZED: Use parallel iteration with cJSON_ArrayForEach
+            i = 0;
+            cJSON* bound_item = bounds->child;
+            cJSON* type_item = types->child;
+            while (bound_item && type_item && i < data->num_constraints) {
+                cuopt_float_t bound_value = parse_numeric_value(bound_item);
+                const char* type = cJSON_IsString(type_item) ? type_item->valuestring : "";
+                
+                if (strcmp(type, "L") == 0) {  // Less than or equal
+                    data->constraint_lower_bounds[i] = -CUOPT_INFINITY;
+                    data->constraint_upper_bounds[i] = bound_value;
+                } else if (strcmp(type, "G") == 0) {  // Greater than or equal
+                    data->constraint_lower_bounds[i] = bound_value;
+                    data->constraint_upper_bounds[i] = CUOPT_INFINITY;
+                } else if (strcmp(type, "E") == 0) {  // Equal
+                    data->constraint_lower_bounds[i] = bound_value;
+                    data->constraint_upper_bounds[i] = bound_value;
+                } else {
+                    job_printf(ctx, "Error: Unknown constraint type in constraint_bounds.types "
+                               "(expected \"L\", \"G\" or \"E\")\n");
+                    goto ERROR;
                 }
+                
+                bound_item = bound_item->next;
+                type_item = type_item->next;
+                i++;
             }
         }
     }
     
-    double constraint_time = end_timer(&constraint_timer);
-    log_timestamp("CONSTRAINT_BOUNDS_PARSE_END");
-    log_phase_duration("CONSTRAINT_BOUNDS_PARSE", constraint_time);
+    double constraint_time = end_timer(ctx, &constraint_timer);
+    log_timestamp(ctx, "CONSTRAINT_BOUNDS_PARSE_END");
+    log_phase_duration(ctx, "CONSTRAINT_BOUNDS_PARSE", constraint_time);
     
     // Parse variable bounds
-    log_timestamp("VARIABLE_BOUNDS_PARSE_START");
+    log_timestamp(ctx, "VARIABLE_BOUNDS_PARSE_START");
     Timer variable_bounds_timer;
-    start_timer(&variable_bounds_timer);
+    start_timer(ctx, &variable_bounds_timer);
     
+    size_t n = data->num_variables ? (size_t)data->num_variables : 1;
     cJSON* variable_bounds = cJSON_GetObjectItem(json, "variable_bounds");
     if (variable_bounds) {
-        data->variable_lower_bounds = malloc(data->num_variables * sizeof(cuopt_float_t));
-        data->variable_upper_bounds = malloc(data->num_variables * sizeof(cuopt_float_t));
-        
         cJSON* var_lower = cJSON_GetObjectItem(variable_bounds, "lower_bounds");
         cJSON* var_upper = cJSON_GetObjectItem(variable_bounds, "upper_bounds");
+        if ((var_lower && check_dom_array(ctx, var_lower, "variable_bounds.lower_bounds",
+                                          data->num_variables) != 0) ||
+            (var_upper && check_dom_array(ctx, var_upper, "variable_bounds.upper_bounds",
+                                          data->num_variables) != 0)) {
+            goto ERROR;
+        }
+        
+        data->variable_lower_bounds = malloc(n * sizeof(cuopt_float_t));
+        data->variable_upper_bounds = malloc(n * sizeof(cuopt_float_t));
+        if (!data->variable_lower_bounds || !data->variable_upper_bounds) {
+            job_printf(ctx, "Error: Memory allocation failed\n");
+            goto ERROR;
+        }
+        
+        // A missing side gets its default
+        for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+            data->variable_lower_bounds[j] = DEFAULT_VARIABLE_LOWER_BOUND;
+            data->variable_upper_bounds[j] = DEFAULT_VARIABLE_UPPER_BOUND;
+        }
         
         // OPTIMIZED: Use cJSON_ArrayForEach for O(n) complexity
         i = 0;
@@ -391,24 +426,35 @@ int parse_cuopt_json(const char* filename, ProblemData* data) {
         }
     }
     
-    double variable_bounds_time = end_timer(&variable_bounds_timer);
-    log_timestamp("VARIABLE_BOUNDS_PARSE_END");
-    log_phase_duration("VARIABLE_BOUNDS_PARSE", variable_bounds_time);
+    double variable_bounds_time = end_timer(ctx, &variable_bounds_timer);
+    log_timestamp(ctx, "VARIABLE_BOUNDS_PARSE_END");
+    log_phase_duration(ctx, "VARIABLE_BOUNDS_PARSE", variable_bounds_time);
     
     // Parse variable types
-    log_timestamp("VARIABLE_TYPES_PARSE_START");
+    log_timestamp(ctx, "VARIABLE_TYPES_PARSE_START");
     Timer variable_types_timer;
-    start_timer(&variable_types_timer);
+    start_timer(ctx, &variable_types_timer);
     
     cJSON* variable_types = cJSON_GetObjectItem(json, "variable_types");
+    if (variable_types &&
+        check_dom_array(ctx, variable_types, "variable_types", data->num_variables) != 0) {
+        goto ERROR;
+    }
+    data->variable_types = malloc(n * sizeof(char));
+    if (!data->variable_types) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        goto ERROR;
+    }
     if (variable_types) {
-        data->variable_types = malloc(data->num_variables * sizeof(char));
         // OPTIMIZED: Use cJSON_ArrayForEach for O(n) complexity
         i = 0;
         cJSON* type_item;
         cJSON_ArrayForEach(type_item, variable_types) {
-            char* type_str = type_item->valuestring;
-            if (strcmp(type_str, "I") == 0) {
+            if (!cJSON_IsString(type_item)) {
+                job_printf(ctx, "Error: Expected strings in variable_types\n");
+                goto ERROR;
+            }
+            if (strcmp(type_item->valuestring, "I") == 0) {
                 data->variable_types[i] = CUOPT_INTEGER;
             } else {
                 data->variable_types[i] = CUOPT_CONTINUOUS;
@@ -417,125 +463,510 @@ int parse_cuopt_json(const char* filename, ProblemData* data) {
         }
     } else {
         // Default to continuous variables
-        data->variable_types = malloc(data->num_variables * sizeof(char));
         for (int i = 0; i < data->num_variables; i++) {
             data->variable_types[i] = CUOPT_CONTINUOUS;
         }
     }
     
-    double variable_types_time = end_timer(&variable_types_timer);
-    log_timestamp("VARIABLE_TYPES_PARSE_END");
-    log_phase_duration("VARIABLE_TYPES_PARSE", variable_types_time);
+    double variable_types_time = end_timer(ctx, &variable_types_timer);
+    log_timestamp(ctx, "VARIABLE_TYPES_PARSE_END");
+    log_phase_duration(ctx, "VARIABLE_TYPES_PARSE", variable_types_time);
     
-    cJSON_Delete(json);
+    // Parse variable and constraint names
+    if (parse_name_array(ctx, json, "variable_names", data->num_variables,
+                         &data->variable_names) != 0 ||
+        parse_name_array(ctx, json, "row_names", data->num_constraints, &data->row_names) != 0) {
+        goto ERROR;
+    }
     
-    double total_parse_time = end_timer(&timer);
-    log_timestamp("JSON_PARSE_END");
-    log_phase_duration("JSON_PARSE_TOTAL", total_parse_time);
+    cJSON_Delete(json);
     
     return 0;
+
+ERROR:
+    cJSON_Delete(json);
+    free_problem_data(data);
+    return -1;
 }
 
-// Function to solve the problem using cuOpt C API
-int solve_problem(const ProblemData* data) {
+// Function to parse cuOpt JSON text that is already in memory with the
+// front end selected by --parser
+int parse_cuopt_json_buffer(JobContext* ctx, const char* json_text, size_t length, ProblemData* data) {
+    if (ctx->parser == JSON_PARSER_INDEX) {
+        return parse_cuopt_json_indexed(ctx, json_text, length, data);
+    } else if (ctx->parser == JSON_PARSER_STREAM) {
+        return parse_cuopt_json_stream(ctx, json_text, length, data);
+    }
+    
+    // Parse JSON
+    log_timestamp(ctx, "JSON_PARSE_STRUCTURE_START");
+    Timer json_parse_timer;
+    start_timer(ctx, &json_parse_timer);
+    
+    cJSON* json = cJSON_ParseWithLength(json_text, length);
+    
+    double json_parse_time = end_timer(ctx, &json_parse_timer);
+    log_timestamp(ctx, "JSON_PARSE_STRUCTURE_END");
+    log_phase_duration(ctx, "JSON_PARSE_STRUCTURE", json_parse_time);
+    log_phase_throughput(ctx, "JSON_PARSE_STRUCTURE", length, json_parse_time);
+    
+    if (!json) {
+        job_printf(ctx, "Error: Failed to parse JSON\n");
+        return -1;
+    }
+    
+    return parse_cuopt_json_dom(ctx, json, data);
+}
+
+// Function to parse cuOpt JSON file
+int parse_cuopt_json(JobContext* ctx, const char* filename, ProblemData* data) {
     Timer timer;
-    log_timestamp("SOLVE_START");
-    start_timer(&timer);
+    log_timestamp(ctx, "JSON_PARSE_START");
+    start_timer(ctx, &timer);
     
-    cuOptOptimizationProblem problem = NULL;
-    cuOptSolverSettings settings = NULL;
-    cuOptSolution solution = NULL;
-    cuopt_int_t status;
+    log_timestamp(ctx, "FILE_READ_START");
+    Timer file_timer;
+    start_timer(ctx, &file_timer);
     
-    printf("Creating and solving problem...\n");
-    printf("Problem size: %d constraints, %d variables, %d nonzeros\n", 
-           data->num_constraints, data->num_variables, data->nnz);
+    // Regular files are mapped and parsed in place; pipes are read into memory
+    InputFile input;
+    if (input_file_open(ctx, filename, &input) != 0) {
+        return -1;
+    }
     
-    // Create the problem using ranged formulation
-    log_timestamp("PROBLEM_CREATION_START");
-    Timer problem_timer;
-    start_timer(&problem_timer);
-    
-    status = cuOptCreateRangedProblem(data->num_constraints,
-                                     data->num_variables,
-                                     data->objective_sense,
-                                     data->objective_offset,
-                                     data->objective_coefficients,
-                                     data->row_offsets,
-                                     data->column_indices,
-                                     data->matrix_values,
-                                     data->constraint_lower_bounds,
-                                     data->constraint_upper_bounds,
-				     data->variable_lower_bounds,
-				     data->variable_upper_bounds,
-                                     data->variable_types,
-                                     &problem);
+    double file_read_time = end_timer(ctx, &file_timer);
+    log_timestamp(ctx, "FILE_READ_END");
+    log_phase_duration(ctx, "FILE_READ", file_read_time);
     
-    double problem_time = end_timer(&problem_timer);
-    log_timestamp("PROBLEM_CREATION_END");
-    log_phase_duration("PROBLEM_CREATION", problem_time);
+    int result = parse_cuopt_json_buffer(ctx, input.data, input.size, data);
+    input_file_close(&input);
+    if (result != 0) {
+        return -1;
+    }
     
-    if (status != CUOPT_SUCCESS) {
-        printf("Error creating problem: %d\n", status);
-        goto CLEANUP;
+    double total_parse_time = end_timer(ctx, &timer);
+    log_timestamp(ctx, "JSON_PARSE_END");
+    log_phase_duration(ctx, "JSON_PARSE_TOTAL", total_parse_time);
+    
+    return 0;
+}
+
+// Function to read a problem: binary problem files are mapped, JSON files
+// are served from the parse cache when possible and parsed otherwise
+static int read_problem(JobContext* ctx, const char* filename, ProblemData* data) {
+    if (problem_binary_probe(filename)) {
+        job_printf(ctx, "Reading binary problem file: %s\n", filename);
+        if (problem_binary_load(ctx, filename, data) != 0) {
+            job_printf(ctx, "Failed to load binary problem file\n");
+            return -1;
+        }
+        job_printf(ctx, "Successfully loaded binary problem file\n");
+        return 0;
+    }
+    
+    job_printf(ctx, "Reading JSON file: %s\n", filename);
+    
+    ParseCacheKey cache_key;
+    int cacheable = 0;
+    if (parse_cache_dir) {
+        log_timestamp(ctx, "PARSE_CACHE_LOOKUP_START");
+        Timer lookup_timer;
+        start_timer(ctx, &lookup_timer);
+        
+        cacheable = parse_cache_key(ctx, parse_cache_dir, filename, &cache_key) == 0;
+        int hit = cacheable && parse_cache_load(ctx, parse_cache_dir, &cache_key, data) == 0;
+        
+        double lookup_time = end_timer(ctx, &lookup_timer);
+        log_timestamp(ctx, "PARSE_CACHE_LOOKUP_END");
+        log_phase_duration(ctx, "PARSE_CACHE_LOOKUP", lookup_time);
+        
+        if (hit) {
+            job_printf(ctx, "Loaded from parse cache: %s/%s\n", parse_cache_dir, cache_key.name);
+            return 0;
+        }
+    }
+    
+    if (parse_cuopt_json(ctx, filename, data) != 0) {
+        job_printf(ctx, "Failed to parse JSON file\n");
+        free_problem_data(data);
+        return -1;
+    }
+    job_printf(ctx, "Successfully parsed JSON file\n");
+    if (data->variable_names || data->row_names) {
+        job_printf(ctx, "Names: %d variable and %d row names in %zu bytes\n",
+                   data->variable_names ? data->variable_names->count : 0,
+                   data->row_names ? data->row_names->count : 0,
+                   (data->variable_names ? name_table_bytes(data->variable_names) : 0) +
+                   (data->row_names ? name_table_bytes(data->row_names) : 0));
     }
     
-    // Create solver settings
-    log_timestamp("SOLVER_SETTINGS_START");
+    // Binary problem files do not carry names, so a cache hit would lose them
+    if (cacheable && !data->variable_names && !data->row_names) {
+        log_timestamp(ctx, "PARSE_CACHE_STORE_START");
+        Timer store_timer;
+        start_timer(ctx, &store_timer);
+        
+        parse_cache_store(ctx, parse_cache_dir, &cache_key, data, parse_cache_max_bytes);
+        
+        double store_time = end_timer(ctx, &store_timer);
+        log_timestamp(ctx, "PARSE_CACHE_STORE_END");
+        log_phase_duration(ctx, "PARSE_CACHE_STORE", store_time);
+    }
+    return 0;
+}
+
+// Function to check the CSR structure of a problem before anything indexes
+// by it: presolve, decomposition, scaling and propagation all trust the
+// row offsets and column indices
+static int check_problem_structure(JobContext* ctx, const ProblemData* data) {
+    cuopt_int_t m = data->num_constraints, n = data->num_variables, nnz = data->nnz;
+    if (m < 0 || n < 0 || nnz < 0) {
+        job_printf(ctx, "Error: Negative problem dimensions (%d constraints, %d variables, "
+                   "%d nonzeros)\n", m, n, nnz);
+        return -1;
+    }
+    if (!data->row_offsets) {
+        if (m == 0 && nnz == 0) {
+            return 0;
+        }
+        job_printf(ctx, "Error: Constraint matrix has no row offsets\n");
+        return -1;
+    }
+    if (nnz > 0 && !data->column_indices) {
+        job_printf(ctx, "Error: Constraint matrix has no column indices\n");
+        return -1;
+    }
+    if (data->row_offsets[0] != 0) {
+        job_printf(ctx, "Error: Constraint matrix offsets start at %d instead of 0\n",
+                   data->row_offsets[0]);
+        return -1;
+    }
+    for (cuopt_int_t i = 0; i < m; i++) {
+        if (data->row_offsets[i + 1] < data->row_offsets[i]) {
+            job_printf(ctx, "Error: Constraint matrix offsets decrease at row %d (%d after %d)\n",
+                       i, data->row_offsets[i + 1], data->row_offsets[i]);
+            return -1;
+        }
+    }
+    if (data->row_offsets[m] != nnz) {
+        job_printf(ctx, "Error: Constraint matrix offsets end at %d but it has %d nonzeros\n",
+                   data->row_offsets[m], nnz);
+        return -1;
+    }
+    for (cuopt_int_t k = 0; k < nnz; k++) {
+        cuopt_int_t j = data->column_indices[k];
+        if (j < 0 || j >= n) {
+            job_printf(ctx, "Error: Constraint matrix index %d at position %d is out of range "
+                       "for %d variables\n", j, k, n);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Function to load a problem from any source (JSON, parse cache or binary
+// file) and reject it if its constraint matrix is malformed
+static int load_problem(JobContext* ctx, const char* filename, ProblemData* data) {
+    if (read_problem(ctx, filename, data) != 0) {
+        return -1;
+    }
+    if (check_problem_structure(ctx, data) != 0) {
+        job_printf(ctx, "Rejected problem file: %s\n", filename);
+        free_problem_data(data);
+        return -1;
+    }
+    return 0;
+}
+
+// Time limit of one solve in seconds; the blocks of a decomposed problem
+// share it
+#define SOLVER_TIME_LIMIT 300.0
+
+// Function to create the solver settings shared by every solve of a run
+int create_solver_settings(JobContext* ctx, cuOptSolverSettings* settings) {
+    log_timestamp(ctx, "SOLVER_SETTINGS_START");
     Timer settings_timer;
-    start_timer(&settings_timer);
+    start_timer(ctx, &settings_timer);
     
-    status = cuOptCreateSolverSettings(&settings);
+    cuopt_int_t status = cuOptCreateSolverSettings(settings);
     if (status != CUOPT_SUCCESS) {
-        printf("Error creating solver settings: %d\n", status);
-        goto CLEANUP;
+        job_printf(ctx, "Error creating solver settings: %d\n", status);
+        return status;
     }
     
     // Set solver parameters (you can adjust these as needed)
-    status = cuOptSetFloatParameter(settings, CUOPT_ABSOLUTE_PRIMAL_TOLERANCE, 1e-6);
+    status = cuOptSetFloatParameter(*settings, CUOPT_ABSOLUTE_PRIMAL_TOLERANCE, 1e-6);
     if (status != CUOPT_SUCCESS) {
-        printf("Warning: Could not set primal tolerance: %d\n", status);
+        job_printf(ctx, "Warning: Could not set primal tolerance: %d\n", status);
     }
     
-    status = cuOptSetFloatParameter(settings, CUOPT_TIME_LIMIT, 300.0);  // 5 minute limit
+    status = cuOptSetFloatParameter(*settings, CUOPT_TIME_LIMIT, SOLVER_TIME_LIMIT);
     if (status != CUOPT_SUCCESS) {
-        printf("Warning: Could not set time limit: %d\n", status);
+        job_printf(ctx, "Warning: Could not set time limit: %d\n", status);
     }
     
     // Set MPS output file if requested
-    if (mps_output_file) {
-        status = cuOptSetParameter(settings, CUOPT_USER_PROBLEM_FILE, mps_output_file);
+    if (ctx->mps_output_file) {
+        status = cuOptSetParameter(*settings, CUOPT_USER_PROBLEM_FILE, ctx->mps_output_file);
         if (status != CUOPT_SUCCESS) {
-            printf("Warning: Could not set MPS output file: %d\n", status);
+            job_printf(ctx, "Warning: Could not set MPS output file: %d\n", status);
+        } else {
+            job_printf(ctx, "MPS file will be written to: %s\n", ctx->mps_output_file);
+        }
+    }
+    
+    double settings_time = end_timer(ctx, &settings_timer);
+    log_timestamp(ctx, "SOLVER_SETTINGS_END");
+    log_phase_duration(ctx, "SOLVER_SETTINGS", settings_time);
+    
+    return CUOPT_SUCCESS;
+}
+
+// What solve_problem prints besides errors
+#define SOLVE_PRINT_RESULTS 1   // problem size, status, objective and MIP gap
+#define SOLVE_PRINT_PRIMAL 2    // the first primal values
+#define SOLVE_PRINT_ALL (SOLVE_PRINT_RESULTS | SOLVE_PRINT_PRIMAL)
+
+// Function to print the first (up to 20) primal values, by name if the
+// problem has variable_names
+static void print_primal_values(JobContext* ctx, const ProblemData* data,
+                                const cuopt_float_t* values) {
+    cuopt_int_t num_variables = data->num_variables;
+    job_printf(ctx, "\nPrimal Solution (showing first %d variables):\n", 
+               num_variables < 20 ? num_variables : 20);
+    for (int i = 0; i < (num_variables < 20 ? num_variables : 20); i++) {
+        if (data->variable_names) {
+            job_printf(ctx, "%s = %f\n", name_table_get(data->variable_names, i), values[i]);
+        } else {
+            job_printf(ctx, "x%d = %f\n", i, values[i]);
+        }
+    }
+    if (num_variables > 20) {
+        job_printf(ctx, "... (showing only first 20 of %d variables)\n", num_variables);
+    }
+}
+
+// Function to print the first primal values (with SOLVE_PRINT_PRIMAL in
+// `verbose`) and, for MIPs, the gap and bound, unscaled with `scaling` if set
+static void print_solution_details(JobContext* ctx, const ProblemData* data,
+                                   cuOptOptimizationProblem problem, cuOptSolution solution,
+                                   int verbose, const ProblemScaling* scaling) {
+    cuopt_int_t status;
+    
+    // Get and print solution variables (first 20 or fewer)
+    if (verbose & SOLVE_PRINT_PRIMAL) {
+        log_timestamp(ctx, "SOLUTION_EXTRACTION_START");
+        Timer solution_timer;
+        start_timer(ctx, &solution_timer);
+        
+        cuopt_float_t* solution_values = job_scratch_alloc(ctx, data->num_variables * sizeof(cuopt_float_t));
+        status = solution_values ? cuOptGetPrimalSolution(solution, solution_values) : CUOPT_INVALID_ARGUMENT;
+        if (status == CUOPT_SUCCESS) {
+            if (scaling) {
+                problem_scaling_unscale_primal(scaling, solution_values, data->num_variables);
+            }
+            print_primal_values(ctx, data, solution_values);
         } else {
-            printf("MPS file will be written to: %s\n", mps_output_file);
+            job_printf(ctx, "Error getting solution values: %d\n", status);
+        }
+        
+        double solution_time = end_timer(ctx, &solution_timer);
+        log_timestamp(ctx, "SOLUTION_EXTRACTION_END");
+        log_phase_duration(ctx, "SOLUTION_EXTRACTION", solution_time);
+    }
+    
+    // Check if this is a MIP and get MIP-specific information
+    cuopt_int_t is_mip;
+    status = cuOptIsMIP(problem, &is_mip);
+    if (status == CUOPT_SUCCESS && is_mip) {
+        cuopt_float_t mip_gap;
+        status = cuOptGetMIPGap(solution, &mip_gap);
+        if (status == CUOPT_SUCCESS) {
+            job_printf(ctx, "MIP Gap: %f\n", mip_gap);
+        }
+        
+        cuopt_float_t solution_bound;
+        status = cuOptGetSolutionBound(solution, &solution_bound);
+        if (status == CUOPT_SUCCESS) {
+            if (scaling) {
+                solution_bound = problem_scaling_unscale_objective(scaling, solution_bound);
+            }
+            job_printf(ctx, "Solution Bound: %f\n", solution_bound);
         }
     }
+}
+
+// Function to tighten the variable bounds of a MIP by bound propagation.
+// On success the bounds of `created` point to tightened copies in scratch
+// memory; otherwise they are left as they are.
+static void propagate_problem_bounds(JobContext* ctx, const ProblemData* data,
+                                     ProblemData* created) {
+    size_t n = (size_t)data->num_variables;
+    cuopt_float_t* tightened_lower = job_scratch_alloc(ctx, (n ? n : 1) * sizeof(cuopt_float_t));
+    cuopt_float_t* tightened_upper = job_scratch_alloc(ctx, (n ? n : 1) * sizeof(cuopt_float_t));
+    if (!tightened_lower || !tightened_upper) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        return;
+    }
+    for (size_t j = 0; j < n; j++) {
+        tightened_lower[j] = problem_variable_lower_bound(data, (cuopt_int_t)j);
+        tightened_upper[j] = problem_variable_upper_bound(data, (cuopt_int_t)j);
+    }
+    
+    log_timestamp(ctx, "BOUND_PROPAGATION_START");
+    Timer propagation_timer;
+    start_timer(ctx, &propagation_timer);
+    double propagation_start = wall_clock_seconds();
+    
+    PropagationStats stats;
+    int status = bound_propagation_run(ctx, data, tightened_lower, tightened_upper, &stats);
+    
+    double propagation_seconds = wall_clock_seconds() - propagation_start;
+    double propagation_time = end_timer(ctx, &propagation_timer);
+    log_timestamp(ctx, "BOUND_PROPAGATION_END");
+    log_phase_duration(ctx, "BOUND_PROPAGATION", propagation_time);
+    
+    if (status == 1) {
+        job_printf(ctx, "Bound propagation: problem is infeasible (%.3f s), keeping the original "
+                   "bounds\n", propagation_seconds);
+    } else if (status == 0) {
+        job_printf(ctx, "Bound propagation: tightened %d lower and %d upper bounds in %d rounds "
+                   "(%.3f s)\n", stats.tightened_lower, stats.tightened_upper, stats.rounds,
+                   propagation_seconds);
+        created->variable_lower_bounds = tightened_lower;
+        created->variable_upper_bounds = tightened_upper;
+    }
+}
+
+// Function to scale the objective by its scalability_factor and equilibrate
+// the matrix with --scale. On success the arrays of `created` point into
+// `scaling`; otherwise they are left as they are and 0 is returned.
+static int scale_problem(JobContext* ctx, ProblemData* created, ProblemScaling* scaling) {
+    log_timestamp(ctx, "SCALING_START");
+    Timer scaling_timer;
+    start_timer(ctx, &scaling_timer);
+    double scaling_start = wall_clock_seconds();
+    
+    int status = problem_scaling_run(ctx, created, ctx->scaling_method, scaling);
+    
+    double scaling_seconds = wall_clock_seconds() - scaling_start;
+    double scaling_time = end_timer(ctx, &scaling_timer);
+    log_timestamp(ctx, "SCALING_END");
+    log_phase_duration(ctx, "SCALING", scaling_time);
+    
+    if (status != 0) {
+        return 0;
+    }
+    if (ctx->scaling_method == SCALING_NONE) {
+        job_printf(ctx, "Scaling: objective x%g (%.3f s)\n", scaling->objective_scale,
+                   scaling_seconds);
+    } else {
+        job_printf(ctx, "Scaling: objective x%g, %s equilibration in %d passes, coefficient "
+                   "range %.1e -> %.1e (%.3f s)\n", scaling->objective_scale,
+                   ctx->scaling_method == SCALING_RUIZ ? "Ruiz" : "geometric mean", scaling->passes,
+                   scaling->range_before, scaling->range_after, scaling_seconds);
+    }
+    created->matrix_values = scaling->matrix_values;
+    created->objective_coefficients = scaling->objective_coefficients;
+    created->objective_offset = scaling->objective_offset;
+    created->constraint_lower_bounds = scaling->constraint_lower_bounds;
+    created->constraint_upper_bounds = scaling->constraint_upper_bounds;
+    created->variable_lower_bounds = scaling->variable_lower_bounds;
+    created->variable_upper_bounds = scaling->variable_upper_bounds;
+    return 1;
+}
+
+// Function to solve the problem using cuOpt C API
+// (with `settings` from create_solver_settings). The outcome is stored in
+// `result`; `verbose` selects what is printed (SOLVE_PRINT_*).
+int solve_problem(JobContext* ctx, const ProblemData* data, cuOptSolverSettings settings,
+                  SolveResult* result, int verbose) {
+    Timer timer;
+    log_timestamp(ctx, "SOLVE_START");
+    start_timer(ctx, &timer);
+    
+    cuOptOptimizationProblem problem = NULL;
+    cuOptSolution solution = NULL;
+    cuopt_int_t status;
+    
+    // The solution buffers belong to the caller
+    cuopt_float_t* primal_solution = result->primal_solution;
+    cuopt_float_t* dual_solution = result->dual_solution;
+    cuopt_float_t* reduced_costs = result->reduced_costs;
+    memset(result, 0, sizeof(SolveResult));
+    result->primal_solution = primal_solution;
+    result->dual_solution = dual_solution;
+    result->reduced_costs = reduced_costs;
+    
+    if (verbose & SOLVE_PRINT_RESULTS) {
+        job_printf(ctx, "Creating and solving problem...\n");
+        job_printf(ctx, "Problem size: %d constraints, %d variables, %d nonzeros\n", 
+                   data->num_constraints, data->num_variables, data->nnz);
+    }
+    
+    // The arrays handed to cuOpt: the problem's own, or tightened and
+    // scaled copies
+    ProblemData created = *data;
+    if (ctx->propagate_enabled && problem_data_is_mip(data)) {
+        propagate_problem_bounds(ctx, data, &created);
+    }
+    ProblemScaling scaling;
+    memset(&scaling, 0, sizeof(ProblemScaling));
+    int scaled = 0;
+    if (ctx->scaling_method != SCALING_NONE ||
+        (data->objective_scaling_factor != 0.0 && data->objective_scaling_factor != 1.0)) {
+        scaled = scale_problem(ctx, &created, &scaling);
+    }
+    
+    // Create the problem using ranged formulation
+    log_timestamp(ctx, "PROBLEM_CREATION_START");
+    Timer problem_timer;
+    start_timer(ctx, &problem_timer);
+    
+    status = cuOptCreateRangedProblem(created.num_constraints,
+                                     created.num_variables,
+                                     created.objective_sense,
+                                     created.objective_offset,
+                                     created.objective_coefficients,
+                                     created.row_offsets,
+                                     created.column_indices,
+                                     created.matrix_values,
+                                     created.constraint_lower_bounds,
+                                     created.constraint_upper_bounds,
+				     created.variable_lower_bounds,
+				     created.variable_upper_bounds,
+                                     created.variable_types,
+                                     &problem);
     
-    double settings_time = end_timer(&settings_timer);
-    log_timestamp("SOLVER_SETTINGS_END");
-    log_phase_duration("SOLVER_SETTINGS", settings_time);
+    double problem_time = end_timer(ctx, &problem_timer);
+    log_timestamp(ctx, "PROBLEM_CREATION_END");
+    log_phase_duration(ctx, "PROBLEM_CREATION", problem_time);
+    
+    if (status != CUOPT_SUCCESS) {
+        job_printf(ctx, "Error creating problem: %d\n", status);
+        goto CLEANUP;
+    }
     
     // Solve the problem
-    log_timestamp("SOLVER_EXECUTION_START");
+    log_timestamp(ctx, "SOLVER_EXECUTION_START");
     Timer solve_timer;
-    start_timer(&solve_timer);
+    start_timer(ctx, &solve_timer);
     
     status = cuOptSolve(problem, settings, &solution);
     
-    double solve_time_measured = end_timer(&solve_timer);
-    log_timestamp("SOLVER_EXECUTION_END");
-    log_phase_duration("SOLVER_EXECUTION", solve_time_measured);
+    double solve_time_measured = end_timer(ctx, &solve_timer);
+    log_timestamp(ctx, "SOLVER_EXECUTION_END");
+    log_phase_duration(ctx, "SOLVER_EXECUTION", solve_time_measured);
     
     if (status != CUOPT_SUCCESS) {
-        printf("Error solving problem: %d\n", status);
+        job_printf(ctx, "Error solving problem: %d\n", status);
         goto CLEANUP;
     }
     
     // Get and display results
-    log_timestamp("RESULT_EXTRACTION_START");
+    log_timestamp(ctx, "RESULT_EXTRACTION_START");
     Timer results_timer;
-    start_timer(&results_timer);
+    start_timer(ctx, &results_timer);
     
     cuopt_float_t solve_time;
     cuopt_int_t termination_status;
@@ -543,181 +974,1586 @@ int solve_problem(const ProblemData* data) {
     
     status = cuOptGetSolveTime(solution, &solve_time);
     if (status != CUOPT_SUCCESS) {
-        printf("Error getting solve time: %d\n", status);
+        job_printf(ctx, "Error getting solve time: %d\n", status);
         goto CLEANUP;
     }
     
     status = cuOptGetTerminationStatus(solution, &termination_status);
     if (status != CUOPT_SUCCESS) {
-        printf("Error getting termination status: %d\n", status);
+        job_printf(ctx, "Error getting termination status: %d\n", status);
         goto CLEANUP;
     }
     
     status = cuOptGetObjectiveValue(solution, &objective_value);
     if (status != CUOPT_SUCCESS) {
-        printf("Error getting objective value: %d\n", status);
+        job_printf(ctx, "Error getting objective value: %d\n", status);
         goto CLEANUP;
     }
     
-    // Print results
-    printf("\nResults:\n");
-    printf("--------\n");
-    printf("Termination status: %s (%d)\n", termination_status_to_string(termination_status), termination_status);
-    printf("Solve time: %f seconds\n", solve_time);
-    printf("Objective value: %f\n", objective_value);
-    
-    // Get and print solution variables (first 20 or fewer)
-    log_timestamp("SOLUTION_EXTRACTION_START");
-    Timer solution_timer;
-    start_timer(&solution_timer);
-    
-    cuopt_float_t* solution_values = malloc(data->num_variables * sizeof(cuopt_float_t));
-    status = cuOptGetPrimalSolution(solution, solution_values);
-    if (status == CUOPT_SUCCESS) {
-        printf("\nPrimal Solution (showing first %d variables):\n", 
-               data->num_variables < 20 ? data->num_variables : 20);
-        for (int i = 0; i < (data->num_variables < 20 ? data->num_variables : 20); i++) {
-            printf("x%d = %f\n", i, solution_values[i]);
-        }
-        if (data->num_variables > 20) {
-            printf("... (showing only first 20 of %d variables)\n", data->num_variables);
+    if (scaled) {
+        objective_value = problem_scaling_unscale_objective(&scaling, objective_value);
+    }
+    result->termination_status = termination_status;
+    result->objective_value = objective_value;
+    result->solve_time = solve_time;
+    
+    cuopt_float_t solution_bound;
+    if (problem_data_is_mip(data) &&
+        cuOptGetSolutionBound(solution, &solution_bound) == CUOPT_SUCCESS) {
+        if (scaled) {
+            solution_bound = problem_scaling_unscale_objective(&scaling, solution_bound);
         }
-    } else {
-        printf("Error getting solution values: %d\n", status);
+        result->solution_bound = solution_bound;
+        result->has_bound = 1;
     }
-    free(solution_values);
     
-    double solution_time = end_timer(&solution_timer);
-    log_timestamp("SOLUTION_EXTRACTION_END");
-    log_phase_duration("SOLUTION_EXTRACTION", solution_time);
+    if (primal_solution) {
+        status = cuOptGetPrimalSolution(solution, primal_solution);
+        if (status != CUOPT_SUCCESS) {
+            job_printf(ctx, "Error getting primal solution: %d\n", status);
+            goto CLEANUP;
+        }
+        if (scaled) {
+            problem_scaling_unscale_primal(&scaling, primal_solution, data->num_variables);
+        }
+    }
     
-    // Check if this is a MIP and get MIP-specific information
-    cuopt_int_t is_mip;
-    status = cuOptIsMIP(problem, &is_mip);
-    if (status == CUOPT_SUCCESS && is_mip) {
-        cuopt_float_t mip_gap;
-        status = cuOptGetMIPGap(solution, &mip_gap);
-        if (status == CUOPT_SUCCESS) {
-            printf("MIP Gap: %f\n", mip_gap);
+    // Duals and reduced costs only exist for LPs
+    if ((dual_solution || reduced_costs) && !problem_data_is_mip(data)) {
+        if (dual_solution) {
+            status = cuOptGetDualSolution(solution, dual_solution);
+            if (status != CUOPT_SUCCESS) {
+                job_printf(ctx, "Error getting dual solution: %d\n", status);
+                goto CLEANUP;
+            }
+            if (scaled) {
+                problem_scaling_unscale_dual(&scaling, dual_solution, data->num_constraints);
+            }
         }
-        
-        cuopt_float_t solution_bound;
-        status = cuOptGetSolutionBound(solution, &solution_bound);
-        if (status == CUOPT_SUCCESS) {
-            printf("Solution Bound: %f\n", solution_bound);
+        if (reduced_costs) {
+            status = cuOptGetReducedCosts(solution, reduced_costs);
+            if (status != CUOPT_SUCCESS) {
+                job_printf(ctx, "Error getting reduced costs: %d\n", status);
+                goto CLEANUP;
+            }
+            if (scaled) {
+                problem_scaling_unscale_reduced_costs(&scaling, reduced_costs, data->num_variables);
+            }
         }
+        result->has_duals = 1;
+    }
+    
+    if (verbose & SOLVE_PRINT_RESULTS) {
+        // Print results
+        job_printf(ctx, "\nResults:\n");
+        job_printf(ctx, "--------\n");
+        job_printf(ctx, "Termination status: %s (%d)\n", termination_status_to_string(termination_status), termination_status);
+        job_printf(ctx, "Solve time: %f seconds\n", solve_time);
+        job_printf(ctx, "Objective value: %f\n", objective_value);
+        
+        print_solution_details(ctx, data, problem, solution, verbose, scaled ? &scaling : NULL);
     }
     
-    double results_time = end_timer(&results_timer);
-    log_timestamp("RESULT_EXTRACTION_END");
-    log_phase_duration("RESULT_EXTRACTION", results_time);
+    double results_time = end_timer(ctx, &results_timer);
+    log_timestamp(ctx, "RESULT_EXTRACTION_END");
+    log_phase_duration(ctx, "RESULT_EXTRACTION", results_time);
 
 CLEANUP:
-    log_timestamp("CLEANUP_START");
+    log_timestamp(ctx, "CLEANUP_START");
     Timer cleanup_timer;
-    start_timer(&cleanup_timer);
+    start_timer(ctx, &cleanup_timer);
     
     cuOptDestroyProblem(&problem);
-    cuOptDestroySolverSettings(&settings);
     cuOptDestroySolution(&solution);
+    problem_scaling_free(&scaling);
     
-    double cleanup_time = end_timer(&cleanup_timer);
-    log_timestamp("CLEANUP_END");
-    log_phase_duration("CLEANUP", cleanup_time);
+    double cleanup_time = end_timer(ctx, &cleanup_timer);
+    log_timestamp(ctx, "CLEANUP_END");
+    log_phase_duration(ctx, "CLEANUP", cleanup_time);
     
-    double total_solve_time = end_timer(&timer);
-    log_timestamp("SOLVE_END");
-    log_phase_duration("SOLVE_TOTAL", total_solve_time);
+    double total_solve_time = end_timer(ctx, &timer);
+    log_timestamp(ctx, "SOLVE_END");
+    log_phase_duration(ctx, "SOLVE_TOTAL", total_solve_time);
     
+    result->status = status;
     return status;
 }
 
+// Time limit of a block solved after the problem's limit ran out
+#define BLOCK_MIN_TIME_LIMIT 0.01
+
+// One block of a decomposed solve
+typedef struct {
+    JobContext job;
+    SolveResult result;
+} BlockJob;
+
+// State shared by the block solves of one problem
+typedef struct {
+    JobContext* ctx;
+    const ProblemData* data;
+    const ProblemBlocks* blocks;
+    BlockJob* jobs;
+    cuopt_float_t* primal;   // full primal vector to fill, or NULL
+    cuopt_float_t* dual;     // full duals and reduced costs to fill, or NULL
+    cuopt_float_t* reduced_costs;
+    double deadline;         // wall_clock_seconds() at which the time limit runs out
+} BlockRun;
+
+// Extract and solve one block with its own solver settings; may run on
+// scheduler worker threads
+static void solve_block(void* user, size_t index) {
+    BlockRun* run = user;
+    BlockJob* block_job = &run->jobs[index];
+    job_context_init_from(&block_job->job, run->ctx);
+    job_context_capture(&block_job->job);
+    
+    ProblemData block;
+    if (problem_blocks_extract(&block_job->job, run->data, run->blocks, (cuopt_int_t)index,
+                               &block) != 0) {
+        block_job->result.status = -1;
+        return;
+    }
+    SolveResult* result = &block_job->result;
+    if (run->primal) {
+        result->primal_solution =
+            job_scratch_alloc(&block_job->job, (size_t)block.num_variables * sizeof(cuopt_float_t));
+    }
+    if (run->dual && run->reduced_costs) {
+        result->dual_solution =
+            job_scratch_alloc(&block_job->job, (size_t)block.num_constraints * sizeof(cuopt_float_t));
+        result->reduced_costs =
+            job_scratch_alloc(&block_job->job, (size_t)block.num_variables * sizeof(cuopt_float_t));
+    }
+    cuOptSolverSettings settings = NULL;
+    result->status = create_solver_settings(&block_job->job, &settings);
+    if (result->status == CUOPT_SUCCESS) {
+        // What is left of the problem's time limit; a block that starts
+        // after it ran out still gets a moment to report its status
+        double remaining = run->deadline - wall_clock_seconds();
+        result->status = cuOptSetFloatParameter(settings, CUOPT_TIME_LIMIT,
+                                                remaining > BLOCK_MIN_TIME_LIMIT
+                                                    ? remaining : BLOCK_MIN_TIME_LIMIT);
+    }
+    if ((run->primal && !result->primal_solution) ||
+        (run->dual && run->reduced_costs && (!result->dual_solution || !result->reduced_costs))) {
+        result->status = -1;
+    }
+    if (result->status == CUOPT_SUCCESS) {
+        solve_problem(&block_job->job, &block, settings, result, 0);
+    }
+    if (result->status == CUOPT_SUCCESS && run->primal) {
+        // Blocks own disjoint variables and constraints, so concurrent
+        // scatters never collide
+        problem_blocks_scatter(run->blocks, (cuopt_int_t)index, result->primal_solution,
+                               run->primal);
+    }
+    if (result->status == CUOPT_SUCCESS && result->has_duals) {
+        problem_blocks_scatter_rows(run->blocks, (cuopt_int_t)index, result->dual_solution,
+                                    run->dual);
+        problem_blocks_scatter(run->blocks, (cuopt_int_t)index, result->reduced_costs,
+                               run->reduced_costs);
+    }
+    cuOptDestroySolverSettings(&settings);
+    free_problem_data(&block);
+}
+
+// Relative gap between a MIP objective and its bound: |objective - bound|
+// over |objective|, 0 when they are equal
+static double relative_mip_gap(double objective_value, double solution_bound) {
+    double difference = fabs(objective_value - solution_bound);
+    if (difference == 0.0) {
+        return 0.0;
+    }
+    return objective_value != 0.0 ? difference / fabs(objective_value) : INFINITY;
+}
+
+// Pass one block's captured output on to the problem's own output, in
+// block order
+static void report_block(void* user, size_t index) {
+    BlockRun* run = user;
+    job_context_flush(&run->jobs[index].job, job_output(run->ctx));
+    job_context_destroy(&run->jobs[index].job);
+}
+
+// Function to solve a problem block by block when --decompose is on and
+// its constraint matrix splits into independent blocks; otherwise the same
+// as solve_problem. The objective of the reassembled result is the sum of
+// the blocks' plus the offset, its status that of the first block that did
+// not solve to optimality and its solve time the sum over the blocks. A
+// MIP's bound is summed the same way (an optimal LP block is its own
+// bound) and its gap recomputed from it. The blocks share one time limit.
+static int solve_by_blocks(JobContext* ctx, const ProblemData* data, cuOptSolverSettings settings,
+                           SolveResult* result, int verbose) {
+    if (!ctx->decompose_problems) {
+        return solve_problem(ctx, data, settings, result, verbose);
+    }
+    double deadline = wall_clock_seconds() + SOLVER_TIME_LIMIT;
+    
+    log_timestamp(ctx, "DECOMPOSE_START");
+    Timer decompose_timer;
+    start_timer(ctx, &decompose_timer);
+    
+    ProblemBlocks blocks;
+    int found = problem_blocks_find(ctx, data, &blocks) == 0;
+    
+    double decompose_time = end_timer(ctx, &decompose_timer);
+    log_timestamp(ctx, "DECOMPOSE_END");
+    log_phase_duration(ctx, "DECOMPOSE", decompose_time);
+    
+    if (!found || blocks.num_blocks < 2) {
+        if (found) {
+            problem_blocks_free(&blocks);
+        }
+        return solve_problem(ctx, data, settings, result, verbose);
+    }
+    
+    // The solution buffers belong to the caller
+    cuopt_float_t* primal_solution = result->primal_solution;
+    cuopt_float_t* dual_solution = result->dual_solution;
+    cuopt_float_t* reduced_costs = result->reduced_costs;
+    memset(result, 0, sizeof(SolveResult));
+    result->primal_solution = primal_solution;
+    result->dual_solution = dual_solution;
+    result->reduced_costs = reduced_costs;
+    if (!primal_solution && (verbose & SOLVE_PRINT_PRIMAL)) {
+        primal_solution = job_scratch_alloc(ctx, (size_t)data->num_variables * sizeof(cuopt_float_t));
+    }
+    
+    if (verbose & SOLVE_PRINT_RESULTS) {
+        job_printf(ctx, "Creating and solving problem...\n");
+        job_printf(ctx, "Problem size: %d constraints, %d variables, %d nonzeros\n", 
+                   data->num_constraints, data->num_variables, data->nnz);
+        job_printf(ctx, "Problem splits into %d independent blocks\n", blocks.num_blocks);
+    }
+    
+    BlockRun run = { ctx, data, &blocks, calloc((size_t)blocks.num_blocks, sizeof(BlockJob)),
+                     primal_solution, dual_solution, reduced_costs, deadline };
+    if (!run.jobs) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        problem_blocks_free(&blocks);
+        result->status = -1;
+        return result->status;
+    }
+    
+    log_timestamp(ctx, "BLOCK_SOLVES_START");
+    Timer blocks_timer;
+    start_timer(ctx, &blocks_timer);
+    
+    SchedulerStats stats;
+    int scheduled = scheduler_run((size_t)blocks.num_blocks, ctx->block_jobs, solve_block,
+                                  report_block, &run, &stats) == 0;
+    
+    double blocks_time = end_timer(ctx, &blocks_timer);
+    log_timestamp(ctx, "BLOCK_SOLVES_END");
+    log_phase_duration(ctx, "BLOCK_SOLVES", blocks_time);
+    
+    // Reassemble the result from the blocks
+    cuopt_int_t status = scheduled ? CUOPT_SUCCESS : -1;
+    cuopt_int_t termination_status = CUOPT_TERIMINATION_STATUS_OPTIMAL;
+    double objective_value = data->objective_offset, solve_time = 0.0;
+    double solution_bound = data->objective_offset;
+    int has_duals = 1, has_bound = problem_data_is_mip(data);
+    for (cuopt_int_t b = 0; scheduled && b < blocks.num_blocks; b++) {
+        const SolveResult* block_result = &run.jobs[b].result;
+        has_duals &= block_result->has_duals;
+        if (block_result->status == CUOPT_SUCCESS && block_result->has_bound) {
+            solution_bound += block_result->solution_bound;
+        } else if (block_result->status == CUOPT_SUCCESS &&
+                   block_result->termination_status == CUOPT_TERIMINATION_STATUS_OPTIMAL) {
+            solution_bound += block_result->objective_value;
+        } else {
+            has_bound = 0;
+        }
+        if (block_result->status != CUOPT_SUCCESS) {
+            if (status == CUOPT_SUCCESS) {
+                status = block_result->status;
+            }
+            continue;
+        }
+        if (block_result->termination_status != CUOPT_TERIMINATION_STATUS_OPTIMAL &&
+            termination_status == CUOPT_TERIMINATION_STATUS_OPTIMAL) {
+            termination_status = block_result->termination_status;
+        }
+        objective_value += block_result->objective_value;
+        solve_time += block_result->solve_time;
+    }
+    result->status = status;
+    result->termination_status = termination_status;
+    result->objective_value = objective_value;
+    result->solve_time = solve_time;
+    result->has_duals = status == CUOPT_SUCCESS && has_duals;
+    result->solution_bound = solution_bound;
+    result->has_bound = status == CUOPT_SUCCESS && has_bound;
+    
+    if ((verbose & SOLVE_PRINT_RESULTS) && status == CUOPT_SUCCESS) {
+        job_printf(ctx, "\nResults:\n");
+        job_printf(ctx, "--------\n");
+        job_printf(ctx, "Termination status: %s (%d)\n", termination_status_to_string(termination_status), termination_status);
+        job_printf(ctx, "Solve time: %f seconds (summed over %d blocks)\n", solve_time, blocks.num_blocks);
+        job_printf(ctx, "Objective value: %f\n", objective_value);
+    }
+    if ((verbose & SOLVE_PRINT_PRIMAL) && status == CUOPT_SUCCESS && primal_solution) {
+        print_primal_values(ctx, data, primal_solution);
+    }
+    if ((verbose & SOLVE_PRINT_RESULTS) && result->has_bound) {
+        job_printf(ctx, "MIP Gap: %f\n", relative_mip_gap(objective_value, solution_bound));
+        job_printf(ctx, "Solution Bound: %f\n", solution_bound);
+    }
+    
+    free(run.jobs);
+    problem_blocks_free(&blocks);
+    return status;
+}
+
+// Function to presolve the problem when --presolve is on, solve the reduced
+// problem (block by block with --decompose) and map its primal solution
+// back to the original variables
+static int solve_presolved(JobContext* ctx, const ProblemData* data, cuOptSolverSettings settings,
+                           SolveResult* result, int verbose) {
+    if (!ctx->presolve_enabled) {
+        return solve_by_blocks(ctx, data, settings, result, verbose);
+    }
+    
+    log_timestamp(ctx, "PRESOLVE_START");
+    Timer presolve_timer;
+    start_timer(ctx, &presolve_timer);
+    double presolve_start = wall_clock_seconds();
+    
+    Presolve presolve;
+    int presolve_status = presolve_run(ctx, data, &presolve);
+    
+    double presolve_seconds = wall_clock_seconds() - presolve_start;
+    double presolve_time = end_timer(ctx, &presolve_timer);
+    log_timestamp(ctx, "PRESOLVE_END");
+    log_phase_duration(ctx, "PRESOLVE", presolve_time);
+    
+    if (presolve_status != 0 || presolve.stack_size == 0) {
+        if (presolve_status == 1) {
+            job_printf(ctx, "Presolve: problem is infeasible (%.3f s), solving it unreduced\n",
+                       presolve_seconds);
+        } else if (presolve_status == 0) {
+            job_printf(ctx, "Presolve: no reductions (%.3f s)\n", presolve_seconds);
+            presolve_free(&presolve);
+        }
+        return solve_by_blocks(ctx, data, settings, result, verbose);
+    }
+    
+    const ProblemData* reduced = &presolve.reduced;
+    const PresolveStats* stats = &presolve.stats;
+    job_printf(ctx, "Presolve: %d -> %d constraints, %d -> %d variables, %d -> %d nonzeros "
+               "in %.3f s\n", data->num_constraints, reduced->num_constraints,
+               data->num_variables, reduced->num_variables, data->nnz, reduced->nnz,
+               presolve_seconds);
+    job_printf(ctx, "  removed %d empty, %d singleton, %d free and %d parallel rows, %d fixed "
+               "and %d duplicate variables in %d passes\n", stats->empty_rows,
+               stats->singleton_rows, stats->free_rows, stats->parallel_rows,
+               stats->fixed_variables, stats->duplicate_columns, stats->passes);
+    
+    // The solution buffers belong to the caller. Postsolve only recovers
+    // the primal, so the duals of the reduced problem are not passed on.
+    cuopt_float_t* caller_primal = result->primal_solution;
+    cuopt_float_t* caller_dual = result->dual_solution;
+    cuopt_float_t* caller_reduced_costs = result->reduced_costs;
+    cuopt_float_t* primal_solution = caller_primal;
+    if (caller_dual || caller_reduced_costs) {
+        job_printf(ctx, "Presolve: duals and reduced costs are not available\n");
+    }
+    if (!primal_solution && (verbose & SOLVE_PRINT_PRIMAL)) {
+        primal_solution = job_scratch_alloc(ctx, (size_t)data->num_variables * sizeof(cuopt_float_t));
+    }
+    SolveResult reduced_result;
+    memset(&reduced_result, 0, sizeof(SolveResult));
+    if (primal_solution) {
+        reduced_result.primal_solution =
+            job_scratch_alloc(ctx, (size_t)reduced->num_variables * sizeof(cuopt_float_t));
+    }
+    
+    cuopt_int_t status;
+    if (reduced->num_variables == 0) {
+        // Presolve fixed every variable; there is nothing left to solve
+        reduced_result.termination_status = CUOPT_TERIMINATION_STATUS_OPTIMAL;
+        reduced_result.objective_value = reduced->objective_offset;
+        status = CUOPT_SUCCESS;
+        if (verbose & SOLVE_PRINT_RESULTS) {
+            job_printf(ctx, "\nResults:\n");
+            job_printf(ctx, "--------\n");
+            job_printf(ctx, "Termination status: %s (%d)\n", termination_status_to_string(reduced_result.termination_status), reduced_result.termination_status);
+            job_printf(ctx, "Solve time: %f seconds (solved by presolve)\n", 0.0);
+            job_printf(ctx, "Objective value: %f\n", reduced_result.objective_value);
+        }
+    } else if (primal_solution && !reduced_result.primal_solution) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        status = -1;
+        reduced_result.status = status;
+    } else {
+        status = solve_by_blocks(ctx, reduced, settings, &reduced_result,
+                                 verbose & ~SOLVE_PRINT_PRIMAL);
+    }
+    
+    if (status == CUOPT_SUCCESS && primal_solution) {
+        log_timestamp(ctx, "POSTSOLVE_START");
+        Timer postsolve_timer;
+        start_timer(ctx, &postsolve_timer);
+        
+        presolve_postsolve_primal(&presolve, reduced_result.primal_solution, primal_solution);
+        
+        double postsolve_time = end_timer(ctx, &postsolve_timer);
+        log_timestamp(ctx, "POSTSOLVE_END");
+        log_phase_duration(ctx, "POSTSOLVE", postsolve_time);
+        
+        if (verbose & SOLVE_PRINT_PRIMAL) {
+            print_primal_values(ctx, data, primal_solution);
+        }
+    }
+    
+    *result = reduced_result;
+    result->status = status;
+    result->primal_solution = caller_primal;
+    result->dual_solution = caller_dual;
+    result->reduced_costs = caller_reduced_costs;
+    result->has_duals = 0;
+    presolve_free(&presolve);
+    return status;
+}
+
+// Function to name the --solution-out file of one input: a '*' in the
+// option is replaced by the input's file name without directory and
+// .json or .cuopt.bin extension
+static void solution_output_path(const JobContext* ctx, const char* input, char* path,
+                                 size_t size) {
+    const char* pattern = ctx->solution_output_file;
+    const char* star = strchr(pattern, '*');
+    if (!star) {
+        snprintf(path, size, "%s", pattern);
+        return;
+    }
+    const char* name = strrchr(input, '/');
+    name = name ? name + 1 : input;
+    size_t length = strlen(name);
+    if (length > 10 && strcmp(name + length - 10, ".cuopt.bin") == 0) {
+        length -= 10;
+    } else if (length > 5 && strcmp(name + length - 5, ".json") == 0) {
+        length -= 5;
+    }
+    snprintf(path, size, "%.*s%.*s%s", (int)(star - pattern), pattern,
+             (int)length, name, star + 1);
+}
+
+// Function to free the solution buffers of a result
+static void free_solution_buffers(SolveResult* result) {
+    free(result->primal_solution);
+    free(result->dual_solution);
+    free(result->reduced_costs);
+    result->primal_solution = NULL;
+    result->dual_solution = NULL;
+    result->reduced_costs = NULL;
+}
+
+// Function to allocate the buffers a solve extracts its solution into when
+// solutions are written: the primal and, for LPs, the duals and reduced
+// costs. They stay NULL otherwise.
+static void solution_buffers(const JobContext* ctx, const ProblemData* data,
+                             SolveResult* result) {
+    if (!ctx->solution_writer) {
+        return;
+    }
+    size_t n = (size_t)data->num_variables + 1, m = (size_t)data->num_constraints + 1;
+    result->primal_solution = malloc(n * sizeof(cuopt_float_t));
+    int failed = !result->primal_solution;
+    if (!problem_data_is_mip(data)) {
+        result->dual_solution = malloc(m * sizeof(cuopt_float_t));
+        result->reduced_costs = malloc(n * sizeof(cuopt_float_t));
+        failed |= !result->dual_solution || !result->reduced_costs;
+    }
+    if (failed) {
+        printf("Error: Memory allocation failed, solution not written\n");
+        free_solution_buffers(result);
+    }
+}
+
+// Function to hand the solution of a solved problem to the background
+// writer, which frees the buffers (and the names it takes from `data`)
+// once the file is on disk
+static void queue_solution(const JobContext* ctx, const char* input, SolveResult* result,
+                           ProblemData* data) {
+    if (ctx->solution_writer && result->primal_solution && result->status == CUOPT_SUCCESS) {
+        char path[4096];
+        solution_output_path(ctx, input, path, sizeof(path));
+        async_writer_submit(ctx->solution_writer, path, result, data);
+    }
+    free_solution_buffers(result);
+}
+
+// Function to wait for the solution writer to finish and report its time.
+// Returns 0 if every solution file was written.
+static int finish_solution_writer(JobContext* ctx) {
+    if (!ctx->solution_writer) {
+        return 0;
+    }
+    log_timestamp(ctx, "SOLUTION_WRITE_DRAIN_START");
+    AsyncWriterStats stats;
+    int status = async_writer_finish(ctx->solution_writer, &stats);
+    ctx->solution_writer = NULL;
+    log_timestamp(ctx, "SOLUTION_WRITE_DRAIN_END");
+    
+    printf("Solution files: %zu written, %zu failed; writer busy %.3f s, %.3f s waited for "
+           "at exit\n", stats.written, stats.failed, stats.busy, stats.drain);
+    log_phase_duration(ctx, "SOLUTION_WRITE", stats.busy);
+    log_phase_duration(ctx, "SOLUTION_WRITE_STALL", stats.submit_stall);
+    log_phase_duration(ctx, "SOLUTION_WRITE_DRAIN", stats.drain);
+    return status;
+}
+
+// Per-problem row of the batch result table
+typedef struct {
+    const char* filename;
+    JobContext job;        // options from the run, output of this problem
+    int loaded;
+    SolveResult result;
+    double load_seconds;
+    double solve_seconds;
+} BatchEntry;
+
+// Function to print the batch result table and aggregate throughput
+static void print_batch_summary(const BatchEntry* entries, size_t count, double total_seconds) {
+    size_t solved = 0;
+    printf("\nBatch results:\n");
+    printf("%5s  %-22s %20s %10s %10s  %s\n", "#", "Status", "Objective", "Load (s)", "Solve (s)", "File");
+    for (size_t i = 0; i < count; i++) {
+        const BatchEntry* entry = &entries[i];
+        if (!entry->loaded) {
+            printf("%5zu  %-22s %20s %10.3f %10s  %s\n", i + 1, "Load failed", "-",
+                   entry->load_seconds, "-", entry->filename);
+        } else if (entry->result.status != CUOPT_SUCCESS) {
+            char status[32];
+            snprintf(status, sizeof(status), "Error %d", entry->result.status);
+            printf("%5zu  %-22s %20s %10.3f %10.3f  %s\n", i + 1, status, "-",
+                   entry->load_seconds, entry->solve_seconds, entry->filename);
+        } else {
+            solved++;
+            printf("%5zu  %-22s %20.10g %10.3f %10.3f  %s\n", i + 1,
+                   termination_status_to_string(entry->result.termination_status),
+                   entry->result.objective_value, entry->load_seconds, entry->solve_seconds,
+                   entry->filename);
+        }
+    }
+    printf("\nSolved %zu of %zu problems in %.3f seconds (%.2f problems/sec)\n", solved, count,
+           total_seconds, total_seconds > 0.0 ? count / total_seconds : 0.0);
+}
+
+// State shared by the load and solve steps of a batch
+typedef struct {
+    JobContext* ctx;
+    const InputList* inputs;
+    BatchEntry* entries;
+    cuOptSolverSettings settings;  // NULL with --jobs: each job creates its own
+    int capture;                   // hold each problem's output until it is reported
+    int failures;
+    size_t packs;                  // block-diagonal solves with --pack
+    size_t packed;                 // problems solved as part of one
+} BatchRun;
+
+// Load step of a batch; may run on pipeline loader or scheduler worker
+// threads. With problems in flight at once, each problem's output is held
+// back until it is reported.
+static int batch_load(void* user, size_t index, ProblemData* data) {
+    BatchRun* run = user;
+    BatchEntry* entry = &run->entries[index];
+    job_context_init_from(&entry->job, run->ctx);
+    if (run->capture) {
+        job_context_capture(&entry->job);
+    }
+    
+    double load_start = wall_clock_seconds();
+    entry->loaded = load_problem(&entry->job, entry->filename, data) == 0;
+    entry->load_seconds = wall_clock_seconds() - load_start;
+    return entry->loaded ? 0 : -1;
+}
+
+// Solve step of a batch; always runs on the main thread
+static void batch_solve(void* user, size_t index, ProblemData* data, int loaded) {
+    BatchRun* run = user;
+    BatchEntry* entry = &run->entries[index];
+    if (loaded) {
+        double solve_start = wall_clock_seconds();
+        solution_buffers(&entry->job, data, &entry->result);
+        if (solve_presolved(&entry->job, data, run->settings, &entry->result, 0) != CUOPT_SUCCESS) {
+            run->failures++;
+        }
+        entry->solve_seconds = wall_clock_seconds() - solve_start;
+        queue_solution(&entry->job, entry->filename, &entry->result, data);
+        free_problem_data(data);
+    } else {
+        run->failures++;
+    }
+    job_context_flush(&entry->job, stdout);
+    job_context_destroy(&entry->job);
+}
+
+// Function to solve the problems held for a pack as one block-diagonal
+// problem and split the solution back out. One infeasible or unbounded
+// block decides the status of the whole pack, so unless the pack is solved
+// to optimality every problem is solved on its own instead.
+static void batch_solve_pack(BatchRun* run, const size_t* indices, ProblemData* problems,
+                             size_t count) {
+    if (count == 1) {
+        batch_solve(run, indices[0], &problems[0], 1);
+        return;
+    }
+    JobContext* ctx = run->ctx;
+    double pack_start = wall_clock_seconds();
+    
+    log_timestamp(ctx, "PACK_BUILD_START");
+    Timer build_timer;
+    start_timer(ctx, &build_timer);
+    
+    ProblemPack pack;
+    int built = problem_pack_build(ctx, problems, count, &pack) == 0;
+    
+    double build_time = end_timer(ctx, &build_timer);
+    log_timestamp(ctx, "PACK_BUILD_END");
+    log_phase_duration(ctx, "PACK_BUILD", build_time);
+    
+    SolveResult result;
+    memset(&result, 0, sizeof(SolveResult));
+    int solved = 0;
+    if (built) {
+        // The primal is needed for the blocks' objectives in any case
+        solution_buffers(ctx, &pack.data, &result);
+        if (!result.primal_solution) {
+            size_t n = pack.data.num_variables > 0 ? (size_t)pack.data.num_variables : 1;
+            result.primal_solution = malloc(n * sizeof(cuopt_float_t));
+        }
+        solved = result.primal_solution &&
+                 solve_problem(ctx, &pack.data, run->settings, &result, 0) == CUOPT_SUCCESS &&
+                 result.termination_status == CUOPT_TERIMINATION_STATUS_OPTIMAL;
+    }
+    if (!solved) {
+        printf("Pack of %zu problems was not solved to optimality, solving them one by one\n",
+               count);
+        free_solution_buffers(&result);
+        if (built) {
+            problem_pack_free(&pack);
+        }
+        for (size_t i = 0; i < count; i++) {
+            batch_solve(run, indices[i], &problems[i], 1);
+        }
+        return;
+    }
+    
+    // The pack's wall time is shared evenly between its problems
+    double per_problem = (wall_clock_seconds() - pack_start) / count;
+    for (size_t i = 0; i < count; i++) {
+        BatchEntry* entry = &run->entries[indices[i]];
+        entry->result.status = CUOPT_SUCCESS;
+        entry->result.termination_status = result.termination_status;
+        entry->result.solve_time = result.solve_time;
+        entry->result.objective_value = problem_pack_block_objective(&pack, i, &problems[i],
+                                                                     result.primal_solution);
+        entry->solve_seconds = per_problem;
+        solution_buffers(ctx, &problems[i], &entry->result);
+        if (entry->result.primal_solution) {
+            memcpy(entry->result.primal_solution, result.primal_solution + pack.variable_offsets[i],
+                   (size_t)problems[i].num_variables * sizeof(cuopt_float_t));
+        }
+        if (entry->result.dual_solution && result.has_duals) {
+            problem_pack_block_duals(&pack, i, &problems[i], result.dual_solution,
+                                     result.reduced_costs, entry->result.dual_solution,
+                                     entry->result.reduced_costs);
+            entry->result.has_duals = 1;
+        }
+        queue_solution(ctx, entry->filename, &entry->result, &problems[i]);
+        free_problem_data(&problems[i]);
+        job_context_flush(&entry->job, stdout);
+        job_context_destroy(&entry->job);
+    }
+    run->packs++;
+    run->packed += count;
+    free_solution_buffers(&result);
+    problem_pack_free(&pack);
+}
+
+// Batch loop with --pack: LPs are held back until the next one would push
+// the pack over its nnz or variable budget, then solved together. MIPs,
+// problems over the budget on their own and failed loads are handled alone,
+// after the held problems, so results stay in input order.
+static int run_packed_batch(BatchRun* run) {
+    size_t count = run->inputs->count;
+    size_t* indices = malloc((count > 0 ? count : 1) * sizeof(size_t));
+    ProblemData* held = calloc(count > 0 ? count : 1, sizeof(ProblemData));
+    if (!indices || !held) {
+        printf("Error: Memory allocation failed\n");
+        free(indices);
+        free(held);
+        return -1;
+    }
+    
+    size_t num_held = 0;
+    int64_t held_nnz = 0, held_variables = 0;
+    for (size_t i = 0; i < count; i++) {
+        ProblemData data;
+        memset(&data, 0, sizeof(ProblemData));
+        int loaded = batch_load(run, i, &data) == 0;
+        int packable = loaded && problem_pack_eligible(&data) && data.nnz <= pack_max_nnz &&
+                       data.num_variables <= pack_max_variables;
+        if (num_held > 0 && (!packable || held_nnz + data.nnz > pack_max_nnz ||
+                             held_variables + data.num_variables > pack_max_variables)) {
+            batch_solve_pack(run, indices, held, num_held);
+            num_held = 0;
+            held_nnz = 0;
+            held_variables = 0;
+        }
+        if (!packable) {
+            batch_solve(run, i, &data, loaded);
+            continue;
+        }
+        indices[num_held] = i;
+        held[num_held++] = data;
+        held_nnz += data.nnz;
+        held_variables += data.num_variables;
+    }
+    if (num_held > 0) {
+        batch_solve_pack(run, indices, held, num_held);
+    }
+    
+    free(indices);
+    free(held);
+    return 0;
+}
+
+// Worker step of a concurrent batch: load and solve one problem. Every job
+// creates its own solver settings, so no cuOpt handle is shared between
+// threads.
+static void batch_run_job(void* user, size_t index) {
+    BatchRun* run = user;
+    BatchEntry* entry = &run->entries[index];
+    ProblemData data;
+    memset(&data, 0, sizeof(ProblemData));
+    if (batch_load(run, index, &data) != 0) {
+        return;
+    }
+    
+    double solve_start = wall_clock_seconds();
+    cuOptSolverSettings settings = NULL;
+    entry->result.status = create_solver_settings(&entry->job, &settings);
+    if (entry->result.status == CUOPT_SUCCESS) {
+        solution_buffers(&entry->job, &data, &entry->result);
+        solve_presolved(&entry->job, &data, settings, &entry->result, 0);
+    }
+    cuOptDestroySolverSettings(&settings);
+    entry->solve_seconds = wall_clock_seconds() - solve_start;
+    queue_solution(&entry->job, entry->filename, &entry->result, &data);
+    free_problem_data(&data);
+}
+
+// Completion step of a concurrent batch; runs in input order, one problem
+// at a time, so captured output is printed in one piece
+static void batch_report_job(void* user, size_t index) {
+    BatchRun* run = user;
+    BatchEntry* entry = &run->entries[index];
+    if (!entry->loaded || entry->result.status != CUOPT_SUCCESS) {
+        run->failures++;
+    }
+    job_context_flush(&entry->job, stdout);
+    job_context_destroy(&entry->job);
+}
+
+// Function to print the concurrency and per-problem latency of a batch
+// run with --jobs
+static void print_scheduler_stats(JobContext* ctx, const SchedulerStats* stats) {
+    printf("\nJobs: %d worker(s), at most %zu problem(s) in flight\n",
+           stats->workers, stats->max_running);
+    printf("  latency per problem (load + solve): mean %.3f s, p50 %.3f s, p90 %.3f s, "
+           "p99 %.3f s, max %.3f s\n", stats->latency_mean, stats->latency_p50,
+           stats->latency_p90, stats->latency_p99, stats->latency_max);
+    
+    log_phase_duration(ctx, "JOB_LATENCY_MEAN", stats->latency_mean);
+    log_phase_duration(ctx, "JOB_LATENCY_P50", stats->latency_p50);
+    log_phase_duration(ctx, "JOB_LATENCY_P90", stats->latency_p90);
+    log_phase_duration(ctx, "JOB_LATENCY_P99", stats->latency_p99);
+}
+
+// Function to print where a pipelined batch spent its time
+static void print_pipeline_stats(JobContext* ctx, const PipelineStats* stats) {
+    // Time both stages were busy at once: the stage totals minus the wall
+    // time they had to fit in (exact for a single loader)
+    double overlap = stats->load_busy + stats->solve_busy - stats->elapsed;
+    if (overlap < 0.0) {
+        overlap = 0.0;
+    }
+    printf("\nPipeline: %d loader(s), prefetch %d, at most %zu problem(s) resident\n",
+           parse_workers, prefetch_depth, stats->max_resident);
+    printf("  load:  busy %.3f s, stalled %.3f s waiting for a free slot\n",
+           stats->load_busy, stats->load_stall);
+    printf("  solve: busy %.3f s, stalled %.3f s waiting for a loaded problem\n",
+           stats->solve_busy, stats->solve_stall);
+    printf("  overlap of load and solve: %.3f s\n", overlap);
+    
+    log_phase_duration(ctx, "PIPELINE_LOAD_BUSY", stats->load_busy);
+    log_phase_duration(ctx, "PIPELINE_LOAD_STALL", stats->load_stall);
+    log_phase_duration(ctx, "PIPELINE_SOLVE_BUSY", stats->solve_busy);
+    log_phase_duration(ctx, "PIPELINE_SOLVE_STALL", stats->solve_stall);
+    log_phase_duration(ctx, "PIPELINE_OVERLAP", overlap);
+}
+
+// Function to load and solve every input with one set of solver settings,
+// in turn or, with --prefetch, overlapping loads with solves. With --jobs,
+// several problems are loaded and solved at once, each with its own
+// settings. With --pack, LPs are solved in block-diagonal packs.
+static int run_batch(JobContext* ctx, const InputList* inputs, cuOptSolverSettings settings) {
+    BatchRun run;
+    memset(&run, 0, sizeof(BatchRun));
+    run.ctx = ctx;
+    run.inputs = inputs;
+    run.settings = settings;
+    run.entries = calloc(inputs->count, sizeof(BatchEntry));
+    if (!run.entries) {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+    for (size_t i = 0; i < inputs->count; i++) {
+        run.entries[i].filename = inputs->paths[i];
+    }
+    
+    log_timestamp(ctx, "BATCH_START");
+    double batch_start = wall_clock_seconds();
+    
+    PipelineStats stats;
+    SchedulerStats scheduler_stats;
+    int pipelined = prefetch_depth > 0;
+    int concurrent = solve_jobs > 1;
+    run.capture = pipelined || concurrent || pack_problems;
+    if (pack_problems) {
+        if (run_packed_batch(&run) != 0) {
+            free(run.entries);
+            return -1;
+        }
+    } else if (concurrent) {
+        if (scheduler_run(inputs->count, solve_jobs, batch_run_job, batch_report_job, &run,
+                          &scheduler_stats) != 0) {
+            free(run.entries);
+            return -1;
+        }
+    } else if (pipelined) {
+        if (pipeline_run(inputs->count, parse_workers, prefetch_depth, batch_load, batch_solve,
+                         &run, &stats) != 0) {
+            free(run.entries);
+            return -1;
+        }
+    } else {
+        for (size_t i = 0; i < inputs->count; i++) {
+            ProblemData data;
+            memset(&data, 0, sizeof(ProblemData));
+            int loaded = batch_load(&run, i, &data) == 0;
+            batch_solve(&run, i, &data, loaded);
+        }
+    }
+    
+    double batch_time = wall_clock_seconds() - batch_start;
+    log_timestamp(ctx, "BATCH_END");
+    log_phase_duration(ctx, "BATCH_TOTAL", batch_time);
+    
+    print_batch_summary(run.entries, inputs->count, batch_time);
+    if (pack_problems) {
+        printf("\nPacking: %zu problem(s) solved in %zu block-diagonal solve(s), %zu on their own\n",
+               run.packed, run.packs, inputs->count - run.packed);
+    } else if (concurrent) {
+        print_scheduler_stats(ctx, &scheduler_stats);
+    } else if (pipelined) {
+        print_pipeline_stats(ctx, &stats);
+    }
+    free(run.entries);
+    return run.failures == 0 ? 0 : -1;
+}
+
+// Append a float as a JSON value; infinities and NaN become null
+static void append_json_float(ServiceBuffer* response, cuopt_float_t value) {
+    if (isfinite(value)) {
+        service_buffer_printf(response, "%.17g", (double)value);
+    } else {
+        service_buffer_printf(response, "null");
+    }
+}
+
+// What the daemons need to run a request: the options every request starts
+// from and the shared solver settings
+typedef struct {
+    const JobContext* base;
+    cuOptSolverSettings settings;
+} ServeState;
+
+// Function to answer one --serve request: parse the JSON body, solve it with
+// the shared solver settings (after --presolve, block by block with
+// --decompose, as a one-shot run would) and report the result and primal
+// solution
+static int serve_request(void* user, const char* request, size_t length, ServiceBuffer* response) {
+    ServeState* state = user;
+    JobContext job;
+    job_context_init_from(&job, state->base);
+    ProblemData data;
+    memset(&data, 0, sizeof(ProblemData));
+    
+    double parse_start = wall_clock_seconds();
+    if (parse_cuopt_json_buffer(&job, request, length, &data) != 0) {
+        free_problem_data(&data);
+        job_context_destroy(&job);
+        service_buffer_printf(response, "\"ok\":false,\"error\":\"invalid problem\"");
+        return -1;
+    }
+    double parse_seconds = wall_clock_seconds() - parse_start;
+    if (check_problem_structure(&job, &data) != 0) {
+        free_problem_data(&data);
+        job_context_destroy(&job);
+        service_buffer_printf(response, "\"ok\":false,\"error\":\"invalid problem\"");
+        return -1;
+    }
+    
+    SolveResult result;
+    memset(&result, 0, sizeof(SolveResult));
+    if (data.num_variables > 0) {
+        result.primal_solution = job_scratch_alloc(&job, data.num_variables * sizeof(cuopt_float_t));
+        if (!result.primal_solution) {
+            free_problem_data(&data);
+            job_context_destroy(&job);
+            service_buffer_printf(response, "\"ok\":false,\"error\":\"out of memory\"");
+            return -1;
+        }
+    }
+    
+    double solve_start = wall_clock_seconds();
+    cuopt_int_t status = solve_presolved(&job, &data, state->settings, &result, 0);
+    double solve_seconds = wall_clock_seconds() - solve_start;
+    
+    if (status != CUOPT_SUCCESS) {
+        service_buffer_printf(response, "\"ok\":false,\"status\":%d,\"error\":\"solve failed\","
+                              "\"parse_time\":%.6f,\"solve_time\":%.6f",
+                              (int)status, parse_seconds, solve_seconds);
+    } else {
+        service_buffer_printf(response, "\"ok\":true,\"status\":%d,\"termination_status\":%d,"
+                              "\"termination\":\"%s\",\"objective\":", (int)status,
+                              (int)result.termination_status,
+                              termination_status_to_string(result.termination_status));
+        append_json_float(response, result.objective_value);
+        service_buffer_printf(response, ",\"solver_time\":%.6f,\"parse_time\":%.6f,"
+                              "\"solve_time\":%.6f,\"primal\":[",
+                              (double)result.solve_time, parse_seconds, solve_seconds);
+        for (cuopt_int_t j = 0; j < data.num_variables; j++) {
+            if (j > 0) {
+                service_buffer_printf(response, ",");
+            }
+            append_json_float(response, result.primal_solution[j]);
+        }
+        service_buffer_printf(response, "]");
+    }
+    
+    free_problem_data(&data);
+    job_context_destroy(&job);
+    return status == CUOPT_SUCCESS ? 0 : -1;
+}
+
+// Function to solve a problem handed over through shared memory, with the
+// same host passes as a one-shot run; the arrays and the primal solution
+// buffer live in the client's segment
+static void serve_shm_request(void* user, const ProblemData* data, cuopt_float_t* primal,
+                              ShmResult* result) {
+    ServeState* state = user;
+    JobContext job;
+    job_context_init_from(&job, state->base);
+    SolveResult solve_result;
+    memset(&solve_result, 0, sizeof(SolveResult));
+    solve_result.primal_solution = primal;
+    
+    if (check_problem_structure(&job, data) != 0) {
+        result->status = CUOPT_INVALID_ARGUMENT;
+    } else {
+        result->status = solve_presolved(&job, data, state->settings, &solve_result, 0);
+    }
+    job_context_destroy(&job);
+    result->termination_status = solve_result.termination_status;
+    result->objective_value = solve_result.objective_value;
+    result->solver_time = solve_result.solve_time;
+}
+
+// Function to load a problem, copy it into a shared-memory segment and have
+// the solver serving on `service` solve it
+static int run_shm_client(JobContext* ctx, const char* service, const char* filename) {
+    ProblemData data;
+    memset(&data, 0, sizeof(ProblemData));
+    if (load_problem(ctx, filename, &data) != 0) {
+        return -1;
+    }
+    
+    log_timestamp(ctx, "SHM_COPY_START");
+    Timer copy_timer;
+    start_timer(ctx, &copy_timer);
+    
+    const struct {
+        ProblemSectionId id;
+        const void* source;
+        size_t bytes;
+    } arrays[] = {
+        { PROBLEM_SECTION_ROW_OFFSETS, data.row_offsets,
+          (data.num_constraints + 1) * sizeof(cuopt_int_t) },
+        { PROBLEM_SECTION_COLUMN_INDICES, data.column_indices, data.nnz * sizeof(cuopt_int_t) },
+        { PROBLEM_SECTION_MATRIX_VALUES, data.matrix_values, data.nnz * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_OBJECTIVE_COEFFICIENTS, data.objective_coefficients,
+          data.num_variables * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_CONSTRAINT_LOWER_BOUNDS, data.constraint_lower_bounds,
+          data.num_constraints * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_CONSTRAINT_UPPER_BOUNDS, data.constraint_upper_bounds,
+          data.num_constraints * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_VARIABLE_LOWER_BOUNDS, data.variable_lower_bounds,
+          data.num_variables * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_VARIABLE_UPPER_BOUNDS, data.variable_upper_bounds,
+          data.num_variables * sizeof(cuopt_float_t) },
+        { PROBLEM_SECTION_VARIABLE_TYPES, data.variable_types, data.num_variables * sizeof(char) }
+    };
+    const size_t num_arrays = sizeof(arrays) / sizeof(arrays[0]);
+    unsigned absent = 0;
+    for (size_t i = 0; i < num_arrays; i++) {
+        if (!arrays[i].source) {
+            absent |= 1u << arrays[i].id;
+        }
+    }
+    
+    ShmProblem shm;
+    if (shm_problem_create(&shm, data.num_constraints, data.num_variables, data.nnz, absent) != 0) {
+        free_problem_data(&data);
+        return -1;
+    }
+    void* targets[] = {
+        shm.problem.row_offsets, shm.problem.column_indices, shm.problem.matrix_values,
+        shm.problem.objective_coefficients, shm.problem.constraint_lower_bounds,
+        shm.problem.constraint_upper_bounds, shm.problem.variable_lower_bounds,
+        shm.problem.variable_upper_bounds, shm.problem.variable_types
+    };
+    size_t copied = 0;
+    for (size_t i = 0; i < num_arrays; i++) {
+        if (arrays[i].source && arrays[i].bytes > 0) {
+            memcpy(targets[i], arrays[i].source, arrays[i].bytes);
+            copied += arrays[i].bytes;
+        }
+    }
+    shm.problem.objective_sense = data.objective_sense;
+    shm.problem.objective_offset = data.objective_offset;
+    shm.problem.objective_scaling_factor = data.objective_scaling_factor;
+    free_problem_data(&data);
+    
+    double copy_time = end_timer(ctx, &copy_timer);
+    log_timestamp(ctx, "SHM_COPY_END");
+    log_phase_duration(ctx, "SHM_COPY", copy_time);
+    log_phase_throughput(ctx, "SHM_COPY", copied, copy_time);
+    
+    log_timestamp(ctx, "SHM_REQUEST_START");
+    Timer request_timer;
+    start_timer(ctx, &request_timer);
+    
+    ShmResult result;
+    int status = shm_problem_submit(service, &shm, &result);
+    
+    double request_time = end_timer(ctx, &request_timer);
+    log_timestamp(ctx, "SHM_REQUEST_END");
+    log_phase_duration(ctx, "SHM_REQUEST", request_time);
+    
+    if (status == 0 && result.status != CUOPT_SUCCESS) {
+        job_printf(ctx, "Error solving problem: %d\n", result.status);
+        status = -1;
+    } else if (status == 0) {
+        cuopt_int_t num_variables = shm.problem.num_variables;
+        cuopt_int_t shown = num_variables < 20 ? num_variables : 20;
+        job_printf(ctx, "\nResults:\n");
+        job_printf(ctx, "--------\n");
+        job_printf(ctx, "Termination status: %s (%d)\n",
+                   termination_status_to_string(result.termination_status), result.termination_status);
+        job_printf(ctx, "Solve time: %f seconds\n", result.solver_time);
+        job_printf(ctx, "Objective value: %f\n", result.objective_value);
+        job_printf(ctx, "Server time: %f seconds\n", result.handle_seconds);
+        job_printf(ctx, "\nPrimal Solution (showing first %d variables):\n", shown);
+        for (cuopt_int_t i = 0; i < shown; i++) {
+            job_printf(ctx, "x%d = %f\n", i, shm.primal[i]);
+        }
+        if (num_variables > 20) {
+            job_printf(ctx, "... (showing only first 20 of %d variables)\n", num_variables);
+        }
+    }
+    shm_problem_destroy(&shm);
+    return status;
+}
+
+// Print command-line usage
+static void print_usage(const char* program) {
+    printf("Usage: %s [--timing|-t] [--trace <file>] [--mps-output <file>] [--parser=stream|index|cjson]\n"
+           "       [--threads N] [--convert-to-bin <file>] [--solution-out <file>]\n"
+           "       [--parse-cache DIR [--parse-cache-max-mb N]]\n"
+           "       [--presolve] [--propagate] [--scale geomean|ruiz]\n"
+           "       [--decompose [--block-jobs N]]\n"
+           "       [--manifest <file>] [--prefetch K [--parse-workers N] | --jobs N | --pack] <input>...\n"
+           "       %s [options] --serve <socket> [--queue-depth N]\n"
+           "       %s --client <socket> <input>\n"
+           "       %s [options] --serve-shm <name>\n"
+           "       %s [options] --client-shm <name> <input>\n", program, program, program, program, program);
+    printf("\nOptions:\n");
+    printf("  --timing, -t           Enable detailed performance timing output\n");
+    printf("  --trace <file>         Write the timed phases to <file> as Chrome trace-event\n");
+    printf("                         JSON (for Perfetto or chrome://tracing) at exit\n");
+    printf("  --mps-output <file>    Write problem to MPS file\n");
+    printf("  --parser=<kind>        JSON front end: stream (default), index (SIMD structural\n");
+    printf("                         index + walk) or cjson (cJSON DOM)\n");
+    printf("  --threads N            Threads for parsing large numeric arrays (default 1,\n");
+    printf("                         0 = one per CPU)\n");
+    printf("  --convert-to-bin <file>  Write the problem as a .cuopt.bin file and exit\n");
+    printf("                         without solving\n");
+    printf("  --solution-out <file>  Write the solution to <file>: .json, .bin (raw doubles)\n");
+    printf("                         or CSV for any other name, gzip-compressed if it ends\n");
+    printf("                         in .gz; a '*' stands for the input's name, as needed\n");
+    printf("                         with several inputs. Includes reduced costs and\n");
+    printf("                         duals for LPs. Written in the background\n");
+    printf("  --parse-cache DIR      Reuse parsed problems for byte-identical JSON inputs,\n");
+    printf("                         stored as .cuopt.bin files in DIR\n");
+    printf("  --parse-cache-max-mb N Evict least recently used cache entries beyond N MB\n");
+    printf("                         (default 4096)\n");
+    printf("  --manifest <file>      Add the inputs listed in <file>, one path per line\n");
+    printf("  --prefetch K           Batch mode: load up to K problems ahead on loader threads\n");
+    printf("                         while the current one is solved\n");
+    printf("  --parse-workers N      Loader threads used with --prefetch (default 1)\n");
+    printf("  --jobs N               Batch mode: load and solve up to N problems at once,\n");
+    printf("                         each with its own solver settings\n");
+    printf("  --pack                 Batch mode: solve LPs together as one block-diagonal\n");
+    printf("                         problem per pack (MIPs are solved on their own)\n");
+    printf("  --pack-max-nnz N       Nonzeros allowed in one pack (default 1000000)\n");
+    printf("  --pack-max-vars N      Variables allowed in one pack (default 100000)\n");
+    printf("  --presolve             Remove empty, singleton, free and parallel rows and\n");
+    printf("                         fixed and duplicate variables before solving\n");
+    printf("  --propagate            Tighten the variable bounds of MIPs by propagating\n");
+    printf("                         row activities before solving\n");
+    printf("  --scale <method>       Equilibrate the constraint matrix before solving:\n");
+    printf("                         geomean, ruiz or none (default)\n");
+    printf("  --decompose            Split problems into independent blocks (connected\n");
+    printf("                         components of the constraint matrix) and solve each\n");
+    printf("                         block on its own\n");
+    printf("  --block-jobs N         Blocks of one problem solved at once (default 1)\n");
+    printf("  --serve <socket>       Run as a daemon answering JSON problems sent to the\n");
+    printf("                         Unix socket, one solve at a time\n");
+    printf("  --queue-depth N        Requests a daemon keeps receiving or waiting before\n");
+    printf("                         rejecting new ones (default 8)\n");
+    printf("  --client <socket>      Send <input> to a daemon and print its JSON events\n");
+    printf("  --serve-shm <name>     Run as a daemon solving problems handed over in POSIX\n");
+    printf("                         shared memory, signalled through /<name>\n");
+    printf("  --client-shm <name>    Copy <input> into shared memory and have the daemon\n");
+    printf("                         serving on <name> solve it\n");
+    printf("\nEach input is a cuOpt JSON file, a .cuopt.bin file or a directory of them.\n");
+    printf("With more than one input, a directory or a manifest, every problem is solved\n");
+    printf("in turn with the same solver settings and a result table is printed.\n");
+    printf("\nThis program reads a cuOpt JSON file and solves it using the cuOpt C API.\n");
+    printf("The JSON file should contain LP or MIP problem data in cuOpt format.\n");
+    printf("Binary problem files written with --convert-to-bin are detected by their\n");
+    printf("header and memory-mapped without parsing.\n");
+}
+
 int main(int argc, char* argv[]) {
-    char* json_file = NULL;
+    // Options of the job(s) this run executes
+    JobContext main_job;
+    job_context_init(&main_job);
+    JobContext* ctx = &main_job;
+    InputList inputs;
+    memset(&inputs, 0, sizeof(InputList));
+    int batch_mode = 0;
+    const char* serve_socket = NULL;
+    const char* client_socket = NULL;
+    const char* serve_shm = NULL;
+    const char* client_shm = NULL;
     
     // Parse command-line arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--timing") == 0 || strcmp(argv[i], "-t") == 0) {
-            timing_enabled = 1;
+            ctx->timing_enabled = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --trace requires a filename\n");
+                return 1;
+            }
+            if (trace_open(argv[++i]) != 0) {
+                input_list_free(&inputs);
+                return 1;
+            }
         } else if (strcmp(argv[i], "--mps-output") == 0) {
             if (i + 1 >= argc) {
                 printf("Error: --mps-output requires a filename\n");
                 return 1;
             }
-            mps_output_file = argv[++i];
+            ctx->mps_output_file = argv[++i];
+        } else if (strncmp(argv[i], "--parser=", 9) == 0) {
+            const char* parser = argv[i] + 9;
+            if (strcmp(parser, "stream") == 0) {
+                ctx->parser = JSON_PARSER_STREAM;
+            } else if (strcmp(parser, "index") == 0) {
+                ctx->parser = JSON_PARSER_INDEX;
+            } else if (strcmp(parser, "cjson") == 0) {
+                ctx->parser = JSON_PARSER_CJSON;
+            } else {
+                printf("Error: Unknown parser '%s' (expected stream, index or cjson)\n", parser);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --threads requires a number\n");
+                return 1;
+            }
+            char* end;
+            long threads = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || threads < 0 || threads > 4096) {
+                printf("Error: Invalid thread count '%s'\n", argv[i]);
+                return 1;
+            }
+            num_threads = (int)threads;
+        } else if (strcmp(argv[i], "--convert-to-bin") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --convert-to-bin requires a filename\n");
+                return 1;
+            }
+            convert_output_file = argv[++i];
+        } else if (strcmp(argv[i], "--solution-out") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --solution-out requires a filename\n");
+                return 1;
+            }
+            ctx->solution_output_file = argv[++i];
+        } else if (strcmp(argv[i], "--manifest") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --manifest requires a filename\n");
+                return 1;
+            }
+            if (input_list_add_manifest(&inputs, argv[++i]) != 0) {
+                input_list_free(&inputs);
+                return 1;
+            }
+            batch_mode = 1;
+        } else if (strcmp(argv[i], "--presolve") == 0) {
+            ctx->presolve_enabled = 1;
+        } else if (strcmp(argv[i], "--propagate") == 0) {
+            ctx->propagate_enabled = 1;
+        } else if (strcmp(argv[i], "--scale") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --scale requires a method\n");
+                return 1;
+            }
+            const char* method = argv[++i];
+            if (strcmp(method, "geomean") == 0) {
+                ctx->scaling_method = SCALING_GEOMEAN;
+            } else if (strcmp(method, "ruiz") == 0) {
+                ctx->scaling_method = SCALING_RUIZ;
+            } else if (strcmp(method, "none") == 0) {
+                ctx->scaling_method = SCALING_NONE;
+            } else {
+                printf("Error: Unknown scaling method '%s' (expected geomean, ruiz or none)\n", method);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--decompose") == 0) {
+            ctx->decompose_problems = 1;
+        } else if (strcmp(argv[i], "--prefetch") == 0 || strcmp(argv[i], "--parse-workers") == 0 ||
+                   strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "--block-jobs") == 0) {
+            const char* option = argv[i];
+            if (i + 1 >= argc) {
+                printf("Error: %s requires a number\n", option);
+                return 1;
+            }
+            char* end;
+            long value = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || value < 1 || value > 1024) {
+                printf("Error: Invalid value '%s' for %s\n", argv[i], option);
+                return 1;
+            }
+            if (strcmp(option, "--prefetch") == 0) {
+                prefetch_depth = (int)value;
+            } else if (strcmp(option, "--jobs") == 0) {
+                solve_jobs = (int)value;
+            } else if (strcmp(option, "--block-jobs") == 0) {
+                ctx->block_jobs = (int)value;
+            } else {
+                parse_workers = (int)value;
+            }
+        } else if (strcmp(argv[i], "--pack") == 0) {
+            pack_problems = 1;
+        } else if (strcmp(argv[i], "--pack-max-nnz") == 0 || strcmp(argv[i], "--pack-max-vars") == 0) {
+            const char* option = argv[i];
+            if (i + 1 >= argc) {
+                printf("Error: %s requires a number\n", option);
+                return 1;
+            }
+            char* end;
+            long long value = strtoll(argv[++i], &end, 10);
+            if (*end != '\0' || value < 1 || value > INT32_MAX) {
+                printf("Error: Invalid value '%s' for %s\n", argv[i], option);
+                return 1;
+            }
+            if (strcmp(option, "--pack-max-nnz") == 0) {
+                pack_max_nnz = value;
+            } else {
+                pack_max_variables = value;
+            }
+        } else if (strcmp(argv[i], "--serve") == 0 || strcmp(argv[i], "--client") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: %s requires a socket path\n", argv[i]);
+                return 1;
+            }
+            if (strcmp(argv[i], "--serve") == 0) {
+                serve_socket = argv[++i];
+            } else {
+                client_socket = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--serve-shm") == 0 || strcmp(argv[i], "--client-shm") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: %s requires a shared memory name\n", argv[i]);
+                return 1;
+            }
+            if (strcmp(argv[i], "--serve-shm") == 0) {
+                serve_shm = argv[++i];
+            } else {
+                client_shm = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--queue-depth") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --queue-depth requires a number\n");
+                return 1;
+            }
+            char* end;
+            long depth = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || depth < 1 || depth > 65536) {
+                printf("Error: Invalid queue depth '%s'\n", argv[i]);
+                return 1;
+            }
+            serve_queue_depth = (int)depth;
+        } else if (strcmp(argv[i], "--parse-cache") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --parse-cache requires a directory\n");
+                return 1;
+            }
+            parse_cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--parse-cache-max-mb") == 0) {
+            if (i + 1 >= argc) {
+                printf("Error: --parse-cache-max-mb requires a number\n");
+                return 1;
+            }
+            char* end;
+            long long megabytes = strtoll(argv[++i], &end, 10);
+            if (*end != '\0' || megabytes < 0) {
+                printf("Error: Invalid cache size '%s'\n", argv[i]);
+                return 1;
+            }
+            parse_cache_max_bytes = (uint64_t)megabytes << 20;
         } else if (argv[i][0] == '-') {
             printf("Error: Unknown option '%s'\n", argv[i]);
-            printf("Usage: %s [--timing|-t] [--mps-output <file>] <cuopt_json_file>\n", argv[0]);
-            printf("\nOptions:\n");
-            printf("  --timing, -t           Enable detailed performance timing output\n");
-            printf("  --mps-output <file>    Write problem to MPS file\n");
-            printf("\nThis program reads a cuOpt JSON file and solves it using the cuOpt C API.\n");
-            printf("The JSON file should contain LP or MIP problem data in cuOpt format.\n");
+            print_usage(argv[0]);
             return 1;
-        } else if (json_file == NULL) {
-            json_file = argv[i];
         } else {
-            printf("Error: Multiple JSON files specified\n");
-            printf("Usage: %s [--timing|-t] [--mps-output <file>] <cuopt_json_file>\n", argv[0]);
-            return 1;
+            batch_mode |= input_list_is_directory(argv[i]);
+            if (input_list_add(&inputs, argv[i]) != 0) {
+                input_list_free(&inputs);
+                return 1;
+            }
         }
     }
     
-    if (json_file == NULL) {
-        printf("Usage: %s [--timing|-t] [--mps-output <file>] <cuopt_json_file>\n", argv[0]);
-        printf("\nOptions:\n");
-        printf("  --timing, -t           Enable detailed performance timing output\n");
-        printf("  --mps-output <file>    Write problem to MPS file\n");
-        printf("\nThis program reads a cuOpt JSON file and solves it using the cuOpt C API.\n");
-        printf("The JSON file should contain LP or MIP problem data in cuOpt format.\n");
+    batch_mode |= inputs.count > 1;
+    if (!!serve_socket + !!client_socket + !!serve_shm + !!client_shm > 1) {
+        printf("Error: --serve, --client, --serve-shm and --client-shm are exclusive\n");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if ((client_socket || client_shm) &&
+        (inputs.count != 1 || batch_mode || convert_output_file || ctx->solution_output_file)) {
+        printf("Error: %s sends exactly one problem file\n", client_socket ? "--client" : "--client-shm");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if (client_socket) {
+        int client_status = service_client(client_socket, inputs.paths[0]);
+        input_list_free(&inputs);
+        return client_status == 0 ? 0 : 1;
+    }
+    int serving = serve_socket || serve_shm;
+    if (serving &&
+        (inputs.count > 0 || batch_mode || convert_output_file || ctx->solution_output_file)) {
+        printf("Error: %s takes its problems from clients, not the command line\n",
+               serve_socket ? "--serve" : "--serve-shm");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if (inputs.count == 0 && !serving) {
+        if (batch_mode) {
+            printf("Error: No problem files found\n");
+        } else {
+            print_usage(argv[0]);
+        }
+        input_list_free(&inputs);
+        return 1;
+    }
+    if (batch_mode && (convert_output_file || ctx->mps_output_file)) {
+        printf("Error: --convert-to-bin and --mps-output take a single input\n");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if (batch_mode && ctx->solution_output_file && !strchr(ctx->solution_output_file, '*')) {
+        printf("Error: With several inputs, --solution-out needs a '*' standing for each\n"
+               "       problem's name, e.g. --solution-out 'out/*.csv'\n");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if (ctx->decompose_problems && ctx->mps_output_file) {
+        printf("Error: --mps-output writes the whole problem and cannot be combined with --decompose\n");
+        input_list_free(&inputs);
+        return 1;
+    }
+    if ((solve_jobs > 1) + (prefetch_depth > 0) + pack_problems > 1) {
+        printf("Error: --jobs, --prefetch and --pack cannot be combined\n");
+        input_list_free(&inputs);
         return 1;
     }
     
-    log_timestamp("PROGRAM_START");
+    log_timestamp(ctx, "PROGRAM_START");
     Timer main_timer;
-    start_timer(&main_timer);
+    start_timer(ctx, &main_timer);
     
-    log_timestamp("INITIALIZATION_START");
+    log_timestamp(ctx, "INITIALIZATION_START");
     Timer init_timer;
-    start_timer(&init_timer);
+    start_timer(ctx, &init_timer);
     
     ProblemData data;
     memset(&data, 0, sizeof(ProblemData));
     
+    if (num_threads != 1) {
+        ctx->pool = thread_pool_create(num_threads);
+    }
+    if (ctx->solution_output_file && !convert_output_file) {
+        ctx->solution_writer = async_writer_create(ctx);
+        if (!ctx->solution_writer) {
+            thread_pool_destroy(ctx->pool);
+            input_list_free(&inputs);
+            return 1;
+        }
+    }
+    
     printf("cuOpt JSON Solver\n");
     printf("=================\n");
-    printf("Reading JSON file: %s\n", json_file);
     
-    double init_time = end_timer(&init_timer);
-    log_timestamp("INITIALIZATION_END");
-    log_phase_duration("INITIALIZATION", init_time);
+    double init_time = end_timer(ctx, &init_timer);
+    log_timestamp(ctx, "INITIALIZATION_END");
+    log_phase_duration(ctx, "INITIALIZATION", init_time);
     
-    // Parse the JSON file
-    if (parse_cuopt_json(json_file, &data) != 0) {
-        printf("Failed to parse JSON file\n");
-        free_problem_data(&data);
+    if (client_shm) {
+        int client_status = run_shm_client(ctx, client_shm, inputs.paths[0]);
+        thread_pool_destroy(ctx->pool);
+        input_list_free(&inputs);
+        
+        double total_program_time = end_timer(ctx, &main_timer);
+        log_timestamp(ctx, "PROGRAM_END");
+        log_phase_duration(ctx, "PROGRAM_TOTAL", total_program_time);
+        return client_status == 0 ? 0 : 1;
+    }
+    
+    // Daemon mode: one solver settings object for every request
+    if (serving) {
+        cuOptSolverSettings settings = NULL;
+        int serve_status = -1;
+        if (create_solver_settings(ctx, &settings) == CUOPT_SUCCESS) {
+            ServeState state = { ctx, settings };
+            serve_status = serve_socket ?
+                service_run(serve_socket, serve_queue_depth, serve_request, &state) :
+                shm_serve(serve_shm, serve_shm_request, &state);
+        }
+        cuOptDestroySolverSettings(&settings);
+        thread_pool_destroy(ctx->pool);
+        
+        double total_program_time = end_timer(ctx, &main_timer);
+        log_timestamp(ctx, "PROGRAM_END");
+        log_phase_duration(ctx, "PROGRAM_TOTAL", total_program_time);
+        return serve_status == 0 ? 0 : 1;
+    }
+    
+    // Batch mode: one solver settings object for every problem, or one per
+    // problem when they are solved concurrently
+    if (batch_mode) {
+        cuOptSolverSettings settings = NULL;
+        int batch_status = -1;
+        if (solve_jobs > 1 || create_solver_settings(ctx, &settings) == CUOPT_SUCCESS) {
+            batch_status = run_batch(ctx, &inputs, settings);
+        }
+        cuOptDestroySolverSettings(&settings);
+        if (finish_solution_writer(ctx) != 0) {
+            batch_status = -1;
+        }
+        thread_pool_destroy(ctx->pool);
+        input_list_free(&inputs);
+        
+        double total_program_time = end_timer(ctx, &main_timer);
+        log_timestamp(ctx, "PROGRAM_END");
+        log_phase_duration(ctx, "PROGRAM_TOTAL", total_program_time);
+        return batch_status == 0 ? 0 : 1;
+    }
+    
+    const char* json_file = inputs.paths[0];
+    if (load_problem(ctx, json_file, &data) != 0) {
+        thread_pool_destroy(ctx->pool);
+        input_list_free(&inputs);
         return 1;
     }
     
-    printf("Successfully parsed JSON file\n");
+    if (convert_output_file) {
+        log_timestamp(ctx, "BINARY_WRITE_START");
+        Timer write_timer;
+        start_timer(ctx, &write_timer);
+        
+        int write_status = problem_binary_write(ctx, convert_output_file, &data);
+        
+        double write_time = end_timer(ctx, &write_timer);
+        log_timestamp(ctx, "BINARY_WRITE_END");
+        log_phase_duration(ctx, "BINARY_WRITE", write_time);
+        
+        if (write_status == 0) {
+            printf("Wrote binary problem file: %s\n", convert_output_file);
+            if (data.variable_names || data.row_names) {
+                printf("Note: variable and row names are not stored in binary problem files\n");
+            }
+        }
+        free_problem_data(&data);
+        thread_pool_destroy(ctx->pool);
+        input_list_free(&inputs);
+        return write_status == 0 ? 0 : 1;
+    }
     
     // Solve the problem
-    cuopt_int_t solve_status = solve_problem(&data);
+    cuOptSolverSettings settings = NULL;
+    SolveResult result;
+    memset(&result, 0, sizeof(SolveResult));
+    cuopt_int_t solve_status = create_solver_settings(ctx, &settings);
+    if (solve_status == CUOPT_SUCCESS) {
+        solution_buffers(ctx, &data, &result);
+        solve_status = solve_presolved(ctx, &data, settings, &result, SOLVE_PRINT_ALL);
+    }
+    cuOptDestroySolverSettings(&settings);
+    queue_solution(ctx, json_file, &result, &data);
     
-    // Clean up
-    log_timestamp("MAIN_CLEANUP_START");
+    // Clean up, while the solution is written in the background
+    log_timestamp(ctx, "MAIN_CLEANUP_START");
     Timer main_cleanup_timer;
-    start_timer(&main_cleanup_timer);
+    start_timer(ctx, &main_cleanup_timer);
     
     free_problem_data(&data);
+    if (finish_solution_writer(ctx) != 0 && solve_status == CUOPT_SUCCESS) {
+        solve_status = -1;
+    }
+    thread_pool_destroy(ctx->pool);
+    input_list_free(&inputs);
+    job_context_destroy(ctx);
     
-    double main_cleanup_time = end_timer(&main_cleanup_timer);
-    log_timestamp("MAIN_CLEANUP_END");
-    log_phase_duration("MAIN_CLEANUP", main_cleanup_time);
+    double main_cleanup_time = end_timer(ctx, &main_cleanup_timer);
+    log_timestamp(ctx, "MAIN_CLEANUP_END");
+    log_phase_duration(ctx, "MAIN_CLEANUP", main_cleanup_time);
     
-    double total_program_time = end_timer(&main_timer);
-    log_timestamp("PROGRAM_END");
-    log_phase_duration("PROGRAM_TOTAL", total_program_time);
+    double total_program_time = end_timer(ctx, &main_timer);
+    log_timestamp(ctx, "PROGRAM_END");
+    log_phase_duration(ctx, "PROGRAM_TOTAL", total_program_time);
     
     if (solve_status == CUOPT_SUCCESS) {
         printf("\nSolver completed successfully!\n");
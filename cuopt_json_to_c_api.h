@@ -0,0 +1,89 @@
+/*
+ * cuOpt JSON Solver - shared declarations
+ *
+ * Types and helpers shared between the JSON front ends and the solver driver
+ * in cuopt_json_to_c_api.c.
+ */
+
+#ifndef CUOPT_JSON_TO_C_API_H
+#define CUOPT_JSON_TO_C_API_H
+
+#include <cuopt/linear_programming/cuopt_c.h>
+#include <stddef.h>
+#include <time.h>
+#include "job_context.h"
+
+typedef struct NameTable NameTable;
+
+// Structure to hold parsed JSON data
+typedef struct {
+    // CSR matrix data
+    cuopt_int_t* row_offsets;
+    cuopt_int_t* column_indices;
+    cuopt_float_t* matrix_values;
+    cuopt_int_t num_constraints;
+    cuopt_int_t num_variables;
+    cuopt_int_t nnz;
+    
+    // Objective data
+    cuopt_float_t* objective_coefficients;
+    cuopt_float_t objective_offset;
+    cuopt_int_t objective_sense;  // CUOPT_MINIMIZE or CUOPT_MAXIMIZE
+    cuopt_float_t objective_scaling_factor;  // scalability_factor; 0 (as left by memset) means 1
+    
+    // Constraint bounds
+    cuopt_float_t* constraint_lower_bounds;
+    cuopt_float_t* constraint_upper_bounds;
+    
+    // Variable bounds
+    cuopt_float_t* variable_lower_bounds;
+    cuopt_float_t* variable_upper_bounds;
+    
+    // Variable types
+    char* variable_types;
+    
+    // variable_names and row_names from the input (see name_table.h);
+    // NULL when the input has none
+    NameTable* variable_names;
+    NameTable* row_names;
+    
+    // Set when the arrays point into a mapped binary problem file instead
+    // of individual heap allocations
+    void* mapping;
+    size_t mapping_size;
+    
+} ProblemData;
+
+void free_problem_data(ProblemData* data);
+
+// Variable bounds cuOpt assumes for a side the input leaves out
+#define DEFAULT_VARIABLE_LOWER_BOUND 0.0
+#define DEFAULT_VARIABLE_UPPER_BOUND CUOPT_INFINITY
+
+// Bounds of variable j, with a missing side at its default
+cuopt_float_t problem_variable_lower_bound(const ProblemData* data, cuopt_int_t j);
+cuopt_float_t problem_variable_upper_bound(const ProblemData* data, cuopt_int_t j);
+
+// Whether a bound is infinite, i.e. at or beyond +/-CUOPT_INFINITY
+int bound_is_infinite(cuopt_float_t value);
+
+// Outcome of one solve, as collected for batch summaries
+typedef struct {
+    cuopt_int_t status;               // CUOPT_SUCCESS or the failing API status
+    cuopt_int_t termination_status;
+    cuopt_float_t objective_value;
+    cuopt_float_t solve_time;         // as reported by the solver
+    cuopt_float_t* primal_solution;   // if set by the caller, receives num_variables values
+    // If set by the caller, receive num_constraints duals and num_variables
+    // reduced costs when the solver reports them (LPs); has_duals says so
+    cuopt_float_t* dual_solution;
+    cuopt_float_t* reduced_costs;
+    int has_duals;
+    cuopt_float_t solution_bound;     // MIPs: the solver's bound on the objective
+    int has_bound;                    // whether solution_bound is set
+} SolveResult;
+
+// Name of a cuOpt termination status, e.g. "Optimal"
+const char* termination_status_to_string(cuopt_int_t termination_status);
+
+#endif // CUOPT_JSON_TO_C_API_H
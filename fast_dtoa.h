@@ -0,0 +1,26 @@
+/*
+ * fast_dtoa.h - Shortest round-trip double to decimal conversion
+ *
+ * Implements the Ryu algorithm: the shortest decimal that still reads back
+ * as the same double is found with 64x128 bit multiplications against
+ * tables of powers of five, without the arbitrary precision arithmetic or
+ * the locale handling of printf. Parsing the output with strtod (or
+ * fast_float_parse) gives back the original value bit for bit, with far
+ * fewer digits than "%.17g" needs.
+ */
+
+#ifndef FAST_DTOA_H
+#define FAST_DTOA_H
+
+// Longest text fast_dtoa writes, e.g. "-0.00012345678901234567"
+#define FAST_DTOA_BUFFER_SIZE 32
+
+// Write the shortest decimal that round-trips to `value` into `out` (at
+// least FAST_DTOA_BUFFER_SIZE bytes, not NUL-terminated) and return its
+// length. Values with a decimal exponent in [-5, 15] are written in fixed
+// notation ("0.25", "1500", "-3"), others in scientific notation without
+// a plus sign ("1e20", "2.5e-7"). Negative zero is written as "-0",
+// non-finite values as "inf", "-inf" and "nan".
+int fast_dtoa(double value, char* out);
+
+#endif // FAST_DTOA_H
@@ -0,0 +1,182 @@
+/*
+ * fast_dtoa_bench.c - Micro-benchmark of fast_dtoa against snprintf
+ *
+ * Generates values shaped like LP/MIP solutions, writes them with both
+ * snprintf("%.17g") (the shortest printf format that always round-trips)
+ * and fast_dtoa, checks that every fast_dtoa string reads back as the same
+ * double and reports the throughput and output size of each.
+ *
+ * Usage: ./fast_dtoa_bench [count]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fast_dtoa.h"
+
+#define DEFAULT_COUNT 2000000
+#define REPEATS 5
+
+typedef struct {
+    const char* name;
+    double* values;
+    size_t count;
+} Dataset;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_random(void) {
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static double random_unit(void) {
+    return (double)(next_random() >> 11) / 9007199254740992.0;
+}
+
+// MIP solutions: mostly zeros and small integers
+static double integer_value(void) {
+    unsigned kind = (unsigned)(next_random() % 100);
+    if (kind < 50) {
+        return 0.0;
+    } else if (kind < 80) {
+        return 1.0;
+    }
+    return (double)(next_random() % 10000);
+}
+
+// LP solutions: zeros, values at simple bounds and full precision vertices
+static double continuous_value(void) {
+    unsigned kind = (unsigned)(next_random() % 100);
+    if (kind < 30) {
+        return 0.0;
+    } else if (kind < 45) {
+        return (double)(next_random() % 100) / 4.0;
+    }
+    double sign = (next_random() & 1) ? -1.0 : 1.0;
+    return sign * pow(10.0, random_unit() * 12.0 - 6.0) * random_unit();
+}
+
+// Any double, as reduced costs and duals of badly scaled models can be
+static double wide_value(void) {
+    double sign = (next_random() & 1) ? -1.0 : 1.0;
+    return sign * pow(10.0, random_unit() * 80.0 - 40.0) * random_unit();
+}
+
+static int build_dataset(Dataset* set, const char* name, size_t count, double (*generate)(void)) {
+    set->name = name;
+    set->values = malloc(count * sizeof(double));
+    set->count = count;
+    if (!set->values) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        set->values[i] = generate();
+    }
+    return 0;
+}
+
+static double elapsed_seconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Best of REPEATS runs of `format` over the dataset into `out`, one value
+// per line; *bytes receives the output size
+static double time_format(const Dataset* set, char* out, size_t* bytes, int use_printf) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        char* p = out;
+        for (size_t i = 0; i < set->count; i++) {
+            if (use_printf) {
+                p += snprintf(p, FAST_DTOA_BUFFER_SIZE, "%.17g", set->values[i]);
+            } else {
+                p += fast_dtoa(set->values[i], p);
+            }
+            *p++ = '\n';
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        *bytes = (size_t)(p - out);
+        double t = elapsed_seconds(start, end);
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+// Read every line of `text` back and compare it with the dataset
+static size_t count_mismatches(const Dataset* set, const char* text) {
+    size_t mismatches = 0;
+    const char* p = text;
+    for (size_t i = 0; i < set->count; i++) {
+        char* end;
+        double value = strtod(p, &end);
+        if (memcmp(&value, &set->values[i], sizeof(double)) != 0) {
+            if (mismatches == 0) {
+                printf("Mismatch: %.17g written as %.*s\n", set->values[i], (int)(end - p), p);
+            }
+            mismatches++;
+        }
+        p = end + 1;
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = DEFAULT_COUNT;
+    if (argc > 1) {
+        count = strtoul(argv[1], NULL, 10);
+        if (count == 0) {
+            printf("Usage: %s [count]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    Dataset sets[3];
+    if (build_dataset(&sets[0], "integer", count, integer_value) != 0 ||
+        build_dataset(&sets[1], "continuous", count, continuous_value) != 0 ||
+        build_dataset(&sets[2], "wide range", count, wide_value) != 0) {
+        printf("Error: Memory allocation failed\n");
+        return 1;
+    }
+    
+    char* text = malloc(count * (FAST_DTOA_BUFFER_SIZE + 1));
+    if (!text) {
+        printf("Error: Memory allocation failed\n");
+        return 1;
+    }
+    
+    printf("%-12s %10s %10s %10s %10s %8s %s\n", "dataset", "printf", "fast", "printf", "fast",
+           "speedup", "mismatches");
+    printf("%-12s %10s %10s %10s %10s %8s\n", "", "ns/num", "ns/num", "bytes/num", "bytes/num", "");
+    int failed = 0;
+    for (int s = 0; s < 3; s++) {
+        const Dataset* set = &sets[s];
+        size_t printf_bytes, fast_bytes;
+        double t_printf = time_format(set, text, &printf_bytes, 1);
+        double t_fast = time_format(set, text, &fast_bytes, 0);
+        size_t mismatches = count_mismatches(set, text);
+        failed |= (mismatches != 0);
+        
+        printf("%-12s %10.1f %10.1f %10.2f %10.2f %7.2fx %zu\n", set->name,
+               t_printf * 1e9 / (double)set->count, t_fast * 1e9 / (double)set->count,
+               (double)printf_bytes / (double)set->count, (double)fast_bytes / (double)set->count,
+               t_printf / t_fast, mismatches);
+    }
+    
+    for (int s = 0; s < 3; s++) {
+        free(sets[s].values);
+    }
+    free(text);
+    return failed ? 1 : 0;
+}
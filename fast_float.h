@@ -0,0 +1,23 @@
+/*
+ * fast_float.h - Correctly rounded decimal to double conversion
+ *
+ * Implements the Eisel-Lemire algorithm (as used by fast_float): numbers
+ * with at most 19 significant digits are converted with one or two 64x128
+ * bit multiplications against a table of truncated powers of five, and
+ * small exact cases take Clinger's fast path. Inputs the algorithm cannot
+ * settle (more than 19 significant digits, or a product too close to a
+ * rounding boundary) fall back to strtod, so the result always matches
+ * strtod bit for bit.
+ */
+
+#ifndef FAST_FLOAT_H
+#define FAST_FLOAT_H
+
+#include <stddef.h>
+
+// Parse the JSON number starting at p (not NUL-terminated, ends before
+// `end`). Returns a pointer just past the number, or NULL if the text does
+// not follow the JSON number grammar.
+const char* fast_float_parse(const char* p, const char* end, double* value);
+
+#endif // FAST_FLOAT_H
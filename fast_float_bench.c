@@ -0,0 +1,212 @@
+/*
+ * fast_float_bench.c - Micro-benchmark of fast_float_parse against strtod
+ *
+ * Generates number tokens shaped like the coefficients, bounds and
+ * right-hand sides found in exported LP/MIP models, converts them with both
+ * strtod and fast_float_parse, checks that every result matches bit for bit
+ * and reports the throughput of each.
+ *
+ * Usage: ./fast_float_bench [count]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fast_float.h"
+
+#define DEFAULT_COUNT 2000000
+#define REPEATS 5
+
+typedef struct {
+    const char* name;
+    char* text;        // tokens separated by NUL bytes
+    size_t* offsets;   // start of each token in text
+    size_t* lengths;   // length of each token
+    size_t count;
+    size_t bytes;      // total token bytes, excluding separators
+} Dataset;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_random(void) {
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static double random_unit(void) {
+    return (double)(next_random() >> 11) / 9007199254740992.0;
+}
+
+// Matrix coefficients: mostly +-1 and small integers, some short
+// decimals, the rest full precision values over a few orders of magnitude
+static int format_coefficient(char* out, size_t size) {
+    unsigned kind = (unsigned)(next_random() % 100);
+    double sign = (next_random() & 1) ? -1.0 : 1.0;
+    if (kind < 35) {
+        return snprintf(out, size, "%d", (int)sign);
+    } else if (kind < 55) {
+        return snprintf(out, size, "%d", (int)(sign * (double)(next_random() % 1000)));
+    } else if (kind < 75) {
+        return snprintf(out, size, "%.2f", sign * (double)(next_random() % 100000) / 100.0);
+    }
+    double magnitude = pow(10.0, random_unit() * 12.0 - 6.0);
+    return snprintf(out, size, "%.17g", sign * magnitude * random_unit());
+}
+
+// Bounds and right-hand sides: zeros, integers, the 1e20 style infinity
+// markers and full precision values
+static int format_bound(char* out, size_t size) {
+    unsigned kind = (unsigned)(next_random() % 100);
+    if (kind < 30) {
+        return snprintf(out, size, "0");
+    } else if (kind < 45) {
+        return snprintf(out, size, "%s1e+20", (next_random() & 1) ? "-" : "");
+    } else if (kind < 75) {
+        return snprintf(out, size, "%d", (int)(next_random() % 100000));
+    }
+    return snprintf(out, size, "%.17g", random_unit() * pow(10.0, random_unit() * 8.0 - 2.0));
+}
+
+// Objective coefficients as written by %.17g over a wide exponent range
+static int format_objective(char* out, size_t size) {
+    double sign = (next_random() & 1) ? -1.0 : 1.0;
+    double magnitude = pow(10.0, random_unit() * 40.0 - 20.0);
+    return snprintf(out, size, "%.17g", sign * magnitude * random_unit());
+}
+
+static int build_dataset(Dataset* set, const char* name, size_t count,
+                         int (*format)(char*, size_t)) {
+    size_t capacity = count * 32;
+    set->name = name;
+    set->text = malloc(capacity);
+    set->offsets = malloc(count * sizeof(size_t));
+    set->lengths = malloc(count * sizeof(size_t));
+    set->count = count;
+    set->bytes = 0;
+    if (!set->text || !set->offsets || !set->lengths) {
+        return -1;
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) {
+        int n = format(set->text + used, capacity - used);
+        if (n < 0 || (size_t)n + 1 > capacity - used) {
+            return -1;
+        }
+        set->offsets[i] = used;
+        set->lengths[i] = (size_t)n;
+        set->bytes += (size_t)n;
+        used += (size_t)n + 1;
+    }
+    return 0;
+}
+
+static double elapsed_seconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Best of REPEATS runs of strtod over the dataset
+static double time_strtod(const Dataset* set, double* out) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < set->count; i++) {
+            out[i] = strtod(set->text + set->offsets[i], NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double t = elapsed_seconds(start, end);
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+// Best of REPEATS runs of fast_float_parse over the dataset
+static double time_fast_float(const Dataset* set, double* out) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < set->count; i++) {
+            const char* token = set->text + set->offsets[i];
+            fast_float_parse(token, token + set->lengths[i], &out[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double t = elapsed_seconds(start, end);
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = DEFAULT_COUNT;
+    if (argc > 1) {
+        count = strtoul(argv[1], NULL, 10);
+        if (count == 0) {
+            printf("Usage: %s [count]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    Dataset sets[3];
+    if (build_dataset(&sets[0], "matrix values", count, format_coefficient) != 0 ||
+        build_dataset(&sets[1], "bounds", count, format_bound) != 0 ||
+        build_dataset(&sets[2], "objective", count, format_objective) != 0) {
+        printf("Error: Memory allocation failed\n");
+        return 1;
+    }
+    
+    double* expected = malloc(count * sizeof(double));
+    double* actual = malloc(count * sizeof(double));
+    if (!expected || !actual) {
+        printf("Error: Memory allocation failed\n");
+        return 1;
+    }
+    
+    printf("%-14s %10s %10s %10s %10s %8s %s\n", "dataset", "strtod", "fast", "strtod", "fast",
+           "speedup", "mismatches");
+    printf("%-14s %10s %10s %10s %10s %8s\n", "", "ns/num", "ns/num", "MB/s", "MB/s", "");
+    int failed = 0;
+    for (int s = 0; s < 3; s++) {
+        const Dataset* set = &sets[s];
+        double t_strtod = time_strtod(set, expected);
+        double t_fast = time_fast_float(set, actual);
+        
+        size_t mismatches = 0;
+        for (size_t i = 0; i < set->count; i++) {
+            if (memcmp(&expected[i], &actual[i], sizeof(double)) != 0) {
+                if (mismatches == 0) {
+                    printf("Mismatch: %s -> strtod %.17g, fast_float %.17g\n",
+                           set->text + set->offsets[i], expected[i], actual[i]);
+                }
+                mismatches++;
+            }
+        }
+        failed |= (mismatches != 0);
+        
+        printf("%-14s %10.1f %10.1f %10.1f %10.1f %7.2fx %zu\n", set->name,
+               t_strtod * 1e9 / (double)set->count, t_fast * 1e9 / (double)set->count,
+               (double)set->bytes / t_strtod / 1e6, (double)set->bytes / t_fast / 1e6,
+               t_strtod / t_fast, mismatches);
+    }
+    
+    for (int s = 0; s < 3; s++) {
+        free(sets[s].text);
+        free(sets[s].offsets);
+        free(sets[s].lengths);
+    }
+    free(expected);
+    free(actual);
+    return failed ? 1 : 0;
+}
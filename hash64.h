@@ -0,0 +1,17 @@
+/*
+ * hash64.h - Fast non-cryptographic 64-bit hash
+ *
+ * XXH64 (the 64-bit xxHash algorithm), used to checksum binary problem
+ * files and to fingerprint input files.
+ */
+
+#ifndef HASH64_H
+#define HASH64_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hash `length` bytes of `data`; different seeds give independent hashes
+uint64_t hash64(const void* data, size_t length, uint64_t seed);
+
+#endif // HASH64_H
@@ -0,0 +1,106 @@
+/*
+ * input_file.c - Read-only view of an input file for the JSON front ends
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "input_file.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Chunk size for the read fallback
+#define READ_CHUNK_SIZE (1 << 20)
+
+// Read everything from fd into a heap buffer; used when mmap is not possible
+static int read_into_buffer(JobContext* ctx, int fd, size_t size_hint, InputFile* input) {
+    size_t capacity = size_hint > 0 ? size_hint + 1 : READ_CHUNK_SIZE;
+    size_t size = 0;
+    char* buffer = malloc(capacity);
+    if (!buffer) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        return -1;
+    }
+    
+    for (;;) {
+        if (size == capacity) {
+            capacity *= 2;
+            char* grown = realloc(buffer, capacity);
+            if (!grown) {
+                job_printf(ctx, "Error: Memory allocation failed\n");
+                free(buffer);
+                return -1;
+            }
+            buffer = grown;
+        }
+        ssize_t n = read(fd, buffer + size, capacity - size);
+        if (n < 0) {
+            job_printf(ctx, "Error: Failed to read input\n");
+            free(buffer);
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        size += (size_t)n;
+    }
+    
+    input->data = buffer;
+    input->size = size;
+    input->mapped = 0;
+    return 0;
+}
+
+int input_file_open(JobContext* ctx, const char* filename, InputFile* input) {
+    memset(input, 0, sizeof(InputFile));
+    
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        job_printf(ctx, "Error: Cannot open file %s\n", filename);
+        return -1;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        job_printf(ctx, "Error: Cannot stat file %s\n", filename);
+        close(fd);
+        return -1;
+    }
+    
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // The parsers make a single forward pass, so aggressive readahead
+            // and early reclaim of consumed pages are what we want
+            madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+            close(fd);
+            input->data = mapping;
+            input->size = (size_t)st.st_size;
+            input->mapped = 1;
+            return 0;
+        }
+    }
+    
+    // Pipes, devices, empty files or a failed mmap: read the stream
+    size_t size_hint = S_ISREG(st.st_mode) ? (size_t)st.st_size : 0;
+    int result = read_into_buffer(ctx, fd, size_hint, input);
+    close(fd);
+    return result;
+}
+
+void input_file_close(InputFile* input) {
+    if (!input->data) {
+        return;
+    }
+    if (input->mapped) {
+        munmap((void*)input->data, input->size);
+    } else {
+        free((void*)input->data);
+    }
+    memset(input, 0, sizeof(InputFile));
+}
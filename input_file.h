@@ -0,0 +1,30 @@
+/*
+ * input_file.h - Read-only view of an input file for the JSON front ends
+ *
+ * Regular files are memory-mapped and consumed in place, so the parser
+ * reads straight from the page cache instead of a private heap copy.
+ * Pipes, character devices and anything else that cannot be mapped fall
+ * back to reading into a heap buffer.
+ */
+
+#ifndef INPUT_FILE_H
+#define INPUT_FILE_H
+
+#include <stddef.h>
+#include "job_context.h"
+
+typedef struct {
+    const char* data;  // file contents, not NUL-terminated
+    size_t size;
+    int mapped;        // 1 if data points into an mmap'd region
+} InputFile;
+
+// Open `filename` and make its contents available in input->data.
+// Returns 0 on success, -1 on failure (an error has been printed to the
+// job's output).
+int input_file_open(JobContext* ctx, const char* filename, InputFile* input);
+
+// Release the mapping or buffer
+void input_file_close(InputFile* input);
+
+#endif // INPUT_FILE_H
@@ -0,0 +1,137 @@
+/*
+ * input_list.c - Problem files for batch runs
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "input_list.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static int append_path(InputList* list, const char* path) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        char** grown = realloc(list->paths, capacity * sizeof(char*));
+        if (!grown) {
+            printf("Error: Memory allocation failed\n");
+            return -1;
+        }
+        list->paths = grown;
+        list->capacity = capacity;
+    }
+    list->paths[list->count] = strdup(path);
+    if (!list->paths[list->count]) {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+    list->count++;
+    return 0;
+}
+
+static int has_suffix(const char* name, const char* suffix) {
+    size_t n = strlen(name), m = strlen(suffix);
+    return n >= m && strcmp(name + n - m, suffix) == 0;
+}
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+int input_list_is_directory(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Add the problem files of a directory in name order, so runs are repeatable
+static int add_directory(InputList* list, const char* dir) {
+    DIR* handle = opendir(dir);
+    if (!handle) {
+        printf("Error: Cannot open directory %s\n", dir);
+        return -1;
+    }
+    
+    size_t first = list->count;
+    struct dirent* ent;
+    char path[4096];
+    int result = 0;
+    while ((ent = readdir(handle)) != NULL) {
+        if (!has_suffix(ent->d_name, ".json") && !has_suffix(ent->d_name, ".cuopt.bin")) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        if (append_path(list, path) != 0) {
+            result = -1;
+            break;
+        }
+    }
+    closedir(handle);
+    
+    qsort(list->paths + first, list->count - first, sizeof(char*), compare_paths);
+    return result;
+}
+
+int input_list_add(InputList* list, const char* path) {
+    if (input_list_is_directory(path)) {
+        return add_directory(list, path);
+    }
+    return append_path(list, path);
+}
+
+int input_list_add_manifest(InputList* list, const char* manifest) {
+    FILE* file = fopen(manifest, "r");
+    if (!file) {
+        printf("Error: Cannot open manifest %s\n", manifest);
+        return -1;
+    }
+    
+    // Directory part of the manifest path, for resolving relative entries
+    size_t dir_length = 0;
+    const char* slash = strrchr(manifest, '/');
+    if (slash) {
+        dir_length = (size_t)(slash - manifest) + 1;
+    }
+    
+    char line[4096];
+    char path[8192];
+    int result = 0;
+    while (fgets(line, sizeof(line), file)) {
+        char* start = line;
+        while (*start == ' ' || *start == '\t') start++;
+        char* end = start + strlen(start);
+        while (end > start && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+            end--;
+        }
+        *end = '\0';
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+        
+        if (*start == '/' || dir_length == 0) {
+            snprintf(path, sizeof(path), "%s", start);
+        } else {
+            snprintf(path, sizeof(path), "%.*s%s", (int)dir_length, manifest, start);
+        }
+        if (input_list_add(list, path) != 0) {
+            result = -1;
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+void input_list_free(InputList* list) {
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    memset(list, 0, sizeof(InputList));
+}
@@ -0,0 +1,33 @@
+/*
+ * input_list.h - Problem files for batch runs
+ *
+ * Collects the inputs of a batch from command-line arguments, directories
+ * (every *.json and *.cuopt.bin file inside, in name order) and manifest
+ * files (one path per line; blank lines and lines starting with '#' are
+ * skipped; relative paths are taken relative to the manifest).
+ */
+
+#ifndef INPUT_LIST_H
+#define INPUT_LIST_H
+
+#include <stddef.h>
+
+typedef struct {
+    char** paths;
+    size_t count;
+    size_t capacity;
+} InputList;
+
+// Add a file, or every problem file of a directory. Returns 0 on success,
+// -1 on failure (an error has been printed).
+int input_list_add(InputList* list, const char* path);
+
+// Add every path listed in a manifest file
+int input_list_add_manifest(InputList* list, const char* manifest);
+
+// Return 1 if `path` names a directory
+int input_list_is_directory(const char* path);
+
+void input_list_free(InputList* list);
+
+#endif // INPUT_LIST_H
@@ -0,0 +1,214 @@
+/*
+ * job_context.c - Per-job options, timing and output
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "job_context.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+// Scratch blocks grow geometrically from this size
+#define SCRATCH_MIN_BLOCK (1 << 20)
+#define SCRATCH_ALIGNMENT 64
+
+struct ScratchBlock {
+    ScratchBlock* next;
+    size_t capacity;
+    size_t used;
+    char* data;
+};
+
+// Flushes from different jobs must not interleave
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void job_context_init(JobContext* ctx) {
+    memset(ctx, 0, sizeof(JobContext));
+    ctx->parser = JSON_PARSER_STREAM;
+    ctx->scaling_method = SCALING_NONE;
+    ctx->block_jobs = 1;
+    ctx->out = stdout;
+}
+
+void job_context_init_from(JobContext* ctx, const JobContext* base) {
+    job_context_init(ctx);
+    ctx->timing_enabled = base->timing_enabled;
+    ctx->mps_output_file = base->mps_output_file;
+    ctx->parser = base->parser;
+    ctx->pool = base->pool;
+    ctx->solution_output_file = base->solution_output_file;
+    ctx->solution_writer = base->solution_writer;
+    ctx->presolve_enabled = base->presolve_enabled;
+    ctx->propagate_enabled = base->propagate_enabled;
+    ctx->scaling_method = base->scaling_method;
+    ctx->decompose_problems = base->decompose_problems;
+    ctx->block_jobs = base->block_jobs;
+}
+
+int job_context_capture(JobContext* ctx) {
+    if (ctx->out != stdout) {
+        return 0;
+    }
+    FILE* stream = open_memstream(&ctx->capture_data, &ctx->capture_size);
+    if (!stream) {
+        return -1;
+    }
+    ctx->out = stream;
+    return 0;
+}
+
+void job_context_flush(JobContext* ctx, FILE* to) {
+    if (ctx->out == stdout) {
+        fflush(stdout);
+        return;
+    }
+    fflush(ctx->out);
+    if (ctx->capture_size > 0) {
+        pthread_mutex_lock(&flush_mutex);
+        fwrite(ctx->capture_data, 1, ctx->capture_size, to);
+        fflush(to);
+        pthread_mutex_unlock(&flush_mutex);
+    }
+    fclose(ctx->out);
+    free(ctx->capture_data);
+    ctx->out = stdout;
+    ctx->capture_data = NULL;
+    ctx->capture_size = 0;
+    job_context_capture(ctx);
+}
+
+void job_context_destroy(JobContext* ctx) {
+    if (ctx->out && ctx->out != stdout) {
+        fclose(ctx->out);
+        free(ctx->capture_data);
+    }
+    ScratchBlock* block = ctx->scratch;
+    while (block) {
+        ScratchBlock* next = block->next;
+        free(block->data);
+        free(block);
+        block = next;
+    }
+    ctx->out = stdout;
+    ctx->capture_data = NULL;
+    ctx->capture_size = 0;
+    ctx->scratch = NULL;
+}
+
+FILE* job_output(const JobContext* ctx) {
+    return ctx && ctx->out ? ctx->out : stdout;
+}
+
+ThreadPool* job_thread_pool(const JobContext* ctx) {
+    return ctx ? ctx->pool : NULL;
+}
+
+void job_printf(const JobContext* ctx, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(job_output(ctx), format, args);
+    va_end(args);
+}
+
+void* job_scratch_alloc(JobContext* ctx, size_t size) {
+    size = (size + SCRATCH_ALIGNMENT - 1) & ~(size_t)(SCRATCH_ALIGNMENT - 1);
+    ScratchBlock* block = ctx->scratch;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = block ? block->capacity * 2 : SCRATCH_MIN_BLOCK;
+        if (capacity < size) {
+            capacity = size;
+        }
+        ScratchBlock* grown = malloc(sizeof(ScratchBlock));
+        void* data = NULL;
+        if (!grown || posix_memalign(&data, SCRATCH_ALIGNMENT, capacity) != 0) {
+            free(grown);
+            return NULL;
+        }
+        grown->next = block;
+        grown->capacity = capacity;
+        grown->used = 0;
+        grown->data = data;
+        ctx->scratch = block = grown;
+    }
+    void* result = block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+void job_scratch_reset(JobContext* ctx) {
+    // Keep the largest (newest) block, free the rest
+    ScratchBlock* block = ctx->scratch;
+    if (!block) {
+        return;
+    }
+    ScratchBlock* next = block->next;
+    while (next) {
+        ScratchBlock* following = next->next;
+        free(next->data);
+        free(next);
+        next = following;
+    }
+    block->next = NULL;
+    block->used = 0;
+}
+
+double wall_clock_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void start_timer(const JobContext* ctx, Timer* timer) {
+    if (ctx && ctx->timing_enabled) {
+        clock_gettime(CLOCK_MONOTONIC, &timer->start_time);
+    }
+}
+
+double end_timer(const JobContext* ctx, Timer* timer) {
+    if (!ctx || !ctx->timing_enabled) {
+        return 0.0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &timer->end_time);
+    double elapsed = (timer->end_time.tv_sec - timer->start_time.tv_sec) + 
+                    (timer->end_time.tv_nsec - timer->start_time.tv_nsec) / 1e9;
+    return elapsed;
+}
+
+void log_timestamp(const JobContext* ctx, const char* phase) {
+    int timing = ctx && ctx->timing_enabled;
+    int tracing = trace_enabled();
+    if (!timing && !tracing) {
+        return;
+    }
+    struct timespec current_time;
+    clock_gettime(CLOCK_MONOTONIC, &current_time);
+    if (tracing) {
+        trace_record(phase, &current_time);
+    }
+    if (timing) {
+        fprintf(job_output(ctx), "[TIMESTAMP] %s: %ld.%09ld\n", phase, current_time.tv_sec,
+                current_time.tv_nsec);
+    }
+}
+
+void log_phase_duration(const JobContext* ctx, const char* phase, double duration) {
+    if (trace_enabled()) {
+        trace_name_span(phase);
+    }
+    if (!ctx || !ctx->timing_enabled) {
+        return;
+    }
+    fprintf(job_output(ctx), "[DURATION] %s: %.6f seconds\n", phase, duration);
+}
+
+void log_phase_throughput(const JobContext* ctx, const char* phase, size_t bytes, double duration) {
+    if (!ctx || !ctx->timing_enabled || duration <= 0.0) {
+        return;
+    }
+    fprintf(job_output(ctx), "[THROUGHPUT] %s: %.3f GB/s\n", phase, bytes / duration / 1e9);
+}
@@ -0,0 +1,116 @@
+/*
+ * job_context.h - Per-job options, timing and output
+ *
+ * Everything one parse-and-solve job needs that used to live in globals:
+ * the options it runs with, where its messages go and scratch memory for
+ * temporary buffers. Jobs on different threads each get their own context,
+ * so they can run concurrently in one process. With output capture on, a
+ * job's messages are collected in memory and emitted as one block when it
+ * is done, instead of interleaving with other jobs' output.
+ *
+ * Functions that take a context also accept NULL, meaning: no timing
+ * output and messages straight to stdout.
+ */
+
+#ifndef JOB_CONTEXT_H
+#define JOB_CONTEXT_H
+
+#include <stdio.h>
+#include <time.h>
+#include "thread_pool.h"
+
+// JSON front ends selectable with --parser
+typedef enum {
+    JSON_PARSER_STREAM,  // streaming tokenizer writing straight into ProblemData
+    JSON_PARSER_INDEX,   // SIMD structural index, then a walk over the index
+    JSON_PARSER_CJSON    // full cJSON DOM, kept as a fallback
+} JsonParserKind;
+
+// Equilibration selectable with --scale
+typedef enum {
+    SCALING_NONE,
+    SCALING_GEOMEAN,
+    SCALING_RUIZ
+} ScalingMethod;
+
+typedef struct ScratchBlock ScratchBlock;
+struct AsyncWriter;
+
+typedef struct {
+    // Options
+    int timing_enabled;
+    const char* mps_output_file;    // write each problem to this MPS file
+    JsonParserKind parser;
+    ThreadPool* pool;               // for parallel parsing, not owned (may be NULL)
+    const char* solution_output_file;  // --solution-out: write the solution
+    struct AsyncWriter* solution_writer;  // writes solutions in the background, not owned
+    int presolve_enabled;           // remove trivial rows and fixed variables first
+    int propagate_enabled;          // tighten MIP variable bounds before solving
+    ScalingMethod scaling_method;   // equilibration before solving
+    int decompose_problems;         // solve independent blocks of a problem separately
+    int block_jobs;                 // blocks of one problem solved at once
+    
+    // Output sink: stdout, or an in-memory stream while capturing
+    FILE* out;
+    char* capture_data;
+    size_t capture_size;
+    
+    // Scratch memory, released by job_context_destroy
+    ScratchBlock* scratch;
+} JobContext;
+
+// Timing utility functions
+typedef struct {
+    struct timespec start_time;
+    struct timespec end_time;
+} Timer;
+
+// Defaults: timing off, streaming parser, no pool, no host passes, output
+// to stdout
+void job_context_init(JobContext* ctx);
+
+// Copy the options of `base` into a fresh context with its own output and
+// scratch memory
+void job_context_init_from(JobContext* ctx, const JobContext* base);
+
+// Collect the job's output in memory from now on. Returns 0 on success;
+// on failure output keeps going to stdout.
+int job_context_capture(JobContext* ctx);
+
+// Write the captured output to `to` as one block and start a new capture
+void job_context_flush(JobContext* ctx, FILE* to);
+
+// Release scratch memory and the capture buffer (unflushed output is lost)
+void job_context_destroy(JobContext* ctx);
+
+// Where the job's messages go
+FILE* job_output(const JobContext* ctx);
+
+// The job's thread pool (NULL: run on the calling thread)
+ThreadPool* job_thread_pool(const JobContext* ctx);
+
+// printf to the job's output
+void job_printf(const JobContext* ctx, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// Allocate `size` bytes of scratch memory (64-byte aligned) that lives
+// until job_scratch_reset or job_context_destroy. Returns NULL on failure.
+void* job_scratch_alloc(JobContext* ctx, size_t size);
+
+// Release all scratch allocations, keeping the first block for reuse
+void job_scratch_reset(JobContext* ctx);
+
+// Seconds on the monotonic clock, measured even when timing output is off;
+// only differences between two readings are meaningful
+double wall_clock_seconds(void);
+
+void start_timer(const JobContext* ctx, Timer* timer);
+double end_timer(const JobContext* ctx, Timer* timer);
+void log_timestamp(const JobContext* ctx, const char* phase);
+void log_phase_duration(const JobContext* ctx, const char* phase, double duration);
+void log_phase_throughput(const JobContext* ctx, const char* phase, size_t bytes, double duration);
+
+#endif // JOB_CONTEXT_H
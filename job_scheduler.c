@@ -0,0 +1,142 @@
+/*
+ * job_scheduler.c - Concurrent solves of independent problems
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "job_scheduler.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "job_context.h"
+
+typedef struct {
+    size_t count;
+    SchedulerRunFn run;
+    SchedulerDoneFn done;
+    void* user;
+    
+    pthread_mutex_t mutex;
+    size_t next_index;       // next job to hand to a worker
+    size_t next_done;        // next job to report in order
+    unsigned char* finished; // one flag per job
+    double* latency;         // seconds, one per job
+    size_t running;
+    size_t max_running;
+} Scheduler;
+
+static void* worker_main(void* arg) {
+    Scheduler* s = arg;
+    
+    pthread_mutex_lock(&s->mutex);
+    while (s->next_index < s->count) {
+        size_t index = s->next_index++;
+        s->running++;
+        if (s->running > s->max_running) {
+            s->max_running = s->running;
+        }
+        pthread_mutex_unlock(&s->mutex);
+        
+        double start = wall_clock_seconds();
+        s->run(s->user, index);
+        s->latency[index] = wall_clock_seconds() - start;
+        
+        pthread_mutex_lock(&s->mutex);
+        s->running--;
+        s->finished[index] = 1;
+        // Report every job whose predecessors are all done; holding the
+        // mutex keeps the callbacks in order and one at a time
+        while (s->next_done < s->count && s->finished[s->next_done]) {
+            if (s->done) {
+                s->done(s->user, s->next_done);
+            }
+            s->next_done++;
+        }
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return NULL;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of `count` > 0 sorted values
+static double percentile(const double* sorted, size_t count, size_t percent) {
+    size_t rank = (percent * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+int scheduler_run(size_t count, int num_workers, SchedulerRunFn run, SchedulerDoneFn done,
+                  void* user, SchedulerStats* stats) {
+    memset(stats, 0, sizeof(SchedulerStats));
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    if ((size_t)num_workers > count && count > 0) {
+        num_workers = (int)count;
+    }
+    
+    Scheduler s;
+    memset(&s, 0, sizeof(s));
+    s.count = count;
+    s.run = run;
+    s.done = done;
+    s.user = user;
+    s.finished = calloc(count > 0 ? count : 1, 1);
+    s.latency = calloc(count > 0 ? count : 1, sizeof(double));
+    pthread_t* workers = calloc((size_t)num_workers, sizeof(pthread_t));
+    if (!s.finished || !s.latency || !workers) {
+        printf("Error: Memory allocation failed\n");
+        free(s.finished);
+        free(s.latency);
+        free(workers);
+        return -1;
+    }
+    pthread_mutex_init(&s.mutex, NULL);
+    
+    double start = wall_clock_seconds();
+    int started = 0;
+    for (; started < num_workers; started++) {
+        if (pthread_create(&workers[started], NULL, worker_main, &s) != 0) {
+            break;
+        }
+    }
+    if (started == 0) {
+        printf("Error: Could not start worker threads\n");
+        pthread_mutex_destroy(&s.mutex);
+        free(s.finished);
+        free(s.latency);
+        free(workers);
+        return -1;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    
+    stats->elapsed = wall_clock_seconds() - start;
+    stats->workers = started;
+    stats->max_running = s.max_running;
+    if (count > 0) {
+        double sum = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            sum += s.latency[i];
+        }
+        qsort(s.latency, count, sizeof(double), compare_doubles);
+        stats->latency_mean = sum / count;
+        stats->latency_p50 = percentile(s.latency, count, 50);
+        stats->latency_p90 = percentile(s.latency, count, 90);
+        stats->latency_p99 = percentile(s.latency, count, 99);
+        stats->latency_max = s.latency[count - 1];
+    }
+    
+    pthread_mutex_destroy(&s.mutex);
+    free(s.finished);
+    free(s.latency);
+    free(workers);
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * job_scheduler.h - Concurrent solves of independent problems
+ *
+ * A fixed number of worker threads take jobs in index order and run each
+ * one start to finish: load, solve, release. Jobs are independent, so a
+ * worker never waits for another one. Completion callbacks are delivered
+ * one at a time in index order, as soon as a job and every job before it
+ * have finished, so output captured per job can be printed without
+ * interleaving while later jobs are still running.
+ */
+
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <stddef.h>
+
+// Run job `index`; called concurrently from worker threads
+typedef void (*SchedulerRunFn)(void* user, size_t index);
+
+// Job `index` and every earlier job have finished; called one at a time,
+// in index order, from whichever worker completed the sequence
+typedef void (*SchedulerDoneFn)(void* user, size_t index);
+
+// Wall-clock figures of a run. Latency is the time a job spent running,
+// from the moment a worker picked it up until its run callback returned.
+typedef struct {
+    double elapsed;
+    int workers;           // threads actually started
+    size_t max_running;    // most jobs running at once
+    double latency_mean;
+    double latency_p50;
+    double latency_p90;
+    double latency_p99;
+    double latency_max;
+} SchedulerStats;
+
+// Run jobs [0, count) on `num_workers` threads and wait for all of them.
+// Returns 0, or -1 if no thread could be started (nothing has been run in
+// that case).
+int scheduler_run(size_t count, int num_workers, SchedulerRunFn run, SchedulerDoneFn done,
+                  void* user, SchedulerStats* stats);
+
+#endif // JOB_SCHEDULER_H
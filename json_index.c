@@ -0,0 +1,515 @@
+/*
+ * json_index.c - Two-stage JSON front end built on a structural index
+ *
+ * Stage 1 follows the approach popularized by simdjson: per 64-byte block,
+ * compare every byte against the interesting characters to get bit masks,
+ * find the quotes that are not escaped, turn them into an "inside a string"
+ * mask with a prefix XOR, and keep only the structural characters outside
+ * of strings. Escapes are rare in cuOpt models (names at most), so blocks
+ * that contain a backslash are resolved with a short scalar loop.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "json_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "json_number.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSON_INDEX_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#define BLOCK_SIZE 64
+
+// Character class masks for one 64-byte block
+typedef struct {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;  // { } [ ] : ,
+} BlockMasks;
+
+typedef void (*ClassifyFn)(const unsigned char* block, BlockMasks* masks);
+
+static void classify_scalar(const unsigned char* block, BlockMasks* masks) {
+    uint64_t quote = 0, backslash = 0, op = 0;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        uint64_t bit = 1ULL << i;
+        switch (block[i]) {
+            case '"': quote |= bit; break;
+            case '\\': backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                op |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    masks->quote = quote;
+    masks->backslash = backslash;
+    masks->op = op;
+}
+
+#ifdef JSON_INDEX_HAVE_X86
+// '[' and ']' differ from '{' and '}' only in bit 0x20, so OR-ing it in
+// folds the four brackets into two comparisons.
+static void classify_sse2(const unsigned char* block, BlockMasks* masks) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+
+    masks->quote = 0;
+    masks->backslash = 0;
+    masks->op = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        __m128i folded = _mm_or_si128(v, case_bit);
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace), _mm_cmpeq_epi8(folded, close_brace)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        int shift = 16 * i;
+        masks->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << shift;
+        masks->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)) << shift;
+        masks->op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+    }
+}
+
+__attribute__((target("avx2")))
+static void classify_avx2(const unsigned char* block, BlockMasks* masks) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i open_brace = _mm256_set1_epi8('{');
+    const __m256i close_brace = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+
+    masks->quote = 0;
+    masks->backslash = 0;
+    masks->op = 0;
+    for (int i = 0; i < 2; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(block + 32 * i));
+        __m256i folded = _mm256_or_si256(v, case_bit);
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open_brace), _mm256_cmpeq_epi8(folded, close_brace)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+        int shift = 32 * i;
+        masks->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)) << shift;
+        masks->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)) << shift;
+        masks->op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+    }
+}
+#endif
+
+static ClassifyFn select_kernel(const char** name) {
+#ifdef JSON_INDEX_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return classify_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        *name = "sse2";
+        return classify_sse2;
+    }
+#endif
+    *name = "scalar";
+    return classify_scalar;
+}
+
+const char* json_index_kernel_name(void) {
+    const char* name;
+    select_kernel(&name);
+    return name;
+}
+
+// Mask of the characters escaped by a backslash. *carry is 1 when the
+// previous block ended in the middle of an escape.
+static uint64_t escaped_chars(const unsigned char* block, uint64_t backslash, uint64_t* carry) {
+    if (backslash == 0) {
+        uint64_t escaped = *carry;
+        *carry = 0;
+        return escaped;
+    }
+    uint64_t escaped = 0;
+    int pending = (int)*carry;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        if (pending) {
+            escaped |= 1ULL << i;
+            pending = 0;
+        } else if (block[i] == '\\') {
+            pending = 1;
+        }
+    }
+    *carry = (uint64_t)pending;
+    return escaped;
+}
+
+// Bit i of the result is the XOR of bits 0..i of x, i.e. 1 between an
+// opening quote (inclusive) and its closing quote (exclusive)
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+JsonSaxStatus json_index_build(const char* text, size_t length, JsonIndex* index,
+                               size_t* error_offset) {
+    const char* kernel_name;
+    ClassifyFn classify = select_kernel(&kernel_name);
+
+    memset(index, 0, sizeof(JsonIndex));
+    index->text = text;
+    index->length = length;
+    index->num_words = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    index->bits = malloc((index->num_words ? index->num_words : 1) * sizeof(uint64_t));
+    if (!index->bits) {
+        return JSON_SAX_OUT_OF_MEMORY;
+    }
+
+    uint64_t in_string_carry = 0;  // all ones while a string spans blocks
+    uint64_t escape_carry = 0;
+    unsigned char tail[BLOCK_SIZE];
+
+    for (size_t w = 0; w < index->num_words; w++) {
+        const unsigned char* block = (const unsigned char*)text + w * BLOCK_SIZE;
+        if ((w + 1) * BLOCK_SIZE > length) {
+            // Pad the last partial block with spaces, which carry no bits
+            size_t remaining = length - w * BLOCK_SIZE;
+            memset(tail, ' ', BLOCK_SIZE);
+            memcpy(tail, block, remaining);
+            block = tail;
+        }
+
+        BlockMasks masks;
+        classify(block, &masks);
+
+        uint64_t quotes = masks.quote;
+        if (masks.backslash | escape_carry) {
+            quotes &= ~escaped_chars(block, masks.backslash, &escape_carry);
+        }
+        uint64_t in_string = prefix_xor(quotes) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+
+        index->bits[w] = (masks.op & ~in_string) | quotes;
+    }
+
+    if (in_string_carry) {
+        if (error_offset) {
+            *error_offset = length;
+        }
+        return JSON_SAX_SYNTAX_ERROR;
+    }
+    return JSON_SAX_OK;
+}
+
+void json_index_free(JsonIndex* index) {
+    free(index->bits);
+    memset(index, 0, sizeof(JsonIndex));
+}
+
+// Iterator over the set bits of the index
+typedef struct {
+    const uint64_t* bits;
+    size_t num_words;
+    size_t word;
+    uint64_t current;
+    size_t length;  // returned once the bits are exhausted
+} Cursor;
+
+static void cursor_init(Cursor* c, const JsonIndex* index) {
+    c->bits = index->bits;
+    c->num_words = index->num_words;
+    c->word = 0;
+    c->current = index->num_words ? index->bits[0] : 0;
+    c->length = index->length;
+}
+
+static size_t cursor_peek(Cursor* c) {
+    while (c->current == 0) {
+        if (++c->word >= c->num_words) {
+            c->word = c->num_words;
+            return c->length;
+        }
+        c->current = c->bits[c->word];
+    }
+    return c->word * BLOCK_SIZE + (size_t)__builtin_ctzll(c->current);
+}
+
+// Drop every bit before byte offset `pos`
+static void cursor_seek(Cursor* c, size_t pos) {
+    size_t word = pos / BLOCK_SIZE;
+    if (word >= c->num_words) {
+        c->word = c->num_words;
+        c->current = 0;
+        return;
+    }
+    c->word = word;
+    c->current = c->bits[word] & (~0ULL << (pos % BLOCK_SIZE));
+}
+
+static size_t cursor_next(Cursor* c) {
+    size_t pos = cursor_peek(c);
+    c->current &= c->current - 1;
+    return pos;
+}
+
+static int is_whitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static size_t skip_whitespace(const char* text, size_t pos, size_t end) {
+    while (pos < end && is_whitespace(text[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+static int only_whitespace(const char* text, size_t begin, size_t end) {
+    return skip_whitespace(text, begin, end) == end;
+}
+
+static int is_literal(const char* token, size_t length, const char* literal) {
+    return strlen(literal) == length && memcmp(token, literal, length) == 0;
+}
+
+// Invoke a callback if it is set; abort the walk if it asks to
+#define EMIT(callback, args)                                    \
+    do {                                                        \
+        if (handler->callback && handler->callback args != 0) { \
+            status = JSON_SAX_ABORTED;                          \
+            goto done;                                          \
+        }                                                       \
+    } while (0)
+
+// Report a syntax error at byte offset `at`
+#define FAIL(at)                          \
+    do {                                  \
+        status = JSON_SAX_SYNTAX_ERROR;   \
+        error_at = (at);                  \
+        goto done;                        \
+    } while (0)
+
+JsonSaxStatus json_index_walk(const JsonIndex* index, const JsonSaxHandler* handler,
+                              void* user, size_t* error_offset) {
+    const char* text = index->text;
+    size_t length = index->length;
+    Cursor cursor;
+    cursor_init(&cursor, index);
+
+    char stack[JSON_SAX_NESTING_LIMIT];
+    int depth = 0;
+    JsonSaxStatus status = JSON_SAX_OK;
+    size_t error_at = 0;
+    char* scratch = NULL;
+    size_t scratch_capacity = 0;
+
+    size_t pos = 0;        // last structural consumed
+    size_t value_start = 0;
+    size_t value_end = 0;  // one past the last value reported
+    const char* str;
+    size_t str_length;
+
+    // The document starts with a value
+    value_start = skip_whitespace(text, 0, length);
+    goto value_at;
+
+value:
+    // A value follows the structural at `pos`
+    value_start = skip_whitespace(text, pos + 1, length);
+
+value_at: {
+    if (value_start >= length) {
+        FAIL(length);
+    }
+    size_t next = cursor_peek(&cursor);
+
+    if (value_start != next) {
+        // Scalar: everything up to the next structural, minus whitespace
+        size_t end = next;
+        while (end > value_start && is_whitespace(text[end - 1])) {
+            end--;
+        }
+        const char* token = text + value_start;
+        size_t token_length = end - value_start;
+        if (*token == 't' || *token == 'f' || *token == 'n') {
+            if (is_literal(token, token_length, "true")) {
+                EMIT(bool_value, (user, 1));
+            } else if (is_literal(token, token_length, "false")) {
+                EMIT(bool_value, (user, 0));
+            } else if (is_literal(token, token_length, "null")) {
+                EMIT(null_value, (user));
+            } else {
+                FAIL(value_start);
+            }
+        } else {
+            if (json_number_scan(token, token + token_length) != token + token_length) {
+                FAIL(value_start);
+            }
+            EMIT(number_value, (user, token, token_length));
+        }
+        value_end = end;
+        goto after_value;
+    }
+
+    pos = cursor_next(&cursor);
+    switch (text[pos]) {
+        case '{':
+            if (depth >= JSON_SAX_NESTING_LIMIT) {
+                status = JSON_SAX_NESTING_TOO_DEEP;
+                error_at = pos;
+                goto done;
+            }
+            stack[depth++] = '{';
+            EMIT(start_object, (user));
+            next = cursor_peek(&cursor);
+            if (next < length && text[next] == '}' && only_whitespace(text, pos + 1, next)) {
+                pos = cursor_next(&cursor);
+                depth--;
+                EMIT(end_object, (user));
+                value_end = pos + 1;
+                goto after_value;
+            }
+            goto key;
+        case '[':
+            if (handler->raw_array) {
+                const char* resume = NULL;
+                EMIT(raw_array, (user, text + pos, text + length, &resume));
+                if (resume) {
+                    value_end = (size_t)(resume - text);
+                    cursor_seek(&cursor, value_end);
+                    goto after_value;
+                }
+            }
+            if (depth >= JSON_SAX_NESTING_LIMIT) {
+                status = JSON_SAX_NESTING_TOO_DEEP;
+                error_at = pos;
+                goto done;
+            }
+            stack[depth++] = '[';
+            EMIT(start_array, (user));
+            next = cursor_peek(&cursor);
+            if (next < length && text[next] == ']' && only_whitespace(text, pos + 1, next)) {
+                pos = cursor_next(&cursor);
+                depth--;
+                EMIT(end_array, (user));
+                value_end = pos + 1;
+                goto after_value;
+            }
+            goto value;
+        case '"': {
+            // Quotes come in pairs, so the next bit is the closing quote
+            size_t close = cursor_next(&cursor);
+            const char* raw = text + pos + 1;
+            size_t raw_length = close - pos - 1;
+            if (memchr(raw, '\\', raw_length)) {
+                const char* error_pos = raw;
+                status = json_sax_unescape(raw, raw_length, &scratch, &scratch_capacity,
+                                           &str_length, &error_pos);
+                if (status != JSON_SAX_OK) {
+                    error_at = (size_t)(error_pos - text);
+                    goto done;
+                }
+                str = scratch;
+            } else {
+                str = raw;
+                str_length = raw_length;
+            }
+            EMIT(string_value, (user, str, str_length));
+            pos = close;
+            value_end = close + 1;
+            goto after_value;
+        }
+        default:
+            FAIL(pos);
+    }
+}
+
+key: {
+    // A key string follows the '{' or ',' at `pos`
+    size_t open = cursor_next(&cursor);
+    if (open >= length || text[open] != '"' || !only_whitespace(text, pos + 1, open)) {
+        FAIL(open < length ? open : length);
+    }
+    size_t close = cursor_next(&cursor);
+    const char* raw = text + open + 1;
+    size_t raw_length = close - open - 1;
+    if (memchr(raw, '\\', raw_length)) {
+        const char* error_pos = raw;
+        status = json_sax_unescape(raw, raw_length, &scratch, &scratch_capacity,
+                                   &str_length, &error_pos);
+        if (status != JSON_SAX_OK) {
+            error_at = (size_t)(error_pos - text);
+            goto done;
+        }
+        str = scratch;
+    } else {
+        str = raw;
+        str_length = raw_length;
+    }
+    EMIT(key, (user, str, str_length));
+
+    pos = cursor_next(&cursor);
+    if (pos >= length || text[pos] != ':' || !only_whitespace(text, close + 1, pos)) {
+        FAIL(close + 1);
+    }
+    goto value;
+}
+
+after_value:
+    if (depth == 0) {
+        if (!only_whitespace(text, value_end, length) || cursor_peek(&cursor) != length) {
+            FAIL(value_end);
+        }
+        goto done;
+    }
+    pos = cursor_next(&cursor);
+    if (pos >= length || !only_whitespace(text, value_end, pos)) {
+        FAIL(value_end);
+    }
+    switch (text[pos]) {
+        case ',':
+            if (stack[depth - 1] == '{') {
+                goto key;
+            }
+            goto value;
+        case '}':
+            if (stack[depth - 1] != '{') {
+                FAIL(pos);
+            }
+            depth--;
+            EMIT(end_object, (user));
+            value_end = pos + 1;
+            goto after_value;
+        case ']':
+            if (stack[depth - 1] != '[') {
+                FAIL(pos);
+            }
+            depth--;
+            EMIT(end_array, (user));
+            value_end = pos + 1;
+            goto after_value;
+        default:
+            FAIL(pos);
+    }
+
+done:
+    free(scratch);
+    if (status != JSON_SAX_OK && error_offset) {
+        *error_offset = status == JSON_SAX_ABORTED ? value_end : error_at;
+    }
+    return status;
+}
+
+#undef EMIT
+#undef FAIL
@@ -0,0 +1,41 @@
+/*
+ * json_index.h - Two-stage JSON front end built on a structural index
+ *
+ * Stage 1 scans the input 64 bytes at a time (AVX2 or SSE2 when the CPU has
+ * them, scalar otherwise) and records one bit per byte for every structural
+ * character ({ } [ ] : ,) outside of strings and every unescaped quote.
+ * Stage 2 walks the set bits of that bitmap instead of the bytes, so the
+ * digits of large numeric arrays are only touched again when a number is
+ * converted. It reports the same events as json_sax_parse, which lets the
+ * ProblemData builder consume either front end unchanged.
+ */
+
+#ifndef JSON_INDEX_H
+#define JSON_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "json_sax.h"
+
+typedef struct {
+    const char* text;   // indexed document (not owned)
+    size_t length;
+    uint64_t* bits;     // bit i of bits[i / 64] set for a structural or quote at byte i
+    size_t num_words;
+} JsonIndex;
+
+// Stage 1: build the structural bitmap for `length` bytes of `text`.
+// Returns JSON_SAX_SYNTAX_ERROR for an unterminated string.
+JsonSaxStatus json_index_build(const char* text, size_t length, JsonIndex* index,
+                               size_t* error_offset);
+
+// Stage 2: walk the index and report tokens to `handler`
+JsonSaxStatus json_index_walk(const JsonIndex* index, const JsonSaxHandler* handler,
+                              void* user, size_t* error_offset);
+
+void json_index_free(JsonIndex* index);
+
+// Name of the stage 1 kernel picked for this CPU ("avx2", "sse2" or "scalar")
+const char* json_index_kernel_name(void);
+
+#endif // JSON_INDEX_H
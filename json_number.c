@@ -0,0 +1,228 @@
+/*
+ * json_number.c - Conversion of JSON number tokens to cuOpt types
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "json_number.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fast_float.h"
+
+// Longest string-encoded number we hand to strtod; exported models never
+// write anything close to this
+#define NUMBER_BUFFER_SIZE 64
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* json_number_scan(const char* p, const char* end) {
+    if (p < end && *p == '-') {
+        p++;
+    }
+    if (p >= end) {
+        return NULL;
+    }
+    if (*p == '0') {
+        p++;
+    } else if (is_digit(*p)) {
+        while (p < end && is_digit(*p)) p++;
+    } else {
+        return NULL;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        if (p >= end || !is_digit(*p)) {
+            return NULL;
+        }
+        while (p < end && is_digit(*p)) p++;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p >= end || !is_digit(*p)) {
+            return NULL;
+        }
+        while (p < end && is_digit(*p)) p++;
+    }
+    return p;
+}
+
+int json_number_to_float(const char* text, size_t length, cuopt_float_t* value) {
+    double number;
+    if (fast_float_parse(text, text + length, &number) != text + length) {
+        return -1;
+    }
+    *value = (cuopt_float_t)number;
+    return 0;
+}
+
+// Largest magnitude a cuopt_int_t can hold (32 or 64 bit builds)
+#define CUOPT_INT_MAX_VALUE \
+    ((uint64_t)(sizeof(cuopt_int_t) == 8 ? INT64_MAX : INT32_MAX))
+
+// Longest digit run that cannot overflow a uint64_t accumulator
+#define MAX_UINT64_DIGITS 19
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGH_BITS 0x8080808080808080ULL
+
+static const uint64_t powers_of_ten[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static uint64_t load_8_bytes(const char* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Number of leading bytes of an 8-byte word (first byte in the low bits)
+// that are ASCII digits
+static int count_leading_digits(uint64_t word) {
+    // Digits map to 0..9; everything else to a byte whose high bit is set
+    // after adding 0x76, or that already had it set
+    uint64_t x = word ^ (SWAR_ONES * '0');
+    uint64_t not_digit = (((x & ~SWAR_HIGH_BITS) + SWAR_ONES * 0x76) | x) & SWAR_HIGH_BITS;
+    if (not_digit == 0) {
+        return 8;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(not_digit) >> 3;
+#else
+    int n = 0;
+    while (!(not_digit & 0x80)) {
+        not_digit >>= 8;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Value of the first `n` digits (1..8) of a word holding ASCII digits
+static uint64_t parse_digits_swar(uint64_t word, int n) {
+    // Shift the digits we want to the top so the vacated low bytes read as
+    // leading zeros, then combine pairs, quads and finally both halves
+    uint64_t digits = (word - SWAR_ONES * '0') << (8 * (8 - n));
+    digits = (digits * 10) + (digits >> 8);
+    digits = (((digits & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+              (((digits >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return digits;
+}
+
+// Integral-valued tokens with a fraction or exponent ("3.0", "1e3") are
+// rare enough to go through the float parser
+static JsonNumberStatus parse_int_slow(const char* start, const char* end, cuopt_int_t* value,
+                                       const char** next) {
+    double number;
+    const char* token_end = fast_float_parse(start, end, &number);
+    if (!token_end) {
+        return JSON_NUMBER_INVALID;
+    }
+    *next = token_end;
+    if (number < -(double)CUOPT_INT_MAX_VALUE - 1.0 || number >= (double)CUOPT_INT_MAX_VALUE + 1.0) {
+        return JSON_NUMBER_OVERFLOW;
+    }
+    if ((double)(int64_t)number != number) {
+        return JSON_NUMBER_NOT_INTEGRAL;
+    }
+    *value = (cuopt_int_t)(int64_t)number;
+    return JSON_NUMBER_OK;
+}
+
+JsonNumberStatus json_number_parse_int(const char* p, const char* end, cuopt_int_t* value,
+                                       const char** next) {
+    const char* start = p;
+    int negative = 0;
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    
+    const char* digits_start = p;
+    uint64_t magnitude = 0;
+    // Eight digits per step while a full word is readable, then bytewise
+    while (end - p >= 8) {
+        int n = count_leading_digits(load_8_bytes(p));
+        if (n == 0) {
+            break;
+        }
+        if (p - digits_start + n > MAX_UINT64_DIGITS) {
+            break;
+        }
+        magnitude = magnitude * powers_of_ten[n] + parse_digits_swar(load_8_bytes(p), n);
+        p += n;
+        if (n < 8) {
+            break;
+        }
+    }
+    while (p < end && is_digit(*p)) {
+        if (p - digits_start >= MAX_UINT64_DIGITS) {
+            break;
+        }
+        magnitude = magnitude * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    
+    size_t digit_count = (size_t)(p - digits_start);
+    if (digit_count == 0 || (*digits_start == '0' && digit_count > 1)) {
+        return JSON_NUMBER_INVALID;
+    }
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E' || is_digit(*p))) {
+        // Fraction, exponent or more digits than the accumulator holds
+        return parse_int_slow(start, end, value, next);
+    }
+    
+    *next = p;
+    if (magnitude > CUOPT_INT_MAX_VALUE + (uint64_t)negative) {
+        return JSON_NUMBER_OVERFLOW;
+    }
+    *value = (negative && magnitude > 0) ? (cuopt_int_t)(-(int64_t)(magnitude - 1) - 1) : (cuopt_int_t)magnitude;
+    return JSON_NUMBER_OK;
+}
+
+JsonNumberStatus json_number_to_int(const char* text, size_t length, cuopt_int_t* value) {
+    const char* next;
+    JsonNumberStatus status = json_number_parse_int(text, text + length, value, &next);
+    if (status == JSON_NUMBER_OK && next != text + length) {
+        return JSON_NUMBER_INVALID;
+    }
+    return status;
+}
+
+static int string_equals(const char* str, size_t length, const char* literal) {
+    return strlen(literal) == length && memcmp(str, literal, length) == 0;
+}
+
+cuopt_float_t parse_numeric_string(const char* str, size_t length) {
+    if (string_equals(str, length, "inf") || string_equals(str, length, "infinity")) {
+        return CUOPT_INFINITY;
+    } else if (string_equals(str, length, "-inf") || string_equals(str, length, "-infinity") ||
+               string_equals(str, length, "ninf")) {
+        return -CUOPT_INFINITY;
+    }
+    
+    // Plain JSON numbers take the fast path
+    double number;
+    if (fast_float_parse(str, str + length, &number) == str + length) {
+        return (cuopt_float_t)number;
+    }
+    
+    // Anything else gets the same leniency as strtod(str, NULL): use
+    // whatever prefix parses
+    char buffer[NUMBER_BUFFER_SIZE];
+    if (length >= NUMBER_BUFFER_SIZE) {
+        length = NUMBER_BUFFER_SIZE - 1;
+    }
+    memcpy(buffer, str, length);
+    buffer[length] = '\0';
+    return strtod(buffer, NULL);
+}
@@ -0,0 +1,43 @@
+/*
+ * json_number.h - Conversion of JSON number tokens to cuOpt types
+ *
+ * The streaming front ends hand over the raw text of each number token
+ * (not NUL-terminated), so these helpers work on (pointer, length) spans.
+ */
+
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+#include <stddef.h>
+#include <cuopt/linear_programming/cuopt_c.h>
+
+typedef enum {
+    JSON_NUMBER_OK = 0,
+    JSON_NUMBER_INVALID = -1,        // not a JSON number
+    JSON_NUMBER_OVERFLOW = -2,       // integer does not fit in cuopt_int_t
+    JSON_NUMBER_NOT_INTEGRAL = -3    // number has a fractional part
+} JsonNumberStatus;
+
+// Return the end of the number token starting at p, or NULL if the text
+// does not follow the JSON number grammar
+const char* json_number_scan(const char* p, const char* end);
+
+// Convert a JSON number token to a float. Returns 0 on success, -1 if the
+// token is not a valid number.
+int json_number_to_float(const char* text, size_t length, cuopt_float_t* value);
+
+// Parse the integer token at the start of [p, end). Digit runs are
+// converted eight bytes at a time without going through a double; tokens
+// with a fraction or exponent are accepted only when their value is
+// integral. On return *next points just past the token (if it was a number).
+JsonNumberStatus json_number_parse_int(const char* p, const char* end, cuopt_int_t* value,
+                                       const char** next);
+
+// Convert a whole JSON number token to an integer
+JsonNumberStatus json_number_to_int(const char* text, size_t length, cuopt_int_t* value);
+
+// Convert a string-encoded number ("inf", "-inf", "1.5", ...) the same way
+// parse_numeric_value does for cJSON string items.
+cuopt_float_t parse_numeric_string(const char* str, size_t length);
+
+#endif // JSON_NUMBER_H
@@ -0,0 +1,387 @@
+/*
+ * json_sax.c - Streaming event-driven (SAX-style) JSON tokenizer
+ *
+ * The tokenizer is a small state machine over the input buffer with an
+ * explicit container stack, so deep documents cannot overflow the C stack
+ * and no per-token heap allocation takes place.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "json_sax.h"
+
+#include "json_number.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char* p;
+    const char* end;
+    
+    // Scratch space for strings that contain escape sequences
+    char* scratch;
+    size_t scratch_capacity;
+} SaxState;
+
+static const char* skip_whitespace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+        p++;
+    }
+    return p;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Read the four hex digits of a \u escape starting at p
+static long parse_hex4(const char* p, const char* end) {
+    if (end - p < 4) {
+        return -1;
+    }
+    long code = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(p[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        code = (code << 4) | digit;
+    }
+    return code;
+}
+
+static char* encode_utf8(char* out, unsigned long code) {
+    if (code < 0x80) {
+        *out++ = (char)code;
+    } else if (code < 0x800) {
+        *out++ = (char)(0xC0 | (code >> 6));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        *out++ = (char)(0xE0 | (code >> 12));
+        *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    } else {
+        *out++ = (char)(0xF0 | (code >> 18));
+        *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    }
+    return out;
+}
+
+// The decoded form is never longer than the raw form, so the scratch buffer
+// only needs to hold `length` bytes.
+JsonSaxStatus json_sax_unescape(const char* raw, size_t length,
+                                char** scratch, size_t* scratch_capacity,
+                                size_t* out_length, const char** error_pos) {
+    if (length > *scratch_capacity) {
+        char* grown = realloc(*scratch, length);
+        if (!grown) {
+            return JSON_SAX_OUT_OF_MEMORY;
+        }
+        *scratch = grown;
+        *scratch_capacity = length;
+    }
+    
+    const char* stop = raw + length;
+    char* out = *scratch;
+    const char* r = raw;
+    while (r < stop) {
+        if (*r != '\\') {
+            *out++ = *r++;
+            continue;
+        }
+        r++;
+        if (r >= stop) {
+            *error_pos = r - 1;
+            return JSON_SAX_SYNTAX_ERROR;
+        }
+        switch (*r) {
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = *r++;
+                break;
+            case 'b': *out++ = '\b'; r++; break;
+            case 'f': *out++ = '\f'; r++; break;
+            case 'n': *out++ = '\n'; r++; break;
+            case 'r': *out++ = '\r'; r++; break;
+            case 't': *out++ = '\t'; r++; break;
+            case 'u': {
+                long code = parse_hex4(r + 1, stop);
+                if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF)) {
+                    *error_pos = r;
+                    return JSON_SAX_SYNTAX_ERROR;
+                }
+                r += 5;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // UTF-16 surrogate pair
+                    if (stop - r < 6 || r[0] != '\\' || r[1] != 'u') {
+                        *error_pos = r;
+                        return JSON_SAX_SYNTAX_ERROR;
+                    }
+                    long low = parse_hex4(r + 2, stop);
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        *error_pos = r;
+                        return JSON_SAX_SYNTAX_ERROR;
+                    }
+                    code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+                    r += 6;
+                }
+                out = encode_utf8(out, (unsigned long)code);
+                break;
+            }
+            default:
+                *error_pos = r;
+                return JSON_SAX_SYNTAX_ERROR;
+        }
+    }
+    
+    *out_length = (size_t)(out - *scratch);
+    return JSON_SAX_OK;
+}
+
+// Scan a string whose opening quote is at s->p and advance past the closing
+// quote. Strings without escapes are returned in place.
+static JsonSaxStatus scan_string(SaxState* s, const char** str, size_t* length) {
+    const char* start = s->p + 1;
+    const char* q = start;
+    int has_escape = 0;
+    
+    while (q < s->end && *q != '"') {
+        if (*q == '\\') {
+            has_escape = 1;
+            if (s->end - q < 2) {
+                q = s->end;
+                break;
+            }
+            q += 2;
+        } else {
+            q++;
+        }
+    }
+    if (q >= s->end) {
+        s->p = s->end;
+        return JSON_SAX_SYNTAX_ERROR;
+    }
+    
+    if (has_escape) {
+        const char* error_pos = start;
+        JsonSaxStatus status = json_sax_unescape(start, (size_t)(q - start), &s->scratch,
+                                                 &s->scratch_capacity, length, &error_pos);
+        if (status != JSON_SAX_OK) {
+            s->p = error_pos;
+            return status;
+        }
+        *str = s->scratch;
+    } else {
+        *str = start;
+        *length = (size_t)(q - start);
+    }
+    s->p = q + 1;
+    return JSON_SAX_OK;
+}
+
+static int match_literal(const char* p, const char* end, const char* literal, size_t length) {
+    return (size_t)(end - p) >= length && memcmp(p, literal, length) == 0;
+}
+
+// Invoke a callback if it is set; abort the parse if it asks to
+#define EMIT(callback, args)                                    \
+    do {                                                        \
+        if (handler->callback && handler->callback args != 0) { \
+            status = JSON_SAX_ABORTED;                          \
+            goto done;                                          \
+        }                                                       \
+    } while (0)
+
+JsonSaxStatus json_sax_parse(const char* text, size_t length,
+                             const JsonSaxHandler* handler, void* user,
+                             size_t* error_offset) {
+    SaxState s;
+    s.p = text;
+    s.end = text + length;
+    s.scratch = NULL;
+    s.scratch_capacity = 0;
+    
+    char stack[JSON_SAX_NESTING_LIMIT];
+    int depth = 0;
+    JsonSaxStatus status = JSON_SAX_OK;
+    const char* str;
+    size_t str_length;
+    
+value:
+    s.p = skip_whitespace(s.p, s.end);
+    if (s.p >= s.end) {
+        goto syntax_error;
+    }
+    switch (*s.p) {
+        case '{':
+            if (depth >= JSON_SAX_NESTING_LIMIT) {
+                status = JSON_SAX_NESTING_TOO_DEEP;
+                goto done;
+            }
+            stack[depth++] = '{';
+            EMIT(start_object, (user));
+            s.p = skip_whitespace(s.p + 1, s.end);
+            if (s.p < s.end && *s.p == '}') {
+                s.p++;
+                depth--;
+                EMIT(end_object, (user));
+                goto after_value;
+            }
+            goto key;
+        case '[':
+            if (handler->raw_array) {
+                const char* resume = NULL;
+                EMIT(raw_array, (user, s.p, s.end, &resume));
+                if (resume) {
+                    s.p = resume;
+                    goto after_value;
+                }
+            }
+            if (depth >= JSON_SAX_NESTING_LIMIT) {
+                status = JSON_SAX_NESTING_TOO_DEEP;
+                goto done;
+            }
+            stack[depth++] = '[';
+            EMIT(start_array, (user));
+            s.p = skip_whitespace(s.p + 1, s.end);
+            if (s.p < s.end && *s.p == ']') {
+                s.p++;
+                depth--;
+                EMIT(end_array, (user));
+                goto after_value;
+            }
+            goto value;
+        case '"':
+            status = scan_string(&s, &str, &str_length);
+            if (status != JSON_SAX_OK) {
+                goto done;
+            }
+            EMIT(string_value, (user, str, str_length));
+            goto after_value;
+        case 't':
+            if (!match_literal(s.p, s.end, "true", 4)) {
+                goto syntax_error;
+            }
+            s.p += 4;
+            EMIT(bool_value, (user, 1));
+            goto after_value;
+        case 'f':
+            if (!match_literal(s.p, s.end, "false", 5)) {
+                goto syntax_error;
+            }
+            s.p += 5;
+            EMIT(bool_value, (user, 0));
+            goto after_value;
+        case 'n':
+            if (!match_literal(s.p, s.end, "null", 4)) {
+                goto syntax_error;
+            }
+            s.p += 4;
+            EMIT(null_value, (user));
+            goto after_value;
+        default: {
+            const char* number_end = json_number_scan(s.p, s.end);
+            if (!number_end) {
+                goto syntax_error;
+            }
+            const char* number = s.p;
+            s.p = number_end;
+            EMIT(number_value, (user, number, (size_t)(number_end - number)));
+            goto after_value;
+        }
+    }
+    
+key:
+    if (s.p >= s.end || *s.p != '"') {
+        goto syntax_error;
+    }
+    status = scan_string(&s, &str, &str_length);
+    if (status != JSON_SAX_OK) {
+        goto done;
+    }
+    EMIT(key, (user, str, str_length));
+    s.p = skip_whitespace(s.p, s.end);
+    if (s.p >= s.end || *s.p != ':') {
+        goto syntax_error;
+    }
+    s.p++;
+    goto value;
+    
+after_value:
+    s.p = skip_whitespace(s.p, s.end);
+    if (depth == 0) {
+        if (s.p != s.end) {
+            goto syntax_error;
+        }
+        goto done;
+    }
+    if (s.p >= s.end) {
+        goto syntax_error;
+    }
+    if (*s.p == ',') {
+        s.p = skip_whitespace(s.p + 1, s.end);
+        if (stack[depth - 1] == '{') {
+            goto key;
+        }
+        goto value;
+    }
+    if (*s.p == '}' && stack[depth - 1] == '{') {
+        s.p++;
+        depth--;
+        EMIT(end_object, (user));
+        goto after_value;
+    }
+    if (*s.p == ']' && stack[depth - 1] == '[') {
+        s.p++;
+        depth--;
+        EMIT(end_array, (user));
+        goto after_value;
+    }
+    
+syntax_error:
+    status = JSON_SAX_SYNTAX_ERROR;
+    
+done:
+    free(s.scratch);
+    if (status != JSON_SAX_OK && error_offset) {
+        *error_offset = (size_t)(s.p - text);
+    }
+    return status;
+}
+
+#undef EMIT
+
+void json_sax_print_error(FILE* out, const char* text, size_t length,
+                          JsonSaxStatus status, size_t error_offset) {
+    if (error_offset > length) {
+        error_offset = length;
+    }
+    size_t line = 1;
+    size_t column = 1;
+    for (size_t i = 0; i < error_offset; i++) {
+        if (text[i] == '\n') {
+            line++;
+            column = 1;
+        } else {
+            column++;
+        }
+    }
+    
+    const char* reason;
+    switch (status) {
+        case JSON_SAX_SYNTAX_ERROR: reason = "syntax error"; break;
+        case JSON_SAX_NESTING_TOO_DEEP: reason = "nesting too deep"; break;
+        case JSON_SAX_OUT_OF_MEMORY: reason = "out of memory"; break;
+        case JSON_SAX_ABORTED: reason = "invalid problem data"; break;
+        default: reason = "unknown error"; break;
+    }
+    fprintf(out, "Error: Failed to parse JSON (%s at line %zu, column %zu)\n", reason, line, column);
+}
@@ -0,0 +1,70 @@
+/*
+ * json_sax.h - Streaming event-driven (SAX-style) JSON tokenizer
+ *
+ * Walks a JSON document held in memory and reports each token to a set of
+ * callbacks as it is recognized, without building a tree. Number tokens are
+ * passed through as raw text so the consumer decides how to convert them.
+ * Strings are passed without quotes; escape sequences are decoded into a
+ * scratch buffer only when the string actually contains one.
+ *
+ * Every callback returns 0 to continue or non-zero to abort the parse.
+ * Callbacks left NULL are skipped.
+ *
+ * raw_array lets a consumer take over an array wholesale: it is offered the
+ * text from the array's '[' to the end of the input before the array is
+ * tokenized. Setting *resume just past the closing ']' skips the array (no
+ * start_array, element or end_array events follow); leaving it NULL lets
+ * the tokenizer process the array as usual.
+ */
+
+#ifndef JSON_SAX_H
+#define JSON_SAX_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+typedef struct {
+    int (*start_object)(void* user);
+    int (*end_object)(void* user);
+    int (*start_array)(void* user);
+    int (*end_array)(void* user);
+    int (*key)(void* user, const char* str, size_t length);
+    int (*string_value)(void* user, const char* str, size_t length);
+    int (*number_value)(void* user, const char* text, size_t length);
+    int (*bool_value)(void* user, int value);
+    int (*null_value)(void* user);
+    int (*raw_array)(void* user, const char* begin, const char* end, const char** resume);
+} JsonSaxHandler;
+
+// Maximum nesting depth accepted, matching cJSON's default limit
+#define JSON_SAX_NESTING_LIMIT 1000
+
+// Result of json_sax_parse
+typedef enum {
+    JSON_SAX_OK = 0,
+    JSON_SAX_SYNTAX_ERROR,
+    JSON_SAX_NESTING_TOO_DEEP,
+    JSON_SAX_OUT_OF_MEMORY,
+    JSON_SAX_ABORTED  // a callback returned non-zero
+} JsonSaxStatus;
+
+// Parse `length` bytes of `text`. The buffer does not need to be
+// NUL-terminated. On failure, *error_offset (if given) receives the byte
+// offset where parsing stopped.
+JsonSaxStatus json_sax_parse(const char* text, size_t length,
+                             const JsonSaxHandler* handler, void* user,
+                             size_t* error_offset);
+
+// Decode the escape sequences in the raw contents of a string (without the
+// quotes) into *scratch, growing it as needed. Used by front ends that find
+// string boundaries themselves. On a bad escape, *error_pos points at it.
+JsonSaxStatus json_sax_unescape(const char* raw, size_t length,
+                                char** scratch, size_t* scratch_capacity,
+                                size_t* out_length, const char** error_pos);
+
+// Print a one-line description of a failed parse, with line and column,
+// to `out`
+void json_sax_print_error(FILE* out, const char* text, size_t length,
+                          JsonSaxStatus status, size_t error_offset);
+
+#endif // JSON_SAX_H
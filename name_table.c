@@ -0,0 +1,143 @@
+/*
+ * name_table.c - Variable and constraint names with a lookup index
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "name_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "hash64.h"
+
+// Initial capacities; both grow by doubling afterwards
+#define NAME_TABLE_INITIAL_NAMES 1024
+#define NAME_TABLE_INITIAL_BYTES (16 * NAME_TABLE_INITIAL_NAMES)
+
+// Fewest slots an index gets, so tiny tables still probe short
+#define NAME_TABLE_MIN_SLOTS 16
+
+NameTable* name_table_create(const JobContext* ctx) {
+    NameTable* table = calloc(1, sizeof(NameTable));
+    if (!table) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+    }
+    return table;
+}
+
+void name_table_free(NameTable* table) {
+    if (table) {
+        free(table->arena);
+        free(table->offsets);
+        free(table->slots);
+        free(table);
+    }
+}
+
+// Grow a buffer by doubling until it holds `needed` elements
+static int reserve(void** buffer, size_t* capacity, size_t needed, size_t initial,
+                   size_t elem_size) {
+    if (needed <= *capacity) {
+        return 0;
+    }
+    size_t grown = *capacity ? *capacity : initial;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    void* data = realloc(*buffer, grown * elem_size);
+    if (!data) {
+        return -1;
+    }
+    *buffer = data;
+    *capacity = grown;
+    return 0;
+}
+
+int name_table_append(const JobContext* ctx, NameTable* table, const char* name, size_t length) {
+    if (reserve((void**)&table->offsets, &table->offsets_capacity, (size_t)table->count + 1,
+                NAME_TABLE_INITIAL_NAMES, sizeof(size_t)) != 0 ||
+        reserve((void**)&table->arena, &table->arena_capacity, table->arena_size + length + 1,
+                NAME_TABLE_INITIAL_BYTES, 1) != 0) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        return -1;
+    }
+    char* copy = table->arena + table->arena_size;
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    table->offsets[table->count++] = table->arena_size;
+    table->arena_size += length + 1;
+    return 0;
+}
+
+const char* name_table_get(const NameTable* table, cuopt_int_t index) {
+    return table->arena + table->offsets[index];
+}
+
+// Slot holding `name`, or the free slot where it would go
+static size_t probe(const NameTable* table, const char* name, size_t length) {
+    size_t mask = table->num_slots - 1;
+    size_t slot = (size_t)hash64(name, length, 0) & mask;
+    for (;;) {
+        cuopt_int_t entry = table->slots[slot];
+        if (entry == 0) {
+            return slot;
+        }
+        const char* candidate = name_table_get(table, entry - 1);
+        if (strncmp(candidate, name, length) == 0 && candidate[length] == '\0') {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+// Build the hash index; a name that occurs more than once keeps its first
+// position. Returns 0 on success, -1 if out of memory.
+static int build_index(NameTable* table) {
+    size_t num_slots = NAME_TABLE_MIN_SLOTS;
+    while (num_slots < 2 * (size_t)table->count) {
+        num_slots *= 2;
+    }
+    table->slots = calloc(num_slots, sizeof(cuopt_int_t));
+    if (!table->slots) {
+        return -1;
+    }
+    table->num_slots = num_slots;
+    for (cuopt_int_t i = 0; i < table->count; i++) {
+        const char* name = name_table_get(table, i);
+        size_t slot = probe(table, name, strlen(name));
+        if (table->slots[slot] == 0) {
+            table->slots[slot] = i + 1;
+        }
+    }
+    return 0;
+}
+
+cuopt_int_t name_table_find(NameTable* table, const char* name, size_t length) {
+    if (!table->slots && build_index(table) != 0) {
+        return -1;
+    }
+    return table->slots[probe(table, name, length)] - 1;
+}
+
+void name_table_finish(NameTable* table) {
+    if (table->arena_size < table->arena_capacity) {
+        char* arena = realloc(table->arena, table->arena_size ? table->arena_size : 1);
+        if (arena) {
+            table->arena = arena;
+            table->arena_capacity = table->arena_size ? table->arena_size : 1;
+        }
+    }
+    if ((size_t)table->count < table->offsets_capacity) {
+        size_t* offsets = realloc(table->offsets, (table->count ? (size_t)table->count : 1) *
+                                                  sizeof(size_t));
+        if (offsets) {
+            table->offsets = offsets;
+            table->offsets_capacity = table->count ? (size_t)table->count : 1;
+        }
+    }
+}
+
+size_t name_table_bytes(const NameTable* table) {
+    return table->arena_capacity + table->offsets_capacity * sizeof(size_t) +
+           table->num_slots * sizeof(cuopt_int_t);
+}
@@ -0,0 +1,57 @@
+/*
+ * name_table.h - Variable and constraint names with a lookup index
+ *
+ * Models can carry millions of names, so they are not kept as one heap
+ * string each. A table holds all its names back to back in a single
+ * arena, NUL-terminated, with an offsets array giving where each starts.
+ * Appending copies a name to the end of the arena; both grow by doubling.
+ *
+ * Lookups from name to position go through an open-addressing hash index
+ * with linear probing: a power-of-two array of at least twice as many
+ * slots as names, each holding a position + 1 (0 marks a free slot). Most
+ * runs only print names by position, so the index is built by the first
+ * lookup rather than by every parse. A name costs its bytes plus one
+ * terminator and an offset, and two slots once the table is indexed.
+ */
+
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <stddef.h>
+#include "cuopt_json_to_c_api.h"
+
+struct NameTable {
+    cuopt_int_t count;
+    char* arena;               // the names, each NUL-terminated
+    size_t arena_size;
+    size_t arena_capacity;
+    size_t* offsets;           // start of each name in the arena
+    size_t offsets_capacity;
+    cuopt_int_t* slots;        // hash index, NULL until the first lookup
+    size_t num_slots;
+};
+
+// Returns NULL on failure (an error has been printed)
+NameTable* name_table_create(const JobContext* ctx);
+void name_table_free(NameTable* table);
+
+// Append a copy of `length` bytes of `name`. Returns 0 on success, -1 on
+// failure (an error has been printed).
+int name_table_append(const JobContext* ctx, NameTable* table, const char* name, size_t length);
+
+// Name at `index`, NUL-terminated
+const char* name_table_get(const NameTable* table, cuopt_int_t index);
+
+// Give back the capacity doubling left unused once every name is in
+void name_table_finish(NameTable* table);
+
+// Position of the name `name` (`length` bytes), or -1 if the table does
+// not have it (or its index could not be allocated). The first call builds
+// the index, so calls on one table must not run concurrently. A name that
+// occurs more than once is found at its first position.
+cuopt_int_t name_table_find(NameTable* table, const char* name, size_t length);
+
+// Bytes held by the table: arena, offsets and index (if built)
+size_t name_table_bytes(const NameTable* table);
+
+#endif // NAME_TABLE_H
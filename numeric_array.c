@@ -0,0 +1,212 @@
+/*
+ * numeric_array.c - Parallel conversion of large JSON numeric arrays
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "numeric_array.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <cuopt/linear_programming/cuopt_c.h>
+#include "json_number.h"
+
+// Smallest chunk worth handing to a thread
+#define MIN_CHUNK_BYTES (64 * 1024)
+
+// Chunks per thread, so uneven chunks still balance out
+#define CHUNKS_PER_THREAD 4
+
+typedef struct {
+    NumericArrayPlan* plan;
+    size_t* counts;
+    int nested;
+} CountJob;
+
+static int is_whitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Count the commas in one chunk and reject nested containers
+static void count_chunk(void* arg, size_t chunk) {
+    CountJob* job = arg;
+    const char* p = job->plan->starts[chunk];
+    const char* end = job->plan->starts[chunk + 1];
+    size_t commas = 0;
+    int nested = 0;
+    for (; p < end; p++) {
+        char c = *p;
+        commas += (c == ',');
+        nested |= (c == '[') | (c == '{');
+    }
+    job->counts[chunk] = commas;
+    if (nested) {
+        __atomic_store_n(&job->nested, 1, __ATOMIC_RELAXED);
+    }
+}
+
+int numeric_array_plan(const char* body, size_t length, ThreadPool* pool, NumericArrayPlan* plan) {
+    memset(plan, 0, sizeof(NumericArrayPlan));
+    plan->body = body;
+    plan->length = length;
+    
+    size_t num_chunks = (size_t)thread_pool_size(pool) * CHUNKS_PER_THREAD;
+    if (num_chunks > length / MIN_CHUNK_BYTES) {
+        num_chunks = length / MIN_CHUNK_BYTES;
+    }
+    if (num_chunks == 0) {
+        num_chunks = 1;
+    }
+    plan->num_chunks = num_chunks;
+    plan->starts = malloc((num_chunks + 1) * sizeof(const char*));
+    plan->first_index = malloc(num_chunks * sizeof(size_t));
+    size_t* counts = malloc(num_chunks * sizeof(size_t));
+    if (!plan->starts || !plan->first_index || !counts) {
+        free(counts);
+        numeric_array_plan_free(plan);
+        return -1;
+    }
+    
+    // Move every split point just past the next comma, so chunks hold whole
+    // elements and every element but the very last ends in a comma
+    const char* end = body + length;
+    plan->starts[0] = body;
+    plan->starts[num_chunks] = end;
+    for (size_t i = 1; i < num_chunks; i++) {
+        const char* split = body + (length / num_chunks) * i;
+        if (split < plan->starts[i - 1]) {
+            split = plan->starts[i - 1];
+        }
+        const char* comma = memchr(split, ',', (size_t)(end - split));
+        plan->starts[i] = comma ? comma + 1 : end;
+    }
+    
+    CountJob job = { plan, counts, 0 };
+    thread_pool_parallel_for(pool, num_chunks, count_chunk, &job);
+    if (job.nested) {
+        free(counts);
+        numeric_array_plan_free(plan);
+        return -1;
+    }
+    
+    size_t total = 0;
+    for (size_t i = 0; i < num_chunks; i++) {
+        plan->first_index[i] = total;
+        total += counts[i];
+    }
+    free(counts);
+    
+    // n commas separate n + 1 elements, unless the array is empty. A
+    // trailing comma would leave the last element to no chunk, so reject it.
+    const char* last = end;
+    while (last > body && is_whitespace(last[-1])) {
+        last--;
+    }
+    if (last > body && last[-1] == ',') {
+        numeric_array_plan_free(plan);
+        return -1;
+    }
+    plan->count = (last == body) ? 0 : total + 1;
+    return 0;
+}
+
+typedef struct {
+    const NumericArrayPlan* plan;
+    NumericArrayType type;
+    void* out;
+    int failed;
+} ParseJob;
+
+// Convert one trimmed float element
+static int convert_float(const char* s, const char* e, cuopt_float_t* values, size_t index) {
+    if (s == e) {
+        return -1;
+    }
+    if (*s == '"') {
+        // Bounds written as strings, e.g. "inf"; anything with escapes or
+        // embedded quotes goes back to the tokenizer
+        if (e - s < 2 || e[-1] != '"' || memchr(s + 1, '"', (size_t)(e - s - 2)) ||
+            memchr(s + 1, '\\', (size_t)(e - s - 2))) {
+            return -1;
+        }
+        values[index] = parse_numeric_string(s + 1, (size_t)(e - s - 2));
+        return 0;
+    }
+    return json_number_to_float(s, (size_t)(e - s), values + index);
+}
+
+// Integer chunks are parsed in place: each token is read straight from the
+// array body, so the eight-byte digit loads may look past the chunk end
+// (never past the body) and no separate comma search is needed
+static int parse_int_chunk(const NumericArrayPlan* plan, const char* p, const char* end,
+                           cuopt_int_t* values, size_t index) {
+    const char* body_end = plan->body + plan->length;
+    while (p < end) {
+        while (p < end && is_whitespace(*p)) p++;
+        const char* next;
+        if (p == end || json_number_parse_int(p, body_end, &values[index++], &next) != JSON_NUMBER_OK ||
+            next > end) {
+            return -1;
+        }
+        p = next;
+        while (p < end && is_whitespace(*p)) p++;
+        if (p < end) {
+            if (*p != ',') {
+                return -1;
+            }
+            p++;
+        }
+    }
+    return 0;
+}
+
+// Float chunks split each token at the next comma first
+static int parse_float_chunk(const char* p, const char* end, cuopt_float_t* values, size_t index) {
+    while (p < end) {
+        const char* comma = memchr(p, ',', (size_t)(end - p));
+        const char* token_end = comma ? comma : end;
+        
+        const char* s = p;
+        const char* e = token_end;
+        while (s < e && is_whitespace(*s)) s++;
+        while (e > s && is_whitespace(e[-1])) e--;
+        
+        if (convert_float(s, e, values, index++) != 0) {
+            return -1;
+        }
+        p = comma ? comma + 1 : end;
+    }
+    return 0;
+}
+
+// Every chunk but the last non-empty one ends just after a comma, so each
+// chunk converts exactly the elements it counted in numeric_array_plan
+static void parse_chunk(void* arg, size_t chunk) {
+    ParseJob* job = arg;
+    const NumericArrayPlan* plan = job->plan;
+    const char* p = plan->starts[chunk];
+    const char* end = plan->starts[chunk + 1];
+    size_t index = plan->first_index[chunk];
+    
+    int status = (job->type == NUMERIC_ARRAY_INT)
+                     ? parse_int_chunk(plan, p, end, job->out, index)
+                     : parse_float_chunk(p, end, job->out, index);
+    if (status != 0) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+int numeric_array_parse(const NumericArrayPlan* plan, NumericArrayType type, void* out, ThreadPool* pool) {
+    if (plan->count == 0) {
+        return 0;
+    }
+    ParseJob job = { plan, type, out, 0 };
+    thread_pool_parallel_for(pool, plan->num_chunks, parse_chunk, &job);
+    return job.failed ? -1 : 0;
+}
+
+void numeric_array_plan_free(NumericArrayPlan* plan) {
+    free(plan->starts);
+    free(plan->first_index);
+    memset(plan, 0, sizeof(NumericArrayPlan));
+}
@@ -0,0 +1,41 @@
+/*
+ * numeric_array.h - Parallel conversion of large JSON numeric arrays
+ *
+ * The body of an array (the text between '[' and ']') is cut into chunks at
+ * comma boundaries. A first parallel pass counts the elements of every
+ * chunk so each chunk knows the output index of its first element; a second
+ * parallel pass converts the chunks straight into the preallocated output.
+ */
+
+#ifndef NUMERIC_ARRAY_H
+#define NUMERIC_ARRAY_H
+
+#include <stddef.h>
+#include "thread_pool.h"
+
+typedef enum {
+    NUMERIC_ARRAY_INT,    // cuopt_int_t elements
+    NUMERIC_ARRAY_FLOAT   // cuopt_float_t elements, "inf"-style strings allowed
+} NumericArrayType;
+
+typedef struct {
+    const char* body;
+    size_t length;
+    size_t count;          // total number of elements
+    size_t num_chunks;
+    const char** starts;   // num_chunks + 1 chunk boundaries
+    size_t* first_index;   // output index of each chunk's first element
+} NumericArrayPlan;
+
+// Split `body` into chunks and count its elements. Returns -1 if the body
+// holds nested arrays or objects, which this path does not handle.
+int numeric_array_plan(const char* body, size_t length, ThreadPool* pool, NumericArrayPlan* plan);
+
+// Convert every element into `out`, which must hold plan->count elements.
+// Returns -1 if any element is malformed; nothing is printed so the caller
+// can fall back to the regular tokenizer for a precise error message.
+int numeric_array_parse(const NumericArrayPlan* plan, NumericArrayType type, void* out, ThreadPool* pool);
+
+void numeric_array_plan_free(NumericArrayPlan* plan);
+
+#endif // NUMERIC_ARRAY_H
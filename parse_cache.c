@@ -0,0 +1,273 @@
+/*
+ * parse_cache.c - Content-addressed cache of parsed problems
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "parse_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "hash64.h"
+#include "input_file.h"
+#include "problem_binary.h"
+
+// Inputs are hashed in blocks of this size on the thread pool; the key is
+// the hash of the block hashes
+#define HASH_BLOCK_SIZE (4 << 20)
+
+// Bump when the parsers change what they produce, so old entries stop
+// matching instead of returning stale data
+#define CACHE_FORMAT_SEED (0xC0DE0000ULL + PROBLEM_BINARY_VERSION)
+
+#define ENTRY_SUFFIX ".cuopt.bin"
+#define MEMO_PREFIX "stat-"
+#define TEMP_SUFFIX ".part"
+
+// Memos and abandoned temporary files older than this are removed
+#define STALE_FILE_SECONDS (7 * 24 * 3600)
+
+typedef struct {
+    const char* data;
+    size_t size;
+    size_t num_blocks;
+    uint64_t* block_hashes;
+} HashJob;
+
+static void hash_block(void* arg, size_t index) {
+    HashJob* job = arg;
+    size_t start = index * HASH_BLOCK_SIZE;
+    size_t length = job->size - start < HASH_BLOCK_SIZE ? job->size - start : HASH_BLOCK_SIZE;
+    job->block_hashes[index] = hash64(job->data + start, length, CACHE_FORMAT_SEED);
+}
+
+// Hash the file contents, in parallel blocks
+static int hash_contents(JobContext* ctx, const char* filename, uint64_t* hash) {
+    InputFile input;
+    if (input_file_open(ctx, filename, &input) != 0) {
+        return -1;
+    }
+    HashJob job;
+    job.data = input.data;
+    job.size = input.size;
+    job.num_blocks = (input.size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE;
+    job.block_hashes = malloc((job.num_blocks + 1) * sizeof(uint64_t));
+    if (!job.block_hashes) {
+        input_file_close(&input);
+        return -1;
+    }
+    thread_pool_parallel_for(job_thread_pool(ctx), job.num_blocks, hash_block, &job);
+    *hash = hash64(job.block_hashes, job.num_blocks * sizeof(uint64_t), CACHE_FORMAT_SEED);
+    free(job.block_hashes);
+    input_file_close(&input);
+    return 0;
+}
+
+static void join_path(char* out, size_t size, const char* dir, const char* name) {
+    snprintf(out, size, "%s/%s", dir, name);
+}
+
+static int has_suffix(const char* name, const char* suffix) {
+    size_t n = strlen(name), m = strlen(suffix);
+    return n >= m && strcmp(name + n - m, suffix) == 0;
+}
+
+// Name for a temporary file that no other process or thread is using
+static void temp_path_for(char* out, size_t size, const char* dir, const char* name) {
+    static unsigned long counter = 0;
+    unsigned long id = __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+    snprintf(out, size, "%s/%s.%ld.%lu" TEMP_SUFFIX, dir, name, (long)getpid(), id);
+}
+
+// Write `length` bytes to a temporary file and rename it over `path`
+static int publish_file(const char* dir, const char* path, const char* bytes, size_t length) {
+    char temp_path[4096];
+    temp_path_for(temp_path, sizeof(temp_path), dir, "memo");
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return -1;
+    }
+    int failed = fwrite(bytes, 1, length, file) != length;
+    failed |= fclose(file) != 0;
+    if (failed || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int parse_cache_key(JobContext* ctx, const char* dir, const char* filename, ParseCacheKey* key) {
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        job_printf(ctx, "Warning: Cannot create parse cache directory %s\n", dir);
+        return -1;
+    }
+    
+    struct stat st;
+    if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+    
+    // A file with the same identity and mtime as last time has the same
+    // contents, so reuse the hash computed then
+    struct {
+        uint64_t dev, ino, size;
+        int64_t mtime_sec, mtime_nsec;
+    } identity;
+    memset(&identity, 0, sizeof(identity));
+    identity.dev = (uint64_t)st.st_dev;
+    identity.ino = (uint64_t)st.st_ino;
+    identity.size = (uint64_t)st.st_size;
+    identity.mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    identity.mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    
+    char memo_name[64];
+    char memo_path[4096];
+    snprintf(memo_name, sizeof(memo_name), MEMO_PREFIX "%016llx",
+             (unsigned long long)hash64(&identity, sizeof(identity), CACHE_FORMAT_SEED));
+    join_path(memo_path, sizeof(memo_path), dir, memo_name);
+    
+    FILE* memo = fopen(memo_path, "rb");
+    if (memo) {
+        size_t n = fread(key->name, 1, sizeof(key->name) - 1, memo);
+        fclose(memo);
+        key->name[n] = '\0';
+        if (n > 0 && has_suffix(key->name, ENTRY_SUFFIX) && !strchr(key->name, '/')) {
+            return 0;
+        }
+    }
+    
+    uint64_t hash;
+    if (hash_contents(ctx, filename, &hash) != 0) {
+        return -1;
+    }
+    snprintf(key->name, sizeof(key->name), "%016llx-%llu" ENTRY_SUFFIX, (unsigned long long)hash,
+             (unsigned long long)st.st_size);
+    
+    // The memo is only an optimization; losing it costs one rehash
+    publish_file(dir, memo_path, key->name, strlen(key->name));
+    return 0;
+}
+
+int parse_cache_load(JobContext* ctx, const char* dir, const ParseCacheKey* key, ProblemData* data) {
+    char path[4096];
+    join_path(path, sizeof(path), dir, key->name);
+    
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return 1;
+    }
+    if (problem_binary_load(ctx, path, data) != 0) {
+        job_printf(ctx, "Warning: Removing unusable parse cache entry %s\n", path);
+        unlink(path);
+        return 1;
+    }
+    
+    // Refresh the entry for LRU eviction
+    utimensat(AT_FDCWD, path, NULL, 0);
+    return 0;
+}
+
+typedef struct {
+    char name[256];
+    uint64_t size;
+    time_t mtime;
+} CacheEntry;
+
+static int compare_entries_by_age(const void* a, const void* b) {
+    const CacheEntry* x = a;
+    const CacheEntry* y = b;
+    return (x->mtime > y->mtime) - (x->mtime < y->mtime);
+}
+
+// Remove least recently used entries (never `keep`) until the total size of
+// the entries is at most max_bytes, plus stale memos and temporary files
+static void evict(const char* dir, const char* keep, uint64_t max_bytes) {
+    DIR* handle = opendir(dir);
+    if (!handle) {
+        return;
+    }
+    
+    CacheEntry* entries = NULL;
+    size_t count = 0, capacity = 0;
+    uint64_t total = 0;
+    time_t now = time(NULL);
+    struct dirent* ent;
+    char path[4096];
+    while ((ent = readdir(handle)) != NULL) {
+        const char* name = ent->d_name;
+        int is_entry = has_suffix(name, ENTRY_SUFFIX);
+        int is_scratch = has_suffix(name, TEMP_SUFFIX) || strncmp(name, MEMO_PREFIX, strlen(MEMO_PREFIX)) == 0;
+        if ((!is_entry && !is_scratch) || strlen(name) >= sizeof(entries[0].name)) {
+            continue;
+        }
+        join_path(path, sizeof(path), dir, name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        if (is_scratch) {
+            if (now - st.st_mtime > STALE_FILE_SECONDS) {
+                unlink(path);
+            }
+            continue;
+        }
+        if (count == capacity) {
+            size_t grown_capacity = capacity ? capacity * 2 : 64;
+            CacheEntry* grown = realloc(entries, grown_capacity * sizeof(CacheEntry));
+            if (!grown) {
+                break;
+            }
+            entries = grown;
+            capacity = grown_capacity;
+        }
+        strcpy(entries[count].name, name);
+        entries[count].size = (uint64_t)st.st_size;
+        entries[count].mtime = st.st_mtime;
+        total += (uint64_t)st.st_size;
+        count++;
+    }
+    closedir(handle);
+    
+    if (total > max_bytes) {
+        qsort(entries, count, sizeof(CacheEntry), compare_entries_by_age);
+        for (size_t i = 0; i < count && total > max_bytes; i++) {
+            if (strcmp(entries[i].name, keep) == 0) {
+                continue;
+            }
+            join_path(path, sizeof(path), dir, entries[i].name);
+            // Another process may have evicted it already; processes that
+            // still have it mapped keep their view
+            if (unlink(path) == 0 || errno == ENOENT) {
+                total -= entries[i].size;
+            }
+        }
+    }
+    free(entries);
+}
+
+void parse_cache_store(JobContext* ctx, const char* dir, const ParseCacheKey* key,
+                       const ProblemData* data, uint64_t max_bytes) {
+    char path[4096];
+    char temp_path[4096];
+    join_path(path, sizeof(path), dir, key->name);
+    temp_path_for(temp_path, sizeof(temp_path), dir, key->name);
+    
+    if (problem_binary_write(ctx, temp_path, data) != 0) {
+        job_printf(ctx, "Warning: Could not write parse cache entry %s\n", path);
+        return;
+    }
+    // Atomic publish: readers see either no entry or the complete one
+    if (rename(temp_path, path) != 0) {
+        job_printf(ctx, "Warning: Could not publish parse cache entry %s\n", path);
+        remove(temp_path);
+        return;
+    }
+    evict(dir, key->name, max_bytes);
+}
@@ -0,0 +1,41 @@
+/*
+ * parse_cache.h - Content-addressed cache of parsed problems
+ *
+ * Maps the contents of a JSON input file to a ".cuopt.bin" image of the
+ * ProblemData parsed from it, so resubmitting a byte-identical file skips
+ * JSON parsing entirely. Entries are named after an XXH64 hash of the
+ * input and its size. To avoid rehashing unchanged files, a small memo
+ * keyed by the file's device, inode, size and mtime remembers the hash of
+ * the last file seen at that identity.
+ *
+ * Entries are published by writing a temporary file and renaming it into
+ * place, so concurrent processes sharing one directory only ever see
+ * complete entries. A hit refreshes the entry's mtime, and stores evict the
+ * least recently used entries once the directory exceeds its size cap.
+ */
+
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include <stdint.h>
+#include "cuopt_json_to_c_api.h"
+
+typedef struct {
+    char name[64];   // entry file name inside the cache directory
+} ParseCacheKey;
+
+// Compute the cache key of `filename`, creating `dir` if needed. The file is
+// hashed on the job's thread pool. Returns -1 for inputs that cannot be
+// cached, such as pipes.
+int parse_cache_key(JobContext* ctx, const char* dir, const char* filename, ParseCacheKey* key);
+
+// Load the entry for `key` into `data`. Returns 0 on a hit, 1 on a miss.
+// Corrupted entries are removed and reported as a miss.
+int parse_cache_load(JobContext* ctx, const char* dir, const ParseCacheKey* key, ProblemData* data);
+
+// Publish `data` under `key`, then evict least recently used entries until
+// the cache holds at most `max_bytes`. Failures only print a warning.
+void parse_cache_store(JobContext* ctx, const char* dir, const ParseCacheKey* key,
+                       const ProblemData* data, uint64_t max_bytes);
+
+#endif // PARSE_CACHE_H
@@ -0,0 +1,189 @@
+/*
+ * pipeline.c - Overlapped load/solve pipeline for batch runs
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "pipeline.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "job_context.h"
+
+typedef struct {
+    size_t index;
+    int loaded;
+} QueueItem;
+
+typedef struct {
+    size_t count;
+    PipelineLoadFn load;
+    PipelineSolveFn solve;
+    void* user;
+    
+    ProblemData* problems;   // one per index, filled by loaders
+    
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_free;
+    pthread_cond_t item_ready;
+    
+    // Ring buffer of loaded problems, capacity == slots
+    QueueItem* ring;
+    size_t slots;
+    size_t head;
+    size_t queued;
+    size_t in_use;           // reserved slots: loading, queued or solving
+    size_t max_in_use;
+    size_t next_index;       // next problem to hand to a loader
+    int active_loaders;
+    
+    double load_busy;
+    double load_stall;
+} Pipeline;
+
+static void* loader_main(void* arg) {
+    Pipeline* p = arg;
+    double busy = 0.0, stall = 0.0;
+    
+    pthread_mutex_lock(&p->mutex);
+    for (;;) {
+        // Reserve a slot first so parsed problems never exceed the budget
+        double wait_start = wall_clock_seconds();
+        while (p->in_use == p->slots && p->next_index < p->count) {
+            pthread_cond_wait(&p->slot_free, &p->mutex);
+        }
+        stall += wall_clock_seconds() - wait_start;
+        if (p->next_index >= p->count) {
+            break;
+        }
+        size_t index = p->next_index++;
+        if (p->next_index == p->count) {
+            // Let loaders still waiting for a slot see there is nothing left
+            pthread_cond_broadcast(&p->slot_free);
+        }
+        p->in_use++;
+        if (p->in_use > p->max_in_use) {
+            p->max_in_use = p->in_use;
+        }
+        pthread_mutex_unlock(&p->mutex);
+        
+        double load_start = wall_clock_seconds();
+        int loaded = p->load(p->user, index, &p->problems[index]) == 0;
+        busy += wall_clock_seconds() - load_start;
+        
+        pthread_mutex_lock(&p->mutex);
+        QueueItem* item = &p->ring[(p->head + p->queued) % p->slots];
+        item->index = index;
+        item->loaded = loaded;
+        p->queued++;
+        pthread_cond_signal(&p->item_ready);
+    }
+    p->load_busy += busy;
+    p->load_stall += stall;
+    if (--p->active_loaders == 0) {
+        // Wake the solver so it notices the queue is finished
+        pthread_cond_broadcast(&p->item_ready);
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return NULL;
+}
+
+int pipeline_run(size_t count, int num_loaders, int prefetch, PipelineLoadFn load,
+                 PipelineSolveFn solve, void* user, PipelineStats* stats) {
+    memset(stats, 0, sizeof(PipelineStats));
+    if (num_loaders < 1) {
+        num_loaders = 1;
+    }
+    if (prefetch < 1) {
+        prefetch = 1;
+    }
+    
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.count = count;
+    p.load = load;
+    p.solve = solve;
+    p.user = user;
+    p.slots = (size_t)prefetch;
+    p.problems = calloc(count > 0 ? count : 1, sizeof(ProblemData));
+    p.ring = calloc(p.slots, sizeof(QueueItem));
+    pthread_t* loaders = calloc((size_t)num_loaders, sizeof(pthread_t));
+    if (!p.problems || !p.ring || !loaders) {
+        printf("Error: Memory allocation failed\n");
+        free(p.problems);
+        free(p.ring);
+        free(loaders);
+        return -1;
+    }
+    pthread_mutex_init(&p.mutex, NULL);
+    pthread_cond_init(&p.slot_free, NULL);
+    pthread_cond_init(&p.item_ready, NULL);
+    
+    double start = wall_clock_seconds();
+    int started = 0;
+    pthread_mutex_lock(&p.mutex);
+    for (; started < num_loaders; started++) {
+        if (pthread_create(&loaders[started], NULL, loader_main, &p) != 0) {
+            break;
+        }
+        p.active_loaders++;
+    }
+    pthread_mutex_unlock(&p.mutex);
+    if (started == 0) {
+        printf("Error: Could not start loader threads\n");
+        free(p.problems);
+        free(p.ring);
+        free(loaders);
+        return -1;
+    }
+    
+    // Solver stage: runs on the calling thread, in completion order
+    double solve_busy = 0.0, solve_stall = 0.0;
+    for (;;) {
+        pthread_mutex_lock(&p.mutex);
+        double wait_start = wall_clock_seconds();
+        while (p.queued == 0 && p.active_loaders > 0) {
+            pthread_cond_wait(&p.item_ready, &p.mutex);
+        }
+        solve_stall += wall_clock_seconds() - wait_start;
+        if (p.queued == 0) {
+            pthread_mutex_unlock(&p.mutex);
+            break;
+        }
+        QueueItem item = p.ring[p.head];
+        p.head = (p.head + 1) % p.slots;
+        p.queued--;
+        pthread_mutex_unlock(&p.mutex);
+        
+        double solve_start = wall_clock_seconds();
+        solve(user, item.index, &p.problems[item.index], item.loaded);
+        solve_busy += wall_clock_seconds() - solve_start;
+        
+        pthread_mutex_lock(&p.mutex);
+        p.in_use--;
+        pthread_cond_signal(&p.slot_free);
+        pthread_mutex_unlock(&p.mutex);
+    }
+    
+    for (int i = 0; i < started; i++) {
+        pthread_join(loaders[i], NULL);
+    }
+    
+    stats->elapsed = wall_clock_seconds() - start;
+    stats->load_busy = p.load_busy;
+    stats->load_stall = p.load_stall;
+    stats->solve_busy = solve_busy;
+    stats->solve_stall = solve_stall;
+    stats->max_resident = p.max_in_use;
+    
+    pthread_cond_destroy(&p.item_ready);
+    pthread_cond_destroy(&p.slot_free);
+    pthread_mutex_destroy(&p.mutex);
+    free(p.problems);
+    free(p.ring);
+    free(loaders);
+    return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * pipeline.h - Overlapped load/solve pipeline for batch runs
+ *
+ * Loader threads parse problems into a bounded queue and the calling
+ * thread drains it, so problem N+1 is parsed on the CPU while problem N is
+ * being solved. A loader must reserve one of `prefetch` slots before it
+ * starts parsing and the slot is only returned once the solve of that
+ * problem has finished, so at most `prefetch` problems are resident at a
+ * time however fast the loaders are.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+#include "cuopt_json_to_c_api.h"
+
+// Load problem `index` into `data`; called concurrently from loader threads.
+// Returns 0 on success, -1 on failure.
+typedef int (*PipelineLoadFn)(void* user, size_t index, ProblemData* data);
+
+// Solve (and release) problem `index`; called on the calling thread only.
+// `loaded` is 0 if the load failed.
+typedef void (*PipelineSolveFn)(void* user, size_t index, ProblemData* data, int loaded);
+
+// Wall-clock seconds spent in each stage, summed over threads
+typedef struct {
+    double elapsed;
+    double load_busy;     // inside the load callback
+    double load_stall;    // loaders waiting for a free slot (solver is behind)
+    double solve_busy;    // inside the solve callback
+    double solve_stall;   // solver waiting for a loaded problem (loaders are behind)
+    size_t max_resident;  // most problems held at once
+} PipelineStats;
+
+// Run load and solve for indices [0, count) with `num_loaders` loader
+// threads and `prefetch` slots. Returns 0, or -1 if threads could not be
+// started (nothing has been run in that case).
+int pipeline_run(size_t count, int num_loaders, int prefetch, PipelineLoadFn load,
+                 PipelineSolveFn solve, void* user, PipelineStats* stats);
+
+#endif // PIPELINE_H
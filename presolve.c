@@ -0,0 +1,661 @@
+/*
+ * presolve.c - CPU presolve of trivial rows, fixed variables and duplicates
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "presolve.h"
+#include "hash64.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Slack allowed when checking empty rows and crossing bounds
+#define PRESOLVE_FEASIBILITY_TOLERANCE 1e-9
+
+// Relative difference allowed between entries of parallel rows and
+// duplicate columns
+#define PRESOLVE_PARALLEL_TOLERANCE 1e-9
+
+// Working state of one presolve
+typedef struct {
+    const ProblemData* data;
+    cuopt_float_t* row_lower;
+    cuopt_float_t* row_upper;
+    cuopt_float_t* column_lower;
+    cuopt_float_t* column_upper;
+    cuopt_int_t* row_length;        // active entries left in each row
+    unsigned char* row_removed;
+    unsigned char* column_removed;
+    // Column-wise copy of the matrix, to find the rows of a fixed variable
+    cuopt_int_t* column_offsets;
+    cuopt_int_t* column_rows;
+    cuopt_float_t* column_values;
+    cuopt_float_t offset_shift;
+} PresolveState;
+
+// Push a postsolve entry. Returns NULL on failure.
+static PresolveOp* push_op(JobContext* ctx, Presolve* presolve, PresolveOpKind kind,
+                           cuopt_int_t row, cuopt_int_t column, cuopt_float_t value) {
+    if (presolve->stack_size == presolve->stack_capacity) {
+        size_t capacity = presolve->stack_capacity ? presolve->stack_capacity * 2 : 256;
+        PresolveOp* grown = realloc(presolve->stack, capacity * sizeof(PresolveOp));
+        if (!grown) {
+            job_printf(ctx, "Error: Memory allocation failed\n");
+            return NULL;
+        }
+        presolve->stack = grown;
+        presolve->stack_capacity = capacity;
+    }
+    PresolveOp* op = &presolve->stack[presolve->stack_size++];
+    memset(op, 0, sizeof(PresolveOp));
+    op->kind = kind;
+    op->row = row;
+    op->column = column;
+    op->kept = -1;
+    op->value = value;
+    return op;
+}
+
+// Intersect [lower, upper] with [low, high]. Returns 1 if the bounds cross.
+static int tighten(cuopt_float_t* lower, cuopt_float_t* upper, cuopt_float_t low,
+                   cuopt_float_t high) {
+    if (low > *lower) {
+        *lower = low;
+    }
+    if (high < *upper) {
+        *upper = high;
+    }
+    if (*lower > *upper) {
+        cuopt_float_t gap = *lower - *upper;
+        if (gap > PRESOLVE_FEASIBILITY_TOLERANCE * (1.0 + fabs(*upper))) {
+            return 1;
+        }
+        // Crossed by rounding only: meet in the middle
+        *lower = *upper = *upper + gap / 2;
+    }
+    return 0;
+}
+
+// Build the column-wise copy of the CSR matrix
+static int transpose(const ProblemData* data, PresolveState* state) {
+    size_t n = (size_t)data->num_variables, nnz = (size_t)data->nnz;
+    state->column_offsets = calloc(n + 1, sizeof(cuopt_int_t));
+    state->column_rows = malloc((nnz ? nnz : 1) * sizeof(cuopt_int_t));
+    state->column_values = malloc((nnz ? nnz : 1) * sizeof(cuopt_float_t));
+    cuopt_int_t* next = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    if (!state->column_offsets || !state->column_rows || !state->column_values || !next) {
+        free(next);
+        return -1;
+    }
+    for (size_t k = 0; k < nnz; k++) {
+        state->column_offsets[data->column_indices[k] + 1]++;
+    }
+    for (size_t j = 0; j < n; j++) {
+        state->column_offsets[j + 1] += state->column_offsets[j];
+        next[j] = state->column_offsets[j];
+    }
+    for (cuopt_int_t i = 0; i < data->num_constraints; i++) {
+        for (cuopt_int_t k = data->row_offsets[i]; k < data->row_offsets[i + 1]; k++) {
+            cuopt_int_t position = next[data->column_indices[k]]++;
+            state->column_rows[position] = i;
+            state->column_values[position] = data->matrix_values[k];
+        }
+    }
+    free(next);
+    return 0;
+}
+
+// Remove variable j at `value`, moving its contribution into the bounds of
+// its rows and the objective offset
+static int fix_variable(JobContext* ctx, Presolve* presolve, PresolveState* state, cuopt_int_t j,
+                        cuopt_float_t value) {
+    state->column_removed[j] = 1;
+    state->offset_shift += state->data->objective_coefficients[j] * value;
+    for (cuopt_int_t k = state->column_offsets[j]; k < state->column_offsets[j + 1]; k++) {
+        cuopt_int_t row = state->column_rows[k];
+        if (state->row_removed[row]) {
+            continue;
+        }
+        cuopt_float_t contribution = state->column_values[k] * value;
+        if (!bound_is_infinite(state->row_lower[row])) {
+            state->row_lower[row] -= contribution;
+        }
+        if (!bound_is_infinite(state->row_upper[row])) {
+            state->row_upper[row] -= contribution;
+        }
+        state->row_length[row]--;
+    }
+    presolve->stats.fixed_variables++;
+    return push_op(ctx, presolve, PRESOLVE_FIXED_VARIABLE, -1, j, value) ? 0 : -1;
+}
+
+// Turn the singleton row `row` into bounds on its one variable. Returns 1
+// if the bounds cross.
+static int apply_singleton_row(JobContext* ctx, Presolve* presolve, PresolveState* state,
+                               cuopt_int_t row) {
+    const ProblemData* data = state->data;
+    cuopt_int_t j = -1;
+    cuopt_float_t a = 0.0;
+    for (cuopt_int_t k = data->row_offsets[row]; k < data->row_offsets[row + 1]; k++) {
+        if (!state->column_removed[data->column_indices[k]]) {
+            j = data->column_indices[k];
+            a = data->matrix_values[k];
+            break;
+        }
+    }
+    if (j < 0 || a == 0.0) {
+        return 0;
+    }
+    
+    // l <= a * x <= u gives x in [l / a, u / a], flipped for a < 0
+    cuopt_float_t low = a > 0.0 ? state->row_lower[row] : state->row_upper[row];
+    cuopt_float_t high = a > 0.0 ? state->row_upper[row] : state->row_lower[row];
+    low = bound_is_infinite(low) ? -CUOPT_INFINITY : low / a;
+    high = bound_is_infinite(high) ? CUOPT_INFINITY : high / a;
+    if (data->variable_types && data->variable_types[j] == CUOPT_INTEGER) {
+        if (!bound_is_infinite(low)) {
+            low = ceil(low - PRESOLVE_FEASIBILITY_TOLERANCE);
+        }
+        if (!bound_is_infinite(high)) {
+            high = floor(high + PRESOLVE_FEASIBILITY_TOLERANCE);
+        }
+    }
+    if (tighten(&state->column_lower[j], &state->column_upper[j], low, high) != 0) {
+        return 1;
+    }
+    
+    state->row_removed[row] = 1;
+    presolve->stats.singleton_rows++;
+    return push_op(ctx, presolve, PRESOLVE_SINGLETON_ROW, row, j, a) ? 0 : -1;
+}
+
+// A row or column reduced to a hash of its active entries, each divided by
+// the entry with the smallest index
+typedef struct {
+    uint64_t hash;
+    cuopt_int_t index;
+    cuopt_int_t length;
+    cuopt_int_t pivot;          // smallest active index
+    cuopt_float_t scale;        // entry at `pivot`
+} Signature;
+
+// Rows of the CSR matrix or columns of its transposed copy, skipping the
+// entries whose minor index has been removed
+typedef struct {
+    cuopt_int_t count;
+    const cuopt_int_t* offsets;
+    const cuopt_int_t* indices;
+    const cuopt_float_t* values;
+    const unsigned char* removed;
+    const unsigned char* minor_removed;
+} SparseView;
+
+// Hash one normalized entry. The mantissa is rounded to 30 bits so values
+// that differ by round-off usually hash alike; candidates are compared
+// entry by entry anyway.
+static uint64_t entry_hash(cuopt_int_t index, cuopt_float_t value) {
+    int exponent = 0;
+    double mantissa = frexp(value, &exponent);
+    int64_t key[3] = {index, llround(mantissa * (double)(1 << 30)), exponent};
+    return hash64(key, sizeof(key), 0);
+}
+
+// Fill `out` with the signatures of the active majors that have at least
+// `min_length` active entries and return how many there are. Entry hashes
+// are summed, so the order of the entries does not matter. `objective`, if
+// set, is hashed in as one more entry.
+static size_t compute_signatures(const SparseView* view, const cuopt_float_t* objective,
+                                 cuopt_int_t min_length, Signature* out) {
+    size_t count = 0;
+    for (cuopt_int_t i = 0; i < view->count; i++) {
+        if (view->removed[i]) {
+            continue;
+        }
+        Signature signature = {0, i, 0, -1, 0.0};
+        for (cuopt_int_t k = view->offsets[i]; k < view->offsets[i + 1]; k++) {
+            cuopt_int_t minor = view->indices[k];
+            if (view->minor_removed[minor]) {
+                continue;
+            }
+            signature.length++;
+            if (signature.pivot < 0 || minor < signature.pivot) {
+                signature.pivot = minor;
+                signature.scale = view->values[k];
+            }
+        }
+        if (signature.length < min_length || signature.scale == 0.0) {
+            continue;
+        }
+        for (cuopt_int_t k = view->offsets[i]; k < view->offsets[i + 1]; k++) {
+            if (!view->minor_removed[view->indices[k]]) {
+                signature.hash += entry_hash(view->indices[k], view->values[k] / signature.scale);
+            }
+        }
+        if (objective) {
+            signature.hash += entry_hash(-1, objective[i] / signature.scale);
+        }
+        signature.hash ^= hash64(&signature.length, sizeof(signature.length), 1);
+        out[count++] = signature;
+    }
+    return count;
+}
+
+static int compare_signatures(const void* a, const void* b) {
+    const Signature* x = a;
+    const Signature* y = b;
+    if (x->hash != y->hash) {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static int nearly_equal(cuopt_float_t a, cuopt_float_t b) {
+    return fabs(a - b) <= PRESOLVE_PARALLEL_TOLERANCE * fmax(fabs(a), fabs(b));
+}
+
+// Spread the active entries of major i over `values`, marking them in
+// `stamp` with `mark`
+static void scatter(const SparseView* view, cuopt_int_t i, cuopt_float_t* values,
+                    cuopt_int_t* stamp, cuopt_int_t mark) {
+    for (cuopt_int_t k = view->offsets[i]; k < view->offsets[i + 1]; k++) {
+        cuopt_int_t minor = view->indices[k];
+        if (!view->minor_removed[minor]) {
+            values[minor] = view->values[k];
+            stamp[minor] = mark;
+        }
+    }
+}
+
+// Check that every active entry of major k is `lambda` times the scattered
+// entry at the same index. Equal lengths make this a full comparison.
+static int is_multiple(const SparseView* view, cuopt_int_t k, cuopt_float_t lambda,
+                       const cuopt_float_t* values, const cuopt_int_t* stamp, cuopt_int_t mark) {
+    for (cuopt_int_t e = view->offsets[k]; e < view->offsets[k + 1]; e++) {
+        cuopt_int_t minor = view->indices[e];
+        if (view->minor_removed[minor]) {
+            continue;
+        }
+        if (stamp[minor] != mark || !nearly_equal(view->values[e], lambda * values[minor])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Drop row k == lambda * row i, moving its bounds onto row i. Returns 1 if
+// the bounds cross.
+static int merge_rows(JobContext* ctx, Presolve* presolve, PresolveState* state, cuopt_int_t i,
+                      cuopt_int_t k, cuopt_float_t lambda) {
+    // l <= lambda * a x <= u bounds a x by [l, u] / lambda, flipped for lambda < 0
+    cuopt_float_t low = lambda > 0.0 ? state->row_lower[k] : state->row_upper[k];
+    cuopt_float_t high = lambda > 0.0 ? state->row_upper[k] : state->row_lower[k];
+    low = bound_is_infinite(low) ? -CUOPT_INFINITY : low / lambda;
+    high = bound_is_infinite(high) ? CUOPT_INFINITY : high / lambda;
+    if (tighten(&state->row_lower[i], &state->row_upper[i], low, high) != 0) {
+        return 1;
+    }
+    
+    state->row_removed[k] = 1;
+    presolve->stats.parallel_rows++;
+    PresolveOp* op = push_op(ctx, presolve, PRESOLVE_PARALLEL_ROW, k, -1, lambda);
+    if (!op) {
+        return -1;
+    }
+    op->kept = i;
+    return 0;
+}
+
+// Replace x_j and the duplicate x_k (column k == lambda * column j) by
+// y = x_j + lambda * x_k, kept in column j
+static int merge_columns(JobContext* ctx, Presolve* presolve, PresolveState* state,
+                         cuopt_int_t j, cuopt_int_t k, cuopt_float_t lambda) {
+    cuopt_float_t low = lambda > 0.0 ? state->column_lower[k] : state->column_upper[k];
+    cuopt_float_t high = lambda > 0.0 ? state->column_upper[k] : state->column_lower[k];
+    low = bound_is_infinite(low) ? -CUOPT_INFINITY : lambda * low;
+    high = bound_is_infinite(high) ? CUOPT_INFINITY : lambda * high;
+    PresolveOp* op = push_op(ctx, presolve, PRESOLVE_DUPLICATE_COLUMN, -1, k, lambda);
+    if (!op) {
+        return -1;
+    }
+    op->kept = j;
+    op->bounds[0] = state->column_lower[j];
+    op->bounds[1] = state->column_upper[j];
+    op->bounds[2] = low;
+    op->bounds[3] = high;
+    
+    state->column_lower[j] = bound_is_infinite(state->column_lower[j]) || bound_is_infinite(low)
+                                 ? -CUOPT_INFINITY : state->column_lower[j] + low;
+    state->column_upper[j] = bound_is_infinite(state->column_upper[j]) || bound_is_infinite(high)
+                                 ? CUOPT_INFINITY : state->column_upper[j] + high;
+    state->column_removed[k] = 1;
+    for (cuopt_int_t e = state->column_offsets[k]; e < state->column_offsets[k + 1]; e++) {
+        if (!state->row_removed[state->column_rows[e]]) {
+            state->row_length[state->column_rows[e]]--;
+        }
+    }
+    presolve->stats.duplicate_columns++;
+    return 0;
+}
+
+static int is_continuous(const ProblemData* data, cuopt_int_t j) {
+    return !data->variable_types || data->variable_types[j] == CUOPT_CONTINUOUS;
+}
+
+// Merge every major whose signature matches an earlier one in the sorted
+// `signatures`. Rows need their bounds merged; columns also need matching
+// objective coefficients and must both be continuous.
+static int merge_matches(JobContext* ctx, Presolve* presolve, PresolveState* state,
+                         const SparseView* view, int columns, Signature* signatures, size_t count,
+                         cuopt_float_t* values, cuopt_int_t* stamp) {
+    const cuopt_float_t* objective = state->data->objective_coefficients;
+    qsort(signatures, count, sizeof(Signature), compare_signatures);
+    for (size_t first = 0; first < count;) {
+        size_t last = first + 1;
+        while (last < count && signatures[last].hash == signatures[first].hash) {
+            last++;
+        }
+        for (size_t a = first; a + 1 < last; a++) {
+            const Signature* kept = &signatures[a];
+            if (view->removed[kept->index]) {
+                continue;
+            }
+            scatter(view, kept->index, values, stamp, kept->index + 1);
+            for (size_t b = a + 1; b < last; b++) {
+                const Signature* other = &signatures[b];
+                if (view->removed[other->index] || other->length != kept->length ||
+                    other->pivot != kept->pivot) {
+                    continue;
+                }
+                cuopt_float_t lambda = other->scale / kept->scale;
+                if (!is_multiple(view, other->index, lambda, values, stamp, kept->index + 1)) {
+                    continue;
+                }
+                int status;
+                if (columns) {
+                    if (!nearly_equal(objective[other->index], lambda * objective[kept->index])) {
+                        continue;
+                    }
+                    status = merge_columns(ctx, presolve, state, kept->index, other->index, lambda);
+                } else {
+                    status = merge_rows(ctx, presolve, state, kept->index, other->index, lambda);
+                }
+                if (status != 0) {
+                    return status;
+                }
+            }
+        }
+        first = last;
+    }
+    return 0;
+}
+
+// Find parallel rows, then duplicate columns, by their signatures and merge
+// them. Returns 0, 1 if the problem is infeasible or -1 on failure.
+static int merge_duplicates(JobContext* ctx, Presolve* presolve, PresolveState* state) {
+    const ProblemData* data = state->data;
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    size_t size = m > n ? m : n;
+    Signature* signatures = malloc((size ? size : 1) * sizeof(Signature));
+    cuopt_float_t* values = malloc((size ? size : 1) * sizeof(cuopt_float_t));
+    cuopt_int_t* stamp = calloc(size ? size : 1, sizeof(cuopt_int_t));
+    if (!signatures || !values || !stamp) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        free(signatures);
+        free(values);
+        free(stamp);
+        return -1;
+    }
+    
+    // Singleton rows are cheaper to turn into bounds, so rows need two entries
+    SparseView rows = {data->num_constraints, data->row_offsets, data->column_indices,
+                       data->matrix_values, state->row_removed, state->column_removed};
+    size_t count = compute_signatures(&rows, NULL, 2, signatures);
+    int status = merge_matches(ctx, presolve, state, &rows, 0, signatures, count, values, stamp);
+    
+    if (status == 0) {
+        SparseView columns = {data->num_variables, state->column_offsets, state->column_rows,
+                              state->column_values, state->column_removed, state->row_removed};
+        count = compute_signatures(&columns, data->objective_coefficients, 1, signatures);
+        size_t continuous = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (is_continuous(data, signatures[i].index)) {
+                signatures[continuous++] = signatures[i];
+            }
+        }
+        memset(stamp, 0, size * sizeof(cuopt_int_t));
+        status = merge_matches(ctx, presolve, state, &columns, 1, signatures, continuous, values,
+                               stamp);
+    }
+    free(signatures);
+    free(values);
+    free(stamp);
+    return status;
+}
+
+// Apply the rules until nothing changes. Returns 0, 1 if the problem is
+// infeasible or -1 on failure.
+static int reduce(JobContext* ctx, Presolve* presolve, PresolveState* state) {
+    const ProblemData* data = state->data;
+    for (;;) {
+        size_t stack_before = presolve->stack_size;
+        presolve->stats.passes++;
+        
+        for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+            if (!state->column_removed[j] && state->column_lower[j] == state->column_upper[j] &&
+                fix_variable(ctx, presolve, state, j, state->column_lower[j]) != 0) {
+                return -1;
+            }
+        }
+        
+        for (cuopt_int_t i = 0; i < data->num_constraints; i++) {
+            if (state->row_removed[i]) {
+                continue;
+            }
+            if (state->row_length[i] == 0) {
+                cuopt_float_t slack = PRESOLVE_FEASIBILITY_TOLERANCE * (1.0 + fabs(state->row_lower[i]) +
+                                                                        fabs(state->row_upper[i]));
+                if (state->row_lower[i] > slack || state->row_upper[i] < -slack) {
+                    return 1;
+                }
+                state->row_removed[i] = 1;
+                presolve->stats.empty_rows++;
+                if (!push_op(ctx, presolve, PRESOLVE_EMPTY_ROW, i, -1, 0.0)) {
+                    return -1;
+                }
+            } else if (bound_is_infinite(state->row_lower[i]) &&
+                       bound_is_infinite(state->row_upper[i])) {
+                state->row_removed[i] = 1;
+                presolve->stats.free_rows++;
+                if (!push_op(ctx, presolve, PRESOLVE_FREE_ROW, i, -1, 0.0)) {
+                    return -1;
+                }
+            } else if (state->row_length[i] == 1) {
+                int status = apply_singleton_row(ctx, presolve, state, i);
+                if (status != 0) {
+                    return status;
+                }
+            }
+        }
+        
+        // Look for duplicates only once the cheap rules have run dry
+        if (presolve->stack_size == stack_before) {
+            int status = merge_duplicates(ctx, presolve, state);
+            if (status != 0 || presolve->stack_size == stack_before) {
+                return status;
+            }
+        }
+    }
+}
+
+// Copy the rows and variables that survived into presolve->reduced
+static int build_reduced(Presolve* presolve, const PresolveState* state) {
+    const ProblemData* data = state->data;
+    ProblemData* reduced = &presolve->reduced;
+    size_t m = 0, n = 0, nnz = 0;
+    for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+        presolve->variable_index[j] = state->column_removed[j] ? -1 : (cuopt_int_t)n++;
+    }
+    for (cuopt_int_t i = 0; i < data->num_constraints; i++) {
+        presolve->row_index[i] = state->row_removed[i] ? -1 : (cuopt_int_t)m++;
+        if (!state->row_removed[i]) {
+            nnz += (size_t)state->row_length[i];
+        }
+    }
+    
+    reduced->num_constraints = (cuopt_int_t)m;
+    reduced->num_variables = (cuopt_int_t)n;
+    reduced->nnz = (cuopt_int_t)nnz;
+    reduced->objective_sense = data->objective_sense;
+    reduced->objective_offset = data->objective_offset + state->offset_shift;
+    reduced->objective_scaling_factor = data->objective_scaling_factor;
+    reduced->row_offsets = malloc((m + 1) * sizeof(cuopt_int_t));
+    reduced->column_indices = malloc((nnz ? nnz : 1) * sizeof(cuopt_int_t));
+    reduced->matrix_values = malloc((nnz ? nnz : 1) * sizeof(cuopt_float_t));
+    reduced->constraint_lower_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    reduced->constraint_upper_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    reduced->objective_coefficients = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    reduced->variable_lower_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    reduced->variable_upper_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    reduced->variable_types = malloc(n ? n : 1);
+    if (!reduced->row_offsets || !reduced->column_indices || !reduced->matrix_values ||
+        !reduced->constraint_lower_bounds || !reduced->constraint_upper_bounds ||
+        !reduced->objective_coefficients || !reduced->variable_lower_bounds ||
+        !reduced->variable_upper_bounds || !reduced->variable_types) {
+        return -1;
+    }
+    
+    size_t k = 0;
+    reduced->row_offsets[0] = 0;
+    for (cuopt_int_t i = 0; i < data->num_constraints; i++) {
+        cuopt_int_t row = presolve->row_index[i];
+        if (row < 0) {
+            continue;
+        }
+        for (cuopt_int_t e = data->row_offsets[i]; e < data->row_offsets[i + 1]; e++) {
+            cuopt_int_t column = presolve->variable_index[data->column_indices[e]];
+            if (column >= 0) {
+                reduced->column_indices[k] = column;
+                reduced->matrix_values[k++] = data->matrix_values[e];
+            }
+        }
+        reduced->row_offsets[row + 1] = (cuopt_int_t)k;
+        reduced->constraint_lower_bounds[row] = state->row_lower[i];
+        reduced->constraint_upper_bounds[row] = state->row_upper[i];
+    }
+    for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+        cuopt_int_t column = presolve->variable_index[j];
+        if (column < 0) {
+            continue;
+        }
+        reduced->objective_coefficients[column] = data->objective_coefficients[j];
+        reduced->variable_lower_bounds[column] = state->column_lower[j];
+        reduced->variable_upper_bounds[column] = state->column_upper[j];
+        reduced->variable_types[column] = data->variable_types ? data->variable_types[j]
+                                                               : CUOPT_CONTINUOUS;
+    }
+    return 0;
+}
+
+static void free_state(PresolveState* state) {
+    free(state->row_lower);
+    free(state->row_upper);
+    free(state->column_lower);
+    free(state->column_upper);
+    free(state->row_length);
+    free(state->row_removed);
+    free(state->column_removed);
+    free(state->column_offsets);
+    free(state->column_rows);
+    free(state->column_values);
+}
+
+int presolve_run(JobContext* ctx, const ProblemData* data, Presolve* presolve) {
+    memset(presolve, 0, sizeof(Presolve));
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    presolve->num_constraints = data->num_constraints;
+    presolve->num_variables = data->num_variables;
+    presolve->nnz = data->nnz;
+    presolve->row_index = malloc((m ? m : 1) * sizeof(cuopt_int_t));
+    presolve->variable_index = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    
+    PresolveState state;
+    memset(&state, 0, sizeof(PresolveState));
+    state.data = data;
+    state.row_lower = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    state.row_upper = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    state.column_lower = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    state.column_upper = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    state.row_length = malloc((m ? m : 1) * sizeof(cuopt_int_t));
+    state.row_removed = calloc(m ? m : 1, 1);
+    state.column_removed = calloc(n ? n : 1, 1);
+    if (!presolve->row_index || !presolve->variable_index || !state.row_lower ||
+        !state.row_upper || !state.column_lower || !state.column_upper || !state.row_length ||
+        !state.row_removed || !state.column_removed || transpose(data, &state) != 0) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        free_state(&state);
+        presolve_free(presolve);
+        return -1;
+    }
+    
+    // Without constraint bounds there is nothing to reason about
+    int reducible = data->num_constraints == 0 ||
+                    (data->constraint_lower_bounds && data->constraint_upper_bounds);
+    for (size_t i = 0; i < m; i++) {
+        state.row_lower[i] = reducible ? data->constraint_lower_bounds[i] : -CUOPT_INFINITY;
+        state.row_upper[i] = reducible ? data->constraint_upper_bounds[i] : CUOPT_INFINITY;
+        state.row_length[i] = data->row_offsets[i + 1] - data->row_offsets[i];
+    }
+    for (size_t j = 0; j < n; j++) {
+        state.column_lower[j] = problem_variable_lower_bound(data, (cuopt_int_t)j);
+        state.column_upper[j] = problem_variable_upper_bound(data, (cuopt_int_t)j);
+    }
+    
+    int status = reducible ? reduce(ctx, presolve, &state) : 0;
+    if (status == 0 && presolve->stack_size > 0 && build_reduced(presolve, &state) != 0) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        status = -1;
+    }
+    free_state(&state);
+    if (status != 0) {
+        presolve_free(presolve);
+    }
+    return status;
+}
+
+void presolve_postsolve_primal(const Presolve* presolve, const cuopt_float_t* reduced,
+                               cuopt_float_t* original) {
+    for (cuopt_int_t j = 0; j < presolve->num_variables; j++) {
+        cuopt_int_t column = presolve->variable_index[j];
+        original[j] = column >= 0 ? reduced[column] : 0.0;
+    }
+    // Undo the removals, last one first
+    for (size_t i = presolve->stack_size; i-- > 0;) {
+        const PresolveOp* op = &presolve->stack[i];
+        if (op->kind == PRESOLVE_FIXED_VARIABLE) {
+            original[op->column] = op->value;
+        } else if (op->kind == PRESOLVE_DUPLICATE_COLUMN) {
+            // Split y = x_j + value * x_k, pushing z = value * x_k to a finite
+            // bound and x_j within its own bounds
+            cuopt_float_t y = original[op->kept];
+            cuopt_float_t x = 0.0;
+            if (!bound_is_infinite(op->bounds[2])) {
+                x = y - op->bounds[2];
+            } else if (!bound_is_infinite(op->bounds[3])) {
+                x = y - op->bounds[3];
+            }
+            x = fmin(fmax(x, op->bounds[0]), op->bounds[1]);
+            original[op->kept] = x;
+            original[op->column] = (y - x) / op->value;
+        }
+    }
+}
+
+void presolve_free(Presolve* presolve) {
+    free_problem_data(&presolve->reduced);
+    free(presolve->row_index);
+    free(presolve->variable_index);
+    free(presolve->stack);
+    memset(presolve, 0, sizeof(Presolve));
+}
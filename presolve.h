@@ -0,0 +1,94 @@
+/*
+ * presolve.h - CPU presolve of trivial rows, fixed variables and duplicates
+ *
+ * Removes what the solver would only have to carry along:
+ *
+ *   - empty rows, which are either trivially satisfied or make the problem
+ *     infeasible;
+ *   - free rows, with infinite bounds on both sides;
+ *   - singleton rows a * x_j in [l, u], which become bounds on x_j;
+ *   - fixed variables (lower bound == upper bound), whose contribution
+ *     moves into the row bounds and the objective offset;
+ *   - parallel rows (one a multiple of another), merged by intersecting
+ *     their bounds;
+ *   - duplicate continuous columns x_k, whose coefficients and objective
+ *     are a multiple lambda of those of x_j, replaced by x_j + lambda * x_k.
+ *
+ * Parallel rows and duplicate columns are found by hashing signatures
+ * normalized by the entry with the smallest index, so only candidates
+ * whose hashes collide are compared entry by entry.
+ *
+ * The rules feed each other (fixing a variable can empty a row, a
+ * singleton row can fix a variable), so they are applied in passes until
+ * nothing changes; the duplicate search runs whenever a pass of the cheap
+ * rules removes nothing. Every removal is pushed on a postsolve stack, which is
+ * replayed in reverse to map a solution of the reduced problem back to the
+ * original variables.
+ */
+
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+#include <stddef.h>
+#include "cuopt_json_to_c_api.h"
+
+typedef enum {
+    PRESOLVE_EMPTY_ROW,
+    PRESOLVE_FREE_ROW,
+    PRESOLVE_SINGLETON_ROW,   // bound the row put on `column`, coefficient in `value`
+    PRESOLVE_FIXED_VARIABLE,  // `column` removed at `value`
+    PRESOLVE_PARALLEL_ROW,    // `row` == `value` * row `kept`, merged into it
+    PRESOLVE_DUPLICATE_COLUMN // `column` == `value` * column `kept`, merged into it
+} PresolveOpKind;
+
+// One postsolve stack entry
+typedef struct {
+    PresolveOpKind kind;
+    cuopt_int_t row;
+    cuopt_int_t column;
+    cuopt_int_t kept;
+    cuopt_float_t value;
+    // PRESOLVE_DUPLICATE_COLUMN: bounds of the kept column before the merge,
+    // then those of value * x[column]
+    cuopt_float_t bounds[4];
+} PresolveOp;
+
+typedef struct {
+    cuopt_int_t empty_rows;
+    cuopt_int_t free_rows;
+    cuopt_int_t singleton_rows;
+    cuopt_int_t fixed_variables;
+    cuopt_int_t parallel_rows;
+    cuopt_int_t duplicate_columns;
+    int passes;
+} PresolveStats;
+
+typedef struct {
+    ProblemData reduced;
+    cuopt_int_t num_constraints;   // of the original problem
+    cuopt_int_t num_variables;
+    cuopt_int_t nnz;
+    cuopt_int_t* row_index;        // original row -> reduced row, -1 if removed
+    cuopt_int_t* variable_index;   // original variable -> reduced variable, -1 if removed
+    PresolveOp* stack;
+    size_t stack_size;
+    size_t stack_capacity;
+    PresolveStats stats;
+} Presolve;
+
+// Presolve `data` into presolve->reduced. Returns 0 on success, 1 if the
+// problem was found to be infeasible (nothing is kept in that case) and -1
+// on failure (an error has been printed). If nothing could be removed
+// (stack_size == 0, always the case without constraint bounds), no
+// reduced problem is built and `data` should be solved as it is. The
+// transpose indexes by the column indices unchecked, so `data` must have
+// passed load_problem's CSR check.
+int presolve_run(JobContext* ctx, const ProblemData* data, Presolve* presolve);
+
+// Map the primal solution of the reduced problem to the original variables
+void presolve_postsolve_primal(const Presolve* presolve, const cuopt_float_t* reduced,
+                               cuopt_float_t* original);
+
+void presolve_free(Presolve* presolve);
+
+#endif // PRESOLVE_H
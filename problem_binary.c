@@ -0,0 +1,380 @@
+/*
+ * problem_binary.c - ".cuopt.bin" binary problem files
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "problem_binary.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash64.h"
+
+// How many elements a section holds, in terms of the problem sizes
+typedef enum {
+    COUNT_CONSTRAINTS,
+    COUNT_CONSTRAINTS_PLUS_ONE,
+    COUNT_VARIABLES,
+    COUNT_NNZ
+} SectionCount;
+
+// Where each section lives in ProblemData, in file order
+static const struct {
+    ProblemSectionId id;
+    size_t field;        // offsetof the array pointer in ProblemData
+    size_t elem_size;
+    SectionCount count;
+} section_layout[] = {
+    { PROBLEM_SECTION_ROW_OFFSETS, offsetof(ProblemData, row_offsets),
+      sizeof(cuopt_int_t), COUNT_CONSTRAINTS_PLUS_ONE },
+    { PROBLEM_SECTION_COLUMN_INDICES, offsetof(ProblemData, column_indices),
+      sizeof(cuopt_int_t), COUNT_NNZ },
+    { PROBLEM_SECTION_MATRIX_VALUES, offsetof(ProblemData, matrix_values),
+      sizeof(cuopt_float_t), COUNT_NNZ },
+    { PROBLEM_SECTION_OBJECTIVE_COEFFICIENTS, offsetof(ProblemData, objective_coefficients),
+      sizeof(cuopt_float_t), COUNT_VARIABLES },
+    { PROBLEM_SECTION_CONSTRAINT_LOWER_BOUNDS, offsetof(ProblemData, constraint_lower_bounds),
+      sizeof(cuopt_float_t), COUNT_CONSTRAINTS },
+    { PROBLEM_SECTION_CONSTRAINT_UPPER_BOUNDS, offsetof(ProblemData, constraint_upper_bounds),
+      sizeof(cuopt_float_t), COUNT_CONSTRAINTS },
+    { PROBLEM_SECTION_VARIABLE_LOWER_BOUNDS, offsetof(ProblemData, variable_lower_bounds),
+      sizeof(cuopt_float_t), COUNT_VARIABLES },
+    { PROBLEM_SECTION_VARIABLE_UPPER_BOUNDS, offsetof(ProblemData, variable_upper_bounds),
+      sizeof(cuopt_float_t), COUNT_VARIABLES },
+    { PROBLEM_SECTION_VARIABLE_TYPES, offsetof(ProblemData, variable_types),
+      sizeof(char), COUNT_VARIABLES }
+};
+
+#define NUM_SECTIONS (sizeof(section_layout) / sizeof(section_layout[0]))
+
+// The header is copied to and from the file as-is, so its layout must not
+// depend on the compiler
+typedef char header_layout_check[(sizeof(ProblemBinaryHeader) ==
+                                  80 + PROBLEM_BINARY_MAX_SECTIONS * sizeof(ProblemBinarySection) &&
+                                  NUM_SECTIONS <= PROBLEM_BINARY_MAX_SECTIONS) ? 1 : -1];
+
+static uint64_t align_up(uint64_t value) {
+    return (value + PROBLEM_BINARY_ALIGNMENT - 1) & ~(uint64_t)(PROBLEM_BINARY_ALIGNMENT - 1);
+}
+
+static uint64_t section_count(SectionCount count, int64_t num_constraints, int64_t num_variables,
+                              int64_t nnz) {
+    switch (count) {
+        case COUNT_CONSTRAINTS:
+            return (uint64_t)num_constraints;
+        case COUNT_CONSTRAINTS_PLUS_ONE:
+            return (uint64_t)num_constraints + 1;
+        case COUNT_VARIABLES:
+            return (uint64_t)num_variables;
+        default:
+            return (uint64_t)nnz;
+    }
+}
+
+static void** field_pointer(ProblemData* data, size_t field) {
+    return (void**)((char*)data + field);
+}
+
+static int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static uint64_t header_checksum(const ProblemBinaryHeader* header) {
+    ProblemBinaryHeader copy = *header;
+    copy.header_checksum = 0;
+    return hash64(&copy, sizeof(copy), 0);
+}
+
+int problem_binary_probe(const char* filename) {
+    struct stat st;
+    if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return 0;
+    }
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return 0;
+    }
+    char magic[8];
+    size_t n = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return n == sizeof(magic) && memcmp(magic, PROBLEM_BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+// Write `length` bytes followed by zero padding up to the next section
+static int write_padded(FILE* file, const void* bytes, uint64_t length) {
+    static const char zeros[PROBLEM_BINARY_ALIGNMENT];
+    if (length > 0 && fwrite(bytes, 1, (size_t)length, file) != length) {
+        return -1;
+    }
+    size_t padding = (size_t)(align_up(length) - length);
+    if (padding > 0 && fwrite(zeros, 1, padding, file) != padding) {
+        return -1;
+    }
+    return 0;
+}
+
+uint64_t problem_binary_layout(ProblemBinaryHeader* header, int64_t num_constraints,
+                               int64_t num_variables, int64_t nnz, unsigned absent) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, PROBLEM_BINARY_MAGIC, sizeof(header->magic));
+    header->version = PROBLEM_BINARY_VERSION;
+    header->header_size = (uint32_t)align_up(sizeof(ProblemBinaryHeader));
+    header->int_size = sizeof(cuopt_int_t);
+    header->float_size = sizeof(cuopt_float_t);
+    header->num_constraints = num_constraints;
+    header->num_variables = num_variables;
+    header->nnz = nnz;
+    header->num_sections = NUM_SECTIONS;
+    
+    // Lay the sections out back to back, each on an aligned boundary
+    uint64_t offset = header->header_size;
+    for (size_t i = 0; i < NUM_SECTIONS; i++) {
+        ProblemBinarySection* section = &header->sections[i];
+        section->id = section_layout[i].id;
+        section->elem_size = (uint32_t)section_layout[i].elem_size;
+        section->offset = offset;
+        section->count = (absent & (1u << section_layout[i].id)) ? 0 :
+                         section_count(section_layout[i].count, num_constraints, num_variables, nnz);
+        offset = align_up(offset + section->count * section->elem_size);
+    }
+    header->header_checksum = header_checksum(header);
+    return offset;
+}
+
+int problem_binary_write(JobContext* ctx, const char* filename, const ProblemData* data) {
+    if (!host_is_little_endian()) {
+        job_printf(ctx, "Error: Binary problem files can only be written on little-endian hosts\n");
+        return -1;
+    }
+    
+    // Arrays the JSON did not provide (e.g. no constraint_bounds with the
+    // cJSON parser) are stored as empty sections and load as NULL
+    ProblemData* fields = (ProblemData*)data;
+    const void* arrays[NUM_SECTIONS];
+    unsigned absent = 0;
+    for (size_t i = 0; i < NUM_SECTIONS; i++) {
+        arrays[i] = *field_pointer(fields, section_layout[i].field);
+        if (!arrays[i]) {
+            absent |= 1u << section_layout[i].id;
+        }
+    }
+    
+    ProblemBinaryHeader header;
+    problem_binary_layout(&header, data->num_constraints, data->num_variables, data->nnz, absent);
+    header.objective_sense = data->objective_sense;
+    header.objective_offset = data->objective_offset;
+    header.objective_scaling_factor = data->objective_scaling_factor;
+    for (size_t i = 0; i < NUM_SECTIONS; i++) {
+        ProblemBinarySection* section = &header.sections[i];
+        section->checksum = hash64(arrays[i], (size_t)(section->count * section->elem_size), 0);
+    }
+    header.header_checksum = header_checksum(&header);
+    
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        job_printf(ctx, "Error: Cannot create file %s\n", filename);
+        return -1;
+    }
+    
+    int failed = write_padded(file, &header, sizeof(header));
+    for (size_t i = 0; i < NUM_SECTIONS && !failed; i++) {
+        const ProblemBinarySection* section = &header.sections[i];
+        failed = write_padded(file, arrays[i], section->count * section->elem_size);
+    }
+    if (fclose(file) != 0) {
+        failed = -1;
+    }
+    
+    if (failed) {
+        job_printf(ctx, "Error: Failed to write %s\n", filename);
+        remove(filename);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    const char* base;
+    const ProblemBinarySection* sections[NUM_SECTIONS];
+    int mismatch;
+} ChecksumJob;
+
+static void verify_section(void* arg, size_t index) {
+    ChecksumJob* job = arg;
+    const ProblemBinarySection* section = job->sections[index];
+    uint64_t actual = hash64(job->base + section->offset, (size_t)(section->count * section->elem_size), 0);
+    if (actual != section->checksum) {
+        __atomic_store_n(&job->mismatch, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Check everything in the header against the file before trusting it
+static int validate_header(JobContext* ctx, const ProblemBinaryHeader* header, size_t file_size,
+                           const ProblemBinarySection* sections[NUM_SECTIONS]) {
+    if (memcmp(header->magic, PROBLEM_BINARY_MAGIC, sizeof(header->magic)) != 0) {
+        job_printf(ctx, "Error: Not a binary problem file\n");
+        return -1;
+    }
+    // Version 1 only lacks the scaling factor, which it stored as zero
+    if (header->version != PROBLEM_BINARY_VERSION && header->version != 1) {
+        job_printf(ctx, "Error: Unsupported binary problem file version %u (expected %d)\n",
+                   header->version, PROBLEM_BINARY_VERSION);
+        return -1;
+    }
+    if (header_checksum(header) != header->header_checksum) {
+        job_printf(ctx, "Error: Binary problem file header is corrupted (checksum mismatch)\n");
+        return -1;
+    }
+    if (header->int_size != sizeof(cuopt_int_t) || header->float_size != sizeof(cuopt_float_t)) {
+        job_printf(ctx, "Error: Binary problem file uses %u-byte integers and %u-byte floats, "
+                   "this build expects %zu and %zu\n", header->int_size, header->float_size,
+                   sizeof(cuopt_int_t), sizeof(cuopt_float_t));
+        return -1;
+    }
+    if (header->header_size < sizeof(ProblemBinaryHeader) || header->header_size > file_size ||
+        header->num_sections > PROBLEM_BINARY_MAX_SECTIONS) {
+        job_printf(ctx, "Error: Binary problem file header is malformed\n");
+        return -1;
+    }
+    
+    // The sizes must fit in cuopt_int_t once loaded
+    const int64_t int_max = sizeof(cuopt_int_t) == 8 ? INT64_MAX : INT32_MAX;
+    if (header->num_constraints < 0 || header->num_constraints >= int_max ||
+        header->num_variables < 0 || header->num_variables > int_max ||
+        header->nnz < 0 || header->nnz > int_max) {
+        job_printf(ctx, "Error: Binary problem file has invalid problem sizes\n");
+        return -1;
+    }
+    
+    for (size_t i = 0; i < NUM_SECTIONS; i++) {
+        const ProblemBinarySection* found = NULL;
+        for (uint32_t j = 0; j < header->num_sections; j++) {
+            if (header->sections[j].id == (uint32_t)section_layout[i].id) {
+                found = &header->sections[j];
+                break;
+            }
+        }
+        uint64_t expected = section_count(section_layout[i].count, header->num_constraints,
+                                          header->num_variables, header->nnz);
+        if (!found || found->elem_size != section_layout[i].elem_size ||
+            (found->count != expected && found->count != 0) ||
+            found->offset % found->elem_size != 0 || found->offset > file_size ||
+            found->count > (file_size - found->offset) / found->elem_size) {
+            job_printf(ctx, "Error: Binary problem file section %d is missing or malformed\n",
+                       (int)section_layout[i].id);
+            return -1;
+        }
+        sections[i] = found;
+    }
+    return 0;
+}
+
+int problem_binary_attach(JobContext* ctx, void* image, size_t size, ProblemData* data,
+                          int verify) {
+    if (!host_is_little_endian()) {
+        job_printf(ctx, "Error: Binary problem images can only be loaded on little-endian hosts\n");
+        return -1;
+    }
+    if (size < sizeof(ProblemBinaryHeader)) {
+        job_printf(ctx, "Error: Binary problem image is truncated\n");
+        return -1;
+    }
+    
+    ProblemBinaryHeader header;
+    memcpy(&header, image, sizeof(header));
+    ChecksumJob job;
+    memset(&job, 0, sizeof(job));
+    job.base = image;
+    if (validate_header(ctx, &header, size, job.sections) != 0) {
+        return -1;
+    }
+    
+    if (verify) {
+        log_timestamp(ctx, "BINARY_CHECKSUM_START");
+        Timer checksum_timer;
+        start_timer(ctx, &checksum_timer);
+        
+        thread_pool_parallel_for(job_thread_pool(ctx), NUM_SECTIONS, verify_section, &job);
+        
+        double checksum_time = end_timer(ctx, &checksum_timer);
+        log_timestamp(ctx, "BINARY_CHECKSUM_END");
+        log_phase_duration(ctx, "BINARY_CHECKSUM", checksum_time);
+        log_phase_throughput(ctx, "BINARY_CHECKSUM", size, checksum_time);
+        
+        if (job.mismatch) {
+            job_printf(ctx, "Error: Binary problem data is corrupted (checksum mismatch)\n");
+            return -1;
+        }
+    }
+    
+    data->num_constraints = (cuopt_int_t)header.num_constraints;
+    data->num_variables = (cuopt_int_t)header.num_variables;
+    data->nnz = (cuopt_int_t)header.nnz;
+    data->objective_sense = header.objective_sense;
+    data->objective_offset = header.objective_offset;
+    data->objective_scaling_factor = header.objective_scaling_factor;
+    for (size_t i = 0; i < NUM_SECTIONS; i++) {
+        const ProblemBinarySection* section = job.sections[i];
+        int absent = section->count == 0 &&
+                     section_count(section_layout[i].count, header.num_constraints,
+                                   header.num_variables, header.nnz) > 0;
+        *field_pointer(data, section_layout[i].field) = absent ? NULL : (char*)image + section->offset;
+    }
+    return 0;
+}
+
+int problem_binary_load(JobContext* ctx, const char* filename, ProblemData* data) {
+    Timer timer;
+    log_timestamp(ctx, "BINARY_LOAD_START");
+    start_timer(ctx, &timer);
+    
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        job_printf(ctx, "Error: Cannot open file %s\n", filename);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        (size_t)st.st_size < sizeof(ProblemBinaryHeader)) {
+        job_printf(ctx, "Error: %s is not a valid binary problem file\n", filename);
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    
+    // Copy-on-write, so later in-place edits of the arrays never reach the file
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        job_printf(ctx, "Error: Cannot map file %s\n", filename);
+        return -1;
+    }
+    
+    if (problem_binary_attach(ctx, mapping, size, data, 1) != 0) {
+        job_printf(ctx, "Error: Failed to load binary problem file %s\n", filename);
+        munmap(mapping, size);
+        return -1;
+    }
+    data->mapping = mapping;
+    data->mapping_size = size;
+    
+    double load_time = end_timer(ctx, &timer);
+    log_timestamp(ctx, "BINARY_LOAD_END");
+    log_phase_duration(ctx, "BINARY_LOAD", load_time);
+    log_phase_throughput(ctx, "BINARY_LOAD", size, load_time);
+    return 0;
+}
+
+void problem_binary_unmap(void* mapping, size_t size) {
+    if (mapping) {
+        munmap(mapping, size);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * problem_binary.h - ".cuopt.bin" binary problem files
+ *
+ * A binary problem file stores the ProblemData arrays verbatim so a model
+ * parsed once from JSON can be reloaded without parsing. Layout (all
+ * integers little-endian):
+ *
+ *   header      ProblemBinaryHeader, zero-padded to header_size bytes
+ *   sections    one per array, each starting on a 64-byte boundary
+ *
+ * The header records the problem sizes, sense, offset and scaling factor, the element
+ * sizes the file was written with, a section table and an XXH64 checksum
+ * of itself; each section table entry carries the checksum of its bytes.
+ * Loading maps the file copy-on-write and points the ProblemData arrays
+ * straight into the mapping, so nothing is copied.
+ */
+
+#ifndef PROBLEM_BINARY_H
+#define PROBLEM_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cuopt_json_to_c_api.h"
+
+#define PROBLEM_BINARY_MAGIC "CUOPTBIN"
+#define PROBLEM_BINARY_VERSION 2
+
+// Sections start on this boundary so arrays are aligned for SIMD loads
+#define PROBLEM_BINARY_ALIGNMENT 64
+
+#define PROBLEM_BINARY_MAX_SECTIONS 12
+
+typedef enum {
+    PROBLEM_SECTION_ROW_OFFSETS = 1,
+    PROBLEM_SECTION_COLUMN_INDICES,
+    PROBLEM_SECTION_MATRIX_VALUES,
+    PROBLEM_SECTION_OBJECTIVE_COEFFICIENTS,
+    PROBLEM_SECTION_CONSTRAINT_LOWER_BOUNDS,
+    PROBLEM_SECTION_CONSTRAINT_UPPER_BOUNDS,
+    PROBLEM_SECTION_VARIABLE_LOWER_BOUNDS,
+    PROBLEM_SECTION_VARIABLE_UPPER_BOUNDS,
+    PROBLEM_SECTION_VARIABLE_TYPES
+} ProblemSectionId;
+
+typedef struct {
+    uint32_t id;          // ProblemSectionId
+    uint32_t elem_size;   // bytes per element
+    uint64_t offset;      // from the start of the file
+    uint64_t count;       // number of elements
+    uint64_t checksum;    // XXH64 of the section bytes
+} ProblemBinarySection;
+
+typedef struct {
+    char magic[8];                 // PROBLEM_BINARY_MAGIC, not NUL-terminated
+    uint32_t version;              // PROBLEM_BINARY_VERSION
+    uint32_t header_size;          // offset of the first section
+    uint32_t int_size;             // sizeof(cuopt_int_t) of the writer
+    uint32_t float_size;           // sizeof(cuopt_float_t) of the writer
+    int64_t num_constraints;
+    int64_t num_variables;
+    int64_t nnz;
+    int32_t objective_sense;
+    uint32_t num_sections;
+    double objective_offset;
+    uint64_t header_checksum;      // XXH64 of the header with this field zeroed
+    double objective_scaling_factor;  // 0 in version 1 files, meaning 1
+    ProblemBinarySection sections[PROBLEM_BINARY_MAX_SECTIONS];
+} ProblemBinaryHeader;
+
+// Return 1 if `filename` is a regular file starting with the binary magic
+int problem_binary_probe(const char* filename);
+
+// Fill `header` for a problem of the given sizes, with the sections laid
+// out after it and their checksums zero, and return the total image size.
+// Sections whose bit (1 << ProblemSectionId) is set in `absent` are stored
+// empty and load as NULL.
+uint64_t problem_binary_layout(ProblemBinaryHeader* header, int64_t num_constraints,
+                               int64_t num_variables, int64_t nnz, unsigned absent);
+
+// Write `data` to `filename`. Returns 0 on success, -1 on failure (an error
+// has been printed and the partial file removed).
+int problem_binary_write(JobContext* ctx, const char* filename, const ProblemData* data);
+
+// Point the arrays of `data` into a binary image already in memory (its
+// header first). With `verify`, section checksums are checked on the job's
+// thread pool. Returns 0 on success, -1 if the image is malformed.
+int problem_binary_attach(JobContext* ctx, void* image, size_t size, ProblemData* data,
+                          int verify);
+
+// Map `filename` and point the arrays of `data` into the mapping. Section
+// checksums are verified on the job's thread pool. Returns 0 on success, -1
+// on failure.
+int problem_binary_load(JobContext* ctx, const char* filename, ProblemData* data);
+
+// Release the mapping behind a ProblemData filled by problem_binary_load
+void problem_binary_unmap(void* mapping, size_t size);
+
+#endif // PROBLEM_BINARY_H
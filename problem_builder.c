@@ -0,0 +1,919 @@
+/*
+ * problem_builder.c - Fill ProblemData directly from JSON token events
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "problem_builder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json_index.h"
+#include "json_number.h"
+#include "name_table.h"
+#include "numeric_array.h"
+
+// Growable array; `elem_size` is fixed by the array's role
+typedef struct {
+    void* data;
+    size_t size;
+    size_t capacity;
+    size_t elem_size;
+    int seen;  // the key was present in the document
+} GrowArray;
+
+// Initial capacity when an array starts; grows by doubling afterwards
+#define GROW_ARRAY_INITIAL_CAPACITY 1024
+
+// Numeric arrays with at least this much text are counted up front and
+// converted in parallel chunks instead of element by element
+#define BULK_ARRAY_MIN_BYTES (64 * 1024)
+
+// Top-level keys of the cuOpt JSON format
+typedef enum {
+    SECTION_NONE,
+    SECTION_CSR_MATRIX,
+    SECTION_OBJECTIVE_DATA,
+    SECTION_CONSTRAINT_BOUNDS,
+    SECTION_VARIABLE_BOUNDS,
+    SECTION_MAXIMIZE,
+    SECTION_VARIABLE_TYPES,
+    SECTION_VARIABLE_NAMES,
+    SECTION_ROW_NAMES,
+    SECTION_OTHER
+} Section;
+
+// Keys inside the section objects
+typedef enum {
+    FIELD_NONE,
+    FIELD_OFFSETS,
+    FIELD_INDICES,
+    FIELD_VALUES,
+    FIELD_COEFFICIENTS,
+    FIELD_OFFSET,
+    FIELD_SCALABILITY_FACTOR,
+    FIELD_LOWER_BOUNDS,
+    FIELD_UPPER_BOUNDS,
+    FIELD_BOUNDS,
+    FIELD_TYPES,
+    FIELD_OTHER
+} Field;
+
+// Arrays the builder collects
+typedef enum {
+    TARGET_ROW_OFFSETS,
+    TARGET_COLUMN_INDICES,
+    TARGET_MATRIX_VALUES,
+    TARGET_OBJECTIVE_COEFFICIENTS,
+    TARGET_CONSTRAINT_LOWER_BOUNDS,
+    TARGET_CONSTRAINT_UPPER_BOUNDS,
+    TARGET_CONSTRAINT_BOUNDS,
+    TARGET_CONSTRAINT_TYPES,
+    TARGET_VARIABLE_LOWER_BOUNDS,
+    TARGET_VARIABLE_UPPER_BOUNDS,
+    TARGET_VARIABLE_TYPES,
+    TARGET_VARIABLE_NAMES,
+    TARGET_ROW_NAMES,
+    TARGET_COUNT,
+    TARGET_NONE = TARGET_COUNT
+} Target;
+
+static const char* target_names[TARGET_COUNT] = {
+    "csr_constraint_matrix.offsets",
+    "csr_constraint_matrix.indices",
+    "csr_constraint_matrix.values",
+    "objective_data.coefficients",
+    "constraint_bounds.lower_bounds",
+    "constraint_bounds.upper_bounds",
+    "constraint_bounds.bounds",
+    "constraint_bounds.types",
+    "variable_bounds.lower_bounds",
+    "variable_bounds.upper_bounds",
+    "variable_types",
+    "variable_names",
+    "row_names"
+};
+
+// Phase a top-level section is timed as, the same as in the cJSON front end
+typedef struct {
+    const char* phase;
+    const char* start;
+    const char* end;
+} SectionPhase;
+
+static const SectionPhase section_phases[] = {
+    { "CSR_MATRIX_PARSE", "CSR_MATRIX_PARSE_START", "CSR_MATRIX_PARSE_END" },
+    { "OBJECTIVE_PARSE", "OBJECTIVE_PARSE_START", "OBJECTIVE_PARSE_END" },
+    { "CONSTRAINT_BOUNDS_PARSE", "CONSTRAINT_BOUNDS_PARSE_START", "CONSTRAINT_BOUNDS_PARSE_END" },
+    { "VARIABLE_BOUNDS_PARSE", "VARIABLE_BOUNDS_PARSE_START", "VARIABLE_BOUNDS_PARSE_END" },
+    { "VARIABLE_TYPES_PARSE", "VARIABLE_TYPES_PARSE_START", "VARIABLE_TYPES_PARSE_END" }
+};
+
+struct ProblemBuilder {
+    JobContext* ctx;    // options and output of the job (may be NULL)
+    ThreadPool* pool;   // for bulk array conversion (may be NULL)
+    int depth;          // current container nesting depth
+    Section section;    // key most recently seen at depth 1
+    Field field;        // key most recently seen at depth 2
+    Target target;      // array currently being filled
+    int target_depth;   // depth of the elements of that array
+    const SectionPhase* timed_section;  // section value being parsed, if timed
+    Timer section_timer;
+
+    GrowArray arrays[TARGET_COUNT];   // name arrays only count their entries
+    NameTable* variable_names;
+    NameTable* row_names;
+    int seen_csr_matrix;
+    int seen_objective_data;
+    int seen_constraint_bounds;
+    int seen_variable_bounds;
+    cuopt_float_t objective_offset;
+    cuopt_float_t objective_scaling_factor;
+    int maximize;
+};
+
+static int grow_array_reserve(const JobContext* ctx, GrowArray* array, size_t needed) {
+    if (needed <= array->capacity) {
+        return 0;
+    }
+    size_t capacity = array->capacity ? array->capacity : GROW_ARRAY_INITIAL_CAPACITY;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    void* data = realloc(array->data, capacity * array->elem_size);
+    if (!data) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        return -1;
+    }
+    array->data = data;
+    array->capacity = capacity;
+    return 0;
+}
+
+// Size the buffer for exactly `count` elements, for arrays counted up front
+static int grow_array_resize_exact(const JobContext* ctx, GrowArray* array, size_t count) {
+    if (count != array->capacity) {
+        void* data = realloc(array->data, (count ? count : 1) * array->elem_size);
+        if (!data) {
+            job_printf(ctx, "Error: Memory allocation failed\n");
+            return -1;
+        }
+        array->data = data;
+        array->capacity = count ? count : 1;
+    }
+    array->size = count;
+    return 0;
+}
+
+// Hand the array's buffer to the caller, trimmed to its final size. Empty
+// arrays still get a valid allocation, like malloc(0) in the cJSON path.
+static void* grow_array_release(GrowArray* array) {
+    void* data = array->data;
+    if (data && array->size < array->capacity) {
+        void* trimmed = realloc(data, (array->size ? array->size : 1) * array->elem_size);
+        if (trimmed) {
+            data = trimmed;
+        }
+    } else if (!data) {
+        data = malloc(array->elem_size);
+    }
+    array->data = NULL;
+    array->size = 0;
+    array->capacity = 0;
+    return data;
+}
+
+static int key_equals(const char* str, size_t length, const char* literal) {
+    return strlen(literal) == length && memcmp(str, literal, length) == 0;
+}
+
+static Section lookup_section(const char* key, size_t length) {
+    if (key_equals(key, length, "csr_constraint_matrix")) return SECTION_CSR_MATRIX;
+    if (key_equals(key, length, "objective_data")) return SECTION_OBJECTIVE_DATA;
+    if (key_equals(key, length, "constraint_bounds")) return SECTION_CONSTRAINT_BOUNDS;
+    if (key_equals(key, length, "variable_bounds")) return SECTION_VARIABLE_BOUNDS;
+    if (key_equals(key, length, "maximize")) return SECTION_MAXIMIZE;
+    if (key_equals(key, length, "variable_types")) return SECTION_VARIABLE_TYPES;
+    if (key_equals(key, length, "variable_names")) return SECTION_VARIABLE_NAMES;
+    if (key_equals(key, length, "row_names")) return SECTION_ROW_NAMES;
+    return SECTION_OTHER;
+}
+
+static Field lookup_field(Section section, const char* key, size_t length) {
+    switch (section) {
+        case SECTION_CSR_MATRIX:
+            if (key_equals(key, length, "offsets")) return FIELD_OFFSETS;
+            if (key_equals(key, length, "indices")) return FIELD_INDICES;
+            if (key_equals(key, length, "values")) return FIELD_VALUES;
+            break;
+        case SECTION_OBJECTIVE_DATA:
+            if (key_equals(key, length, "coefficients")) return FIELD_COEFFICIENTS;
+            if (key_equals(key, length, "offset")) return FIELD_OFFSET;
+            if (key_equals(key, length, "scalability_factor")) return FIELD_SCALABILITY_FACTOR;
+            break;
+        case SECTION_CONSTRAINT_BOUNDS:
+            if (key_equals(key, length, "lower_bounds")) return FIELD_LOWER_BOUNDS;
+            if (key_equals(key, length, "upper_bounds")) return FIELD_UPPER_BOUNDS;
+            if (key_equals(key, length, "bounds")) return FIELD_BOUNDS;
+            if (key_equals(key, length, "types")) return FIELD_TYPES;
+            break;
+        case SECTION_VARIABLE_BOUNDS:
+            if (key_equals(key, length, "lower_bounds")) return FIELD_LOWER_BOUNDS;
+            if (key_equals(key, length, "upper_bounds")) return FIELD_UPPER_BOUNDS;
+            break;
+        default:
+            break;
+    }
+    return FIELD_OTHER;
+}
+
+// Which array, if any, an array value starting at the current position fills
+static Target resolve_target(const ProblemBuilder* b) {
+    if (b->depth == 1) {
+        switch (b->section) {
+            case SECTION_VARIABLE_TYPES: return TARGET_VARIABLE_TYPES;
+            case SECTION_VARIABLE_NAMES: return TARGET_VARIABLE_NAMES;
+            case SECTION_ROW_NAMES: return TARGET_ROW_NAMES;
+            default: return TARGET_NONE;
+        }
+    }
+    if (b->depth != 2) {
+        return TARGET_NONE;
+    }
+    switch (b->section) {
+        case SECTION_CSR_MATRIX:
+            if (b->field == FIELD_OFFSETS) return TARGET_ROW_OFFSETS;
+            if (b->field == FIELD_INDICES) return TARGET_COLUMN_INDICES;
+            if (b->field == FIELD_VALUES) return TARGET_MATRIX_VALUES;
+            break;
+        case SECTION_OBJECTIVE_DATA:
+            if (b->field == FIELD_COEFFICIENTS) return TARGET_OBJECTIVE_COEFFICIENTS;
+            break;
+        case SECTION_CONSTRAINT_BOUNDS:
+            if (b->field == FIELD_LOWER_BOUNDS) return TARGET_CONSTRAINT_LOWER_BOUNDS;
+            if (b->field == FIELD_UPPER_BOUNDS) return TARGET_CONSTRAINT_UPPER_BOUNDS;
+            if (b->field == FIELD_BOUNDS) return TARGET_CONSTRAINT_BOUNDS;
+            if (b->field == FIELD_TYPES) return TARGET_CONSTRAINT_TYPES;
+            break;
+        case SECTION_VARIABLE_BOUNDS:
+            if (b->field == FIELD_LOWER_BOUNDS) return TARGET_VARIABLE_LOWER_BOUNDS;
+            if (b->field == FIELD_UPPER_BOUNDS) return TARGET_VARIABLE_UPPER_BOUNDS;
+            break;
+        default:
+            break;
+    }
+    return TARGET_NONE;
+}
+
+static int is_integer_target(Target target) {
+    return target == TARGET_ROW_OFFSETS || target == TARGET_COLUMN_INDICES;
+}
+
+static int is_char_target(Target target) {
+    return target == TARGET_CONSTRAINT_TYPES || target == TARGET_VARIABLE_TYPES;
+}
+
+// Arrays of names, collected into name tables instead of grow arrays
+static int is_name_target(Target target) {
+    return target == TARGET_VARIABLE_NAMES || target == TARGET_ROW_NAMES;
+}
+
+static NameTable** name_table_of(ProblemBuilder* b, Target target) {
+    return target == TARGET_VARIABLE_NAMES ? &b->variable_names : &b->row_names;
+}
+
+static const SectionPhase* section_phase(Section section) {
+    switch (section) {
+        case SECTION_CSR_MATRIX: return &section_phases[0];
+        case SECTION_OBJECTIVE_DATA: return &section_phases[1];
+        case SECTION_CONSTRAINT_BOUNDS: return &section_phases[2];
+        case SECTION_VARIABLE_BOUNDS: return &section_phases[3];
+        case SECTION_VARIABLE_TYPES: return &section_phases[4];
+        default: return NULL;
+    }
+}
+
+// Time the value of a top-level section, called as it opens at depth 1
+static void begin_section(ProblemBuilder* b) {
+    if (b->depth != 1) {
+        return;
+    }
+    b->timed_section = section_phase(b->section);
+    if (b->timed_section) {
+        log_timestamp(b->ctx, b->timed_section->start);
+        start_timer(b->ctx, &b->section_timer);
+    }
+}
+
+// Called as a container closes, back at depth 1 for a section value
+static void end_section(ProblemBuilder* b) {
+    if (b->depth == 1 && b->timed_section) {
+        double section_time = end_timer(b->ctx, &b->section_timer);
+        log_timestamp(b->ctx, b->timed_section->end);
+        log_phase_duration(b->ctx, b->timed_section->phase, section_time);
+        b->timed_section = NULL;
+    }
+}
+
+// Mark the section objects we have entered
+static void note_section_object(ProblemBuilder* b) {
+    if (b->depth != 1) {
+        return;
+    }
+    switch (b->section) {
+        case SECTION_CSR_MATRIX: b->seen_csr_matrix = 1; break;
+        case SECTION_OBJECTIVE_DATA: b->seen_objective_data = 1; break;
+        case SECTION_CONSTRAINT_BOUNDS: b->seen_constraint_bounds = 1; break;
+        case SECTION_VARIABLE_BOUNDS: b->seen_variable_bounds = 1; break;
+        default: break;
+    }
+}
+
+static int on_start_object(void* user) {
+    ProblemBuilder* b = user;
+    if (b->target != TARGET_NONE) {
+        job_printf(b->ctx, "Error: Unexpected object inside %s\n", target_names[b->target]);
+        return -1;
+    }
+    note_section_object(b);
+    begin_section(b);
+    b->depth++;
+    if (b->depth == 2) {
+        b->field = FIELD_NONE;
+    }
+    return 0;
+}
+
+static int on_end_object(void* user) {
+    ProblemBuilder* b = user;
+    b->depth--;
+    end_section(b);
+    return 0;
+}
+
+static int on_start_array(void* user) {
+    ProblemBuilder* b = user;
+    if (b->depth == 0) {
+        job_printf(b->ctx, "Error: Top-level JSON value must be an object\n");
+        return -1;
+    }
+    if (b->target != TARGET_NONE) {
+        job_printf(b->ctx, "Error: Unexpected nested array inside %s\n", target_names[b->target]);
+        return -1;
+    }
+    Target target = resolve_target(b);
+    if (target != TARGET_NONE) {
+        GrowArray* array = &b->arrays[target];
+        array->size = 0;
+        array->seen = 1;
+        if (is_name_target(target)) {
+            NameTable** table = name_table_of(b, target);
+            name_table_free(*table);
+            *table = name_table_create(b->ctx);
+            if (!*table) {
+                return -1;
+            }
+        } else if (grow_array_reserve(b->ctx, array, GROW_ARRAY_INITIAL_CAPACITY) != 0) {
+            return -1;
+        }
+        b->target = target;
+        b->target_depth = b->depth + 1;
+    }
+    begin_section(b);
+    b->depth++;
+    return 0;
+}
+
+static int on_end_array(void* user) {
+    ProblemBuilder* b = user;
+    if (b->target != TARGET_NONE && b->depth == b->target_depth) {
+        b->target = TARGET_NONE;
+    }
+    b->depth--;
+    end_section(b);
+    return 0;
+}
+
+// Take over large numeric arrays: count the elements, allocate the target
+// once, and convert the text in parallel chunks. Malformed arrays are left
+// to the tokenizer, which reports the exact error location.
+static int on_raw_array(void* user, const char* begin, const char* end, const char** resume) {
+    ProblemBuilder* b = user;
+    if (b->depth == 0 || b->target != TARGET_NONE) {
+        return 0;
+    }
+    Target target = resolve_target(b);
+    if (target == TARGET_NONE || is_char_target(target) || is_name_target(target)) {
+        return 0;
+    }
+    const char* close = memchr(begin + 1, ']', (size_t)(end - begin - 1));
+    if (!close || (size_t)(close - begin - 1) < BULK_ARRAY_MIN_BYTES) {
+        return 0;
+    }
+
+    Timer array_timer;
+    start_timer(b->ctx, &array_timer);
+
+    NumericArrayPlan plan;
+    if (numeric_array_plan(begin + 1, (size_t)(close - begin - 1), b->pool, &plan) != 0) {
+        return 0;
+    }
+    GrowArray* array = &b->arrays[target];
+    if (grow_array_resize_exact(b->ctx, array, plan.count) != 0) {
+        numeric_array_plan_free(&plan);
+        return -1;
+    }
+    NumericArrayType type = is_integer_target(target) ? NUMERIC_ARRAY_INT : NUMERIC_ARRAY_FLOAT;
+    int result = numeric_array_parse(&plan, type, array->data, b->pool);
+    numeric_array_plan_free(&plan);
+    if (result != 0) {
+        array->size = 0;
+        return 0;
+    }
+    array->seen = 1;
+    *resume = close + 1;
+
+    double array_time = end_timer(b->ctx, &array_timer);
+    char phase[96];
+    snprintf(phase, sizeof(phase), "ARRAY_PARSE(%s)", target_names[target]);
+    log_phase_duration(b->ctx, phase, array_time);
+    log_phase_throughput(b->ctx, phase, (size_t)(close - begin), array_time);
+    return 0;
+}
+
+static int on_key(void* user, const char* str, size_t length) {
+    ProblemBuilder* b = user;
+    if (b->depth == 1) {
+        b->section = lookup_section(str, length);
+        b->field = FIELD_NONE;
+    } else if (b->depth == 2) {
+        b->field = lookup_field(b->section, str, length);
+    }
+    return 0;
+}
+
+static int append_float(ProblemBuilder* b, cuopt_float_t value) {
+    GrowArray* array = &b->arrays[b->target];
+    if (array->size == array->capacity && grow_array_reserve(b->ctx, array, array->size + 1) != 0) {
+        return -1;
+    }
+    ((cuopt_float_t*)array->data)[array->size++] = value;
+    return 0;
+}
+
+static int append_int(ProblemBuilder* b, cuopt_int_t value) {
+    GrowArray* array = &b->arrays[b->target];
+    if (array->size == array->capacity && grow_array_reserve(b->ctx, array, array->size + 1) != 0) {
+        return -1;
+    }
+    ((cuopt_int_t*)array->data)[array->size++] = value;
+    return 0;
+}
+
+static int append_char(ProblemBuilder* b, char value) {
+    GrowArray* array = &b->arrays[b->target];
+    if (array->size == array->capacity && grow_array_reserve(b->ctx, array, array->size + 1) != 0) {
+        return -1;
+    }
+    ((char*)array->data)[array->size++] = value;
+    return 0;
+}
+
+static int append_name(ProblemBuilder* b, const char* str, size_t length) {
+    if (name_table_append(b->ctx, *name_table_of(b, b->target), str, length) != 0) {
+        return -1;
+    }
+    b->arrays[b->target].size++;
+    return 0;
+}
+
+static int on_number(void* user, const char* text, size_t length) {
+    ProblemBuilder* b = user;
+
+    if (b->target == TARGET_NONE) {
+        if (b->depth == 2 && b->section == SECTION_OBJECTIVE_DATA && b->field == FIELD_OFFSET) {
+            if (json_number_to_float(text, length, &b->objective_offset) != 0) {
+                job_printf(b->ctx, "Error: Invalid number in objective_data.offset\n");
+                return -1;
+            }
+        }
+        if (b->depth == 2 && b->section == SECTION_OBJECTIVE_DATA &&
+            b->field == FIELD_SCALABILITY_FACTOR &&
+            json_number_to_float(text, length, &b->objective_scaling_factor) != 0) {
+            job_printf(b->ctx, "Error: Invalid number in objective_data.scalability_factor\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (is_integer_target(b->target)) {
+        cuopt_int_t value;
+        switch (json_number_to_int(text, length, &value)) {
+            case JSON_NUMBER_OK:
+                return append_int(b, value);
+            case JSON_NUMBER_OVERFLOW:
+                job_printf(b->ctx, "Error: Value %.*s in %s is out of range for cuopt_int_t\n",
+                           (int)length, text, target_names[b->target]);
+                return -1;
+            case JSON_NUMBER_NOT_INTEGRAL:
+                job_printf(b->ctx, "Error: Non-integer value %.*s in %s\n", (int)length, text,
+                           target_names[b->target]);
+                return -1;
+            default:
+                job_printf(b->ctx, "Error: Invalid number in %s\n", target_names[b->target]);
+                return -1;
+        }
+    }
+    if (is_char_target(b->target) || is_name_target(b->target)) {
+        job_printf(b->ctx, "Error: Expected strings in %s\n", target_names[b->target]);
+        return -1;
+    }
+
+    cuopt_float_t value;
+    if (json_number_to_float(text, length, &value) != 0) {
+        job_printf(b->ctx, "Error: Invalid number in %s\n", target_names[b->target]);
+        return -1;
+    }
+    return append_float(b, value);
+}
+
+static int on_string(void* user, const char* str, size_t length) {
+    ProblemBuilder* b = user;
+
+    if (b->target == TARGET_NONE) {
+        if (b->depth == 2 && b->section == SECTION_OBJECTIVE_DATA && b->field == FIELD_OFFSET) {
+            b->objective_offset = parse_numeric_string(str, length);
+        }
+        if (b->depth == 2 && b->section == SECTION_OBJECTIVE_DATA &&
+            b->field == FIELD_SCALABILITY_FACTOR) {
+            b->objective_scaling_factor = parse_numeric_string(str, length);
+        }
+        return 0;
+    }
+
+    switch (b->target) {
+        case TARGET_ROW_OFFSETS:
+        case TARGET_COLUMN_INDICES:
+            job_printf(b->ctx, "Error: Expected integers in %s\n", target_names[b->target]);
+            return -1;
+        case TARGET_VARIABLE_TYPES:
+            return append_char(b, key_equals(str, length, "I") ? CUOPT_INTEGER : CUOPT_CONTINUOUS);
+        case TARGET_CONSTRAINT_TYPES:
+            if (length != 1 || (str[0] != 'L' && str[0] != 'G' && str[0] != 'E')) {
+                job_printf(b->ctx,
+                           "Error: Unknown constraint type '%.*s' (expected \"L\", \"G\" or \"E\")\n",
+                           (int)length, str);
+                return -1;
+            }
+            return append_char(b, str[0]);
+        case TARGET_VARIABLE_NAMES:
+        case TARGET_ROW_NAMES:
+            return append_name(b, str, length);
+        default:
+            // Bounds may be written as strings, e.g. "inf" or "-inf"
+            return append_float(b, parse_numeric_string(str, length));
+    }
+}
+
+static int on_bool(void* user, int value) {
+    ProblemBuilder* b = user;
+    if (b->target != TARGET_NONE) {
+        job_printf(b->ctx, "Error: Unexpected boolean in %s\n", target_names[b->target]);
+        return -1;
+    }
+    if (b->depth == 1 && b->section == SECTION_MAXIMIZE) {
+        b->maximize = value;
+    }
+    return 0;
+}
+
+static int on_null(void* user) {
+    ProblemBuilder* b = user;
+    if (b->target != TARGET_NONE) {
+        job_printf(b->ctx, "Error: Unexpected null in %s\n", target_names[b->target]);
+        return -1;
+    }
+    return 0;
+}
+
+static const JsonSaxHandler builder_handler = {
+    on_start_object,
+    on_end_object,
+    on_start_array,
+    on_end_array,
+    on_key,
+    on_string,
+    on_number,
+    on_bool,
+    on_null,
+    on_raw_array
+};
+
+const JsonSaxHandler* problem_builder_handler(void) {
+    return &builder_handler;
+}
+
+ProblemBuilder* problem_builder_create(JobContext* ctx) {
+    ProblemBuilder* b = calloc(1, sizeof(ProblemBuilder));
+    if (!b) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        return NULL;
+    }
+    b->ctx = ctx;
+    b->pool = ctx ? ctx->pool : NULL;
+    b->target = TARGET_NONE;
+    b->objective_scaling_factor = 1.0;
+    for (int t = 0; t < TARGET_COUNT; t++) {
+        if (is_integer_target((Target)t)) {
+            b->arrays[t].elem_size = sizeof(cuopt_int_t);
+        } else if (is_char_target((Target)t)) {
+            b->arrays[t].elem_size = sizeof(char);
+        } else {
+            b->arrays[t].elem_size = sizeof(cuopt_float_t);
+        }
+    }
+    return b;
+}
+
+void problem_builder_destroy(ProblemBuilder* builder) {
+    if (builder) {
+        for (int t = 0; t < TARGET_COUNT; t++) {
+            free(builder->arrays[t].data);
+        }
+        name_table_free(builder->variable_names);
+        name_table_free(builder->row_names);
+        free(builder);
+    }
+}
+
+// Check that an array that must line up with rows or columns has the right length
+static int check_length(const ProblemBuilder* b, Target target, size_t expected) {
+    if (b->arrays[target].size != expected) {
+        job_printf(b->ctx, "Error: %s has %zu entries, expected %zu\n",
+                   target_names[target], b->arrays[target].size, expected);
+        return -1;
+    }
+    return 0;
+}
+
+// Fill an array with a constant, used for missing optional bounds
+static cuopt_float_t* filled_array(size_t count, cuopt_float_t value) {
+    cuopt_float_t* array = malloc((count ? count : 1) * sizeof(cuopt_float_t));
+    if (array) {
+        for (size_t i = 0; i < count; i++) {
+            array[i] = value;
+        }
+    }
+    return array;
+}
+
+int problem_builder_finish(ProblemBuilder* b, ProblemData* data) {
+    GrowArray* arrays = b->arrays;
+
+    if (!b->seen_csr_matrix) {
+        job_printf(b->ctx, "Error: Missing csr_constraint_matrix in JSON\n");
+        return -1;
+    }
+    if (!arrays[TARGET_ROW_OFFSETS].seen || !arrays[TARGET_COLUMN_INDICES].seen ||
+        !arrays[TARGET_MATRIX_VALUES].seen || arrays[TARGET_ROW_OFFSETS].size == 0) {
+        job_printf(b->ctx, "Error: Invalid CSR matrix format\n");
+        return -1;
+    }
+    if (!b->seen_objective_data) {
+        job_printf(b->ctx, "Error: Missing objective_data in JSON\n");
+        return -1;
+    }
+    if (!(b->objective_scaling_factor > 0.0 && b->objective_scaling_factor < CUOPT_INFINITY)) {
+        job_printf(b->ctx, "Error: objective_data.scalability_factor must be positive and finite\n");
+        return -1;
+    }
+
+    size_t num_constraints = arrays[TARGET_ROW_OFFSETS].size - 1;
+    size_t nnz = arrays[TARGET_COLUMN_INDICES].size;
+    size_t num_variables = arrays[TARGET_OBJECTIVE_COEFFICIENTS].size;
+
+    if (check_length(b, TARGET_MATRIX_VALUES, nnz) != 0) {
+        return -1;
+    }
+
+    int has_constraint_ranges = arrays[TARGET_CONSTRAINT_LOWER_BOUNDS].seen &&
+                                arrays[TARGET_CONSTRAINT_UPPER_BOUNDS].seen;
+    int has_constraint_types = arrays[TARGET_CONSTRAINT_BOUNDS].seen &&
+                               arrays[TARGET_CONSTRAINT_TYPES].seen;
+    if (b->seen_constraint_bounds) {
+        if (has_constraint_ranges) {
+            if (check_length(b, TARGET_CONSTRAINT_LOWER_BOUNDS, num_constraints) != 0 ||
+                check_length(b, TARGET_CONSTRAINT_UPPER_BOUNDS, num_constraints) != 0) {
+                return -1;
+            }
+        } else if (has_constraint_types) {
+            if (check_length(b, TARGET_CONSTRAINT_BOUNDS, num_constraints) != 0 ||
+                check_length(b, TARGET_CONSTRAINT_TYPES, num_constraints) != 0) {
+                return -1;
+            }
+        } else {
+            job_printf(b->ctx, "Error: constraint_bounds needs lower_bounds/upper_bounds or bounds/types\n");
+            return -1;
+        }
+    }
+
+    if ((arrays[TARGET_VARIABLE_LOWER_BOUNDS].seen &&
+         check_length(b, TARGET_VARIABLE_LOWER_BOUNDS, num_variables) != 0) ||
+        (arrays[TARGET_VARIABLE_UPPER_BOUNDS].seen &&
+         check_length(b, TARGET_VARIABLE_UPPER_BOUNDS, num_variables) != 0) ||
+        (arrays[TARGET_VARIABLE_TYPES].seen &&
+         check_length(b, TARGET_VARIABLE_TYPES, num_variables) != 0) ||
+        (arrays[TARGET_VARIABLE_NAMES].seen &&
+         check_length(b, TARGET_VARIABLE_NAMES, num_variables) != 0) ||
+        (arrays[TARGET_ROW_NAMES].seen &&
+         check_length(b, TARGET_ROW_NAMES, num_constraints) != 0)) {
+        return -1;
+    }
+
+    ProblemData result;
+    memset(&result, 0, sizeof(ProblemData));
+    result.num_constraints = (cuopt_int_t)num_constraints;
+    result.num_variables = (cuopt_int_t)num_variables;
+    result.nnz = (cuopt_int_t)nnz;
+    result.objective_offset = b->objective_offset;
+    result.objective_scaling_factor = b->objective_scaling_factor;
+    result.objective_sense = b->maximize ? CUOPT_MAXIMIZE : CUOPT_MINIMIZE;
+
+    if (b->seen_constraint_bounds && !has_constraint_ranges) {
+        // Convert the bounds and types format to ranges
+        const cuopt_float_t* bounds = arrays[TARGET_CONSTRAINT_BOUNDS].data;
+        const char* types = arrays[TARGET_CONSTRAINT_TYPES].data;
+        result.constraint_lower_bounds = malloc((num_constraints ? num_constraints : 1) * sizeof(cuopt_float_t));
+        result.constraint_upper_bounds = malloc((num_constraints ? num_constraints : 1) * sizeof(cuopt_float_t));
+        if (!result.constraint_lower_bounds || !result.constraint_upper_bounds) {
+            job_printf(b->ctx, "Error: Memory allocation failed\n");
+            free_problem_data(&result);
+            return -1;
+        }
+        for (size_t i = 0; i < num_constraints; i++) {
+            if (types[i] == 'L') {  // Less than or equal
+                result.constraint_lower_bounds[i] = -CUOPT_INFINITY;
+                result.constraint_upper_bounds[i] = bounds[i];
+            } else if (types[i] == 'G') {  // Greater than or equal
+                result.constraint_lower_bounds[i] = bounds[i];
+                result.constraint_upper_bounds[i] = CUOPT_INFINITY;
+            } else {  // Equal
+                result.constraint_lower_bounds[i] = bounds[i];
+                result.constraint_upper_bounds[i] = bounds[i];
+            }
+        }
+    } else if (b->seen_constraint_bounds) {
+        result.constraint_lower_bounds = grow_array_release(&arrays[TARGET_CONSTRAINT_LOWER_BOUNDS]);
+        result.constraint_upper_bounds = grow_array_release(&arrays[TARGET_CONSTRAINT_UPPER_BOUNDS]);
+    }
+
+    if (b->seen_variable_bounds) {
+        // A missing side gets its default
+        result.variable_lower_bounds = arrays[TARGET_VARIABLE_LOWER_BOUNDS].seen
+            ? grow_array_release(&arrays[TARGET_VARIABLE_LOWER_BOUNDS])
+            : filled_array(num_variables, DEFAULT_VARIABLE_LOWER_BOUND);
+        result.variable_upper_bounds = arrays[TARGET_VARIABLE_UPPER_BOUNDS].seen
+            ? grow_array_release(&arrays[TARGET_VARIABLE_UPPER_BOUNDS])
+            : filled_array(num_variables, DEFAULT_VARIABLE_UPPER_BOUND);
+    }
+
+    if (arrays[TARGET_VARIABLE_TYPES].seen) {
+        result.variable_types = grow_array_release(&arrays[TARGET_VARIABLE_TYPES]);
+    } else {
+        // Default to continuous variables
+        result.variable_types = malloc(num_variables ? num_variables : 1);
+        if (result.variable_types) {
+            memset(result.variable_types, CUOPT_CONTINUOUS, num_variables);
+        }
+    }
+
+    result.row_offsets = grow_array_release(&arrays[TARGET_ROW_OFFSETS]);
+    result.column_indices = grow_array_release(&arrays[TARGET_COLUMN_INDICES]);
+    result.matrix_values = grow_array_release(&arrays[TARGET_MATRIX_VALUES]);
+    result.objective_coefficients = grow_array_release(&arrays[TARGET_OBJECTIVE_COEFFICIENTS]);
+
+    if (!result.row_offsets || !result.column_indices || !result.matrix_values ||
+        !result.objective_coefficients || !result.variable_types ||
+        (b->seen_constraint_bounds && (!result.constraint_lower_bounds || !result.constraint_upper_bounds)) ||
+        (b->seen_variable_bounds && (!result.variable_lower_bounds || !result.variable_upper_bounds))) {
+        job_printf(b->ctx, "Error: Memory allocation failed\n");
+        free_problem_data(&result);
+        return -1;
+    }
+
+    if (b->variable_names) {
+        name_table_finish(b->variable_names);
+    }
+    if (b->row_names) {
+        name_table_finish(b->row_names);
+    }
+    result.variable_names = b->variable_names;
+    result.row_names = b->row_names;
+    b->variable_names = NULL;
+    b->row_names = NULL;
+
+    // Print the objective offset value
+    job_printf(b->ctx, "Objective offset: %g\n", result.objective_offset);
+
+    *data = result;
+    return 0;
+}
+
+int parse_cuopt_json_stream(JobContext* ctx, const char* json, size_t length, ProblemData* data) {
+    ProblemBuilder* builder = problem_builder_create(ctx);
+    if (!builder) {
+        return -1;
+    }
+
+    log_timestamp(ctx, "JSON_STREAM_PARSE_START");
+    Timer stream_timer;
+    start_timer(ctx, &stream_timer);
+
+    size_t error_offset = 0;
+    JsonSaxStatus status = json_sax_parse(json, length, problem_builder_handler(), builder, &error_offset);
+
+    double stream_time = end_timer(ctx, &stream_timer);
+    log_timestamp(ctx, "JSON_STREAM_PARSE_END");
+    log_phase_duration(ctx, "JSON_STREAM_PARSE", stream_time);
+    log_phase_throughput(ctx, "JSON_STREAM_PARSE", length, stream_time);
+
+    if (status != JSON_SAX_OK) {
+        json_sax_print_error(job_output(ctx), json, length, status, error_offset);
+        problem_builder_destroy(builder);
+        return -1;
+    }
+
+    log_timestamp(ctx, "PROBLEM_DATA_FINALIZE_START");
+    Timer finalize_timer;
+    start_timer(ctx, &finalize_timer);
+
+    int result = problem_builder_finish(builder, data);
+    problem_builder_destroy(builder);
+
+    double finalize_time = end_timer(ctx, &finalize_timer);
+    log_timestamp(ctx, "PROBLEM_DATA_FINALIZE_END");
+    log_phase_duration(ctx, "PROBLEM_DATA_FINALIZE", finalize_time);
+
+    return result;
+}
+
+int parse_cuopt_json_indexed(JobContext* ctx, const char* json, size_t length, ProblemData* data) {
+    // Stage 1: structural index
+    log_timestamp(ctx, "JSON_STRUCTURAL_INDEX_START");
+    Timer index_timer;
+    start_timer(ctx, &index_timer);
+
+    JsonIndex index;
+    size_t error_offset = 0;
+    JsonSaxStatus status = json_index_build(json, length, &index, &error_offset);
+
+    double index_time = end_timer(ctx, &index_timer);
+    log_timestamp(ctx, "JSON_STRUCTURAL_INDEX_END");
+    log_phase_duration(ctx, "JSON_STRUCTURAL_INDEX", index_time);
+    log_phase_throughput(ctx, "JSON_STRUCTURAL_INDEX", length, index_time);
+
+    if (status != JSON_SAX_OK) {
+        json_sax_print_error(job_output(ctx), json, length, status, error_offset);
+        json_index_free(&index);
+        return -1;
+    }
+
+    // Stage 2: walk the index and fill the arrays
+    ProblemBuilder* builder = problem_builder_create(ctx);
+    if (!builder) {
+        json_index_free(&index);
+        return -1;
+    }
+
+    log_timestamp(ctx, "JSON_INDEX_WALK_START");
+    Timer walk_timer;
+    start_timer(ctx, &walk_timer);
+
+    status = json_index_walk(&index, problem_builder_handler(), builder, &error_offset);
+    json_index_free(&index);
+
+    double walk_time = end_timer(ctx, &walk_timer);
+    log_timestamp(ctx, "JSON_INDEX_WALK_END");
+    log_phase_duration(ctx, "JSON_INDEX_WALK", walk_time);
+    log_phase_throughput(ctx, "JSON_INDEX_WALK", length, walk_time);
+
+    if (status != JSON_SAX_OK) {
+        json_sax_print_error(job_output(ctx), json, length, status, error_offset);
+        problem_builder_destroy(builder);
+        return -1;
+    }
+
+    log_timestamp(ctx, "PROBLEM_DATA_FINALIZE_START");
+    Timer finalize_timer;
+    start_timer(ctx, &finalize_timer);
+
+    int result = problem_builder_finish(builder, data);
+    problem_builder_destroy(builder);
+
+    double finalize_time = end_timer(ctx, &finalize_timer);
+    log_timestamp(ctx, "PROBLEM_DATA_FINALIZE_END");
+    log_phase_duration(ctx, "PROBLEM_DATA_FINALIZE", finalize_time);
+
+    return result;
+}
@@ -0,0 +1,43 @@
+/*
+ * problem_builder.h - Fill ProblemData directly from JSON token events
+ *
+ * The builder is a JsonSaxHandler that recognizes the cuOpt JSON layout
+ * (csr_constraint_matrix, objective_data, constraint_bounds, ...) and writes
+ * each number straight into growable arrays as it arrives, so no DOM is
+ * ever built. Keys may appear in any order; cross-field checks happen in
+ * problem_builder_finish once the whole document has been seen.
+ *
+ * Large numeric arrays (offsets, indices, values, coefficients, bounds) are
+ * taken over through the raw_array hook and converted in parallel on the
+ * builder's thread pool.
+ */
+
+#ifndef PROBLEM_BUILDER_H
+#define PROBLEM_BUILDER_H
+
+#include <stddef.h>
+#include "cuopt_json_to_c_api.h"
+#include "json_sax.h"
+#include "thread_pool.h"
+
+typedef struct ProblemBuilder ProblemBuilder;
+
+// Arrays are converted on the context's thread pool; with no pool (or a
+// NULL context) everything runs on the calling thread
+ProblemBuilder* problem_builder_create(JobContext* ctx);
+void problem_builder_destroy(ProblemBuilder* builder);
+
+// Event callbacks to pass to json_sax_parse together with the builder
+const JsonSaxHandler* problem_builder_handler(void);
+
+// Validate the collected arrays and move them into `data`. Returns 0 on
+// success; on failure an error has been printed and `data` is untouched.
+int problem_builder_finish(ProblemBuilder* builder, ProblemData* data);
+
+// Parse a cuOpt JSON document held in memory with the streaming tokenizer
+int parse_cuopt_json_stream(JobContext* ctx, const char* json, size_t length, ProblemData* data);
+
+// Parse a cuOpt JSON document with the two-stage structural-index front end
+int parse_cuopt_json_indexed(JobContext* ctx, const char* json, size_t length, ProblemData* data);
+
+#endif // PROBLEM_BUILDER_H
@@ -0,0 +1,296 @@
+/*
+ * problem_decompose.c - Splitting a problem into independent blocks
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "problem_decompose.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const ProblemData* data;
+    cuopt_int_t* parent;     // union-find forest over the variables
+    size_t count;            // rows or variables, depending on the pass
+    size_t chunk_size;
+} UnionJob;
+
+// Root of x's tree. Parents only ever move to smaller indices, so
+// shortcutting x to its grandparent (path halving) is safe to race with
+// other finds and unions.
+static cuopt_int_t uf_find(cuopt_int_t* parent, cuopt_int_t x) {
+    for (;;) {
+        cuopt_int_t p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE);
+        if (p == x) {
+            return x;
+        }
+        cuopt_int_t grandparent = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+        if (grandparent != p) {
+            __atomic_compare_exchange_n(&parent[x], &p, grandparent, 0, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED);
+        }
+        x = grandparent;
+    }
+}
+
+// Join the trees of a and b by linking the larger root under the smaller;
+// retried if another thread changed the root in between
+static void uf_union(cuopt_int_t* parent, cuopt_int_t a, cuopt_int_t b) {
+    for (;;) {
+        a = uf_find(parent, a);
+        b = uf_find(parent, b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            cuopt_int_t t = a;
+            a = b;
+            b = t;
+        }
+        cuopt_int_t expected = a;
+        if (__atomic_compare_exchange_n(&parent[a], &expected, b, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
+}
+
+// Join the variables of every row in one chunk of rows
+static void union_rows(void* arg, size_t chunk) {
+    UnionJob* job = arg;
+    const ProblemData* data = job->data;
+    size_t begin, end;
+    thread_pool_chunk_range(chunk, job->chunk_size, job->count, &begin, &end);
+    for (size_t row = begin; row < end; row++) {
+        cuopt_int_t first = data->row_offsets[row];
+        cuopt_int_t last = data->row_offsets[row + 1];
+        for (cuopt_int_t k = first + 1; k < last; k++) {
+            uf_union(job->parent, data->column_indices[first], data->column_indices[k]);
+        }
+    }
+}
+
+// Point every variable of one chunk straight at its root
+static void flatten_variables(void* arg, size_t chunk) {
+    UnionJob* job = arg;
+    size_t begin, end;
+    thread_pool_chunk_range(chunk, job->chunk_size, job->count, &begin, &end);
+    for (size_t j = begin; j < end; j++) {
+        __atomic_store_n(&job->parent[j], uf_find(job->parent, (cuopt_int_t)j), __ATOMIC_RELAXED);
+    }
+}
+
+// Counting sort of items [0, count) by block into order[], with offsets[]
+// of size num_blocks + 1; local[] receives each item's position in its block
+static void group_by_block(const cuopt_int_t* block_of, size_t count, cuopt_int_t num_blocks,
+                           cuopt_int_t* offsets, cuopt_int_t* order, cuopt_int_t* local) {
+    memset(offsets, 0, ((size_t)num_blocks + 1) * sizeof(cuopt_int_t));
+    for (size_t i = 0; i < count; i++) {
+        offsets[block_of[i] + 1]++;
+    }
+    for (cuopt_int_t b = 0; b < num_blocks; b++) {
+        offsets[b + 1] += offsets[b];
+    }
+    for (size_t i = 0; i < count; i++) {
+        cuopt_int_t b = block_of[i];
+        cuopt_int_t position = offsets[b]++;
+        order[position] = (cuopt_int_t)i;
+        if (local) {
+            local[i] = position;
+        }
+    }
+    // Undo the shift left by the scatter and make positions block-relative
+    for (cuopt_int_t b = num_blocks; b > 0; b--) {
+        offsets[b] = offsets[b - 1];
+    }
+    offsets[0] = 0;
+    if (local) {
+        for (size_t i = 0; i < count; i++) {
+            local[i] -= offsets[block_of[i]];
+        }
+    }
+}
+
+int problem_blocks_find(JobContext* ctx, const ProblemData* data, ProblemBlocks* blocks) {
+    memset(blocks, 0, sizeof(ProblemBlocks));
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    ThreadPool* pool = job_thread_pool(ctx);
+    
+    cuopt_int_t* parent = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    cuopt_int_t* block_id = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    cuopt_int_t* row_block = malloc((m ? m : 1) * sizeof(cuopt_int_t));
+    unsigned char* has_rows = calloc(n ? n : 1, 1);
+    blocks->rows = malloc((m ? m : 1) * sizeof(cuopt_int_t));
+    blocks->variables = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    blocks->local_index = malloc((n ? n : 1) * sizeof(cuopt_int_t));
+    if (!parent || !block_id || !row_block || !has_rows || !blocks->rows || !blocks->variables ||
+        !blocks->local_index) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        free(parent);
+        free(block_id);
+        free(row_block);
+        free(has_rows);
+        problem_blocks_free(blocks);
+        return -1;
+    }
+    for (size_t j = 0; j < n; j++) {
+        parent[j] = (cuopt_int_t)j;
+    }
+    
+    UnionJob job = { data, parent, m, thread_pool_chunk_size(pool, m) };
+    thread_pool_parallel_for(pool, thread_pool_chunk_count(m, job.chunk_size), union_rows, &job);
+    job.count = n;
+    job.chunk_size = thread_pool_chunk_size(pool, n);
+    thread_pool_parallel_for(pool, thread_pool_chunk_count(n, job.chunk_size), flatten_variables, &job);
+    
+    // Number the components that own rows by their smallest variable;
+    // everything that couples nothing shares one trailing block
+    for (size_t row = 0; row < m; row++) {
+        if (data->row_offsets[row] < data->row_offsets[row + 1]) {
+            has_rows[parent[data->column_indices[data->row_offsets[row]]]] = 1;
+        }
+    }
+    cuopt_int_t num_blocks = 0;
+    for (size_t j = 0; j < n; j++) {
+        if (parent[j] == (cuopt_int_t)j && has_rows[j]) {
+            block_id[j] = num_blocks++;
+        }
+    }
+    cuopt_int_t loose_block = num_blocks;
+    int has_loose = 0;
+    for (size_t j = 0; j < n; j++) {
+        if (has_rows[parent[j]]) {
+            block_id[j] = block_id[parent[j]];
+        } else {
+            block_id[j] = loose_block;
+            has_loose = 1;
+        }
+    }
+    for (size_t row = 0; row < m; row++) {
+        if (data->row_offsets[row] < data->row_offsets[row + 1]) {
+            row_block[row] = block_id[data->column_indices[data->row_offsets[row]]];
+        } else {
+            row_block[row] = loose_block;
+            has_loose = 1;
+        }
+    }
+    num_blocks += has_loose;
+    if (num_blocks == 0) {
+        num_blocks = 1;
+    }
+    
+    blocks->num_blocks = num_blocks;
+    blocks->row_offsets = malloc(((size_t)num_blocks + 1) * sizeof(cuopt_int_t));
+    blocks->variable_offsets = malloc(((size_t)num_blocks + 1) * sizeof(cuopt_int_t));
+    int status = 0;
+    if (!blocks->row_offsets || !blocks->variable_offsets) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        problem_blocks_free(blocks);
+        status = -1;
+    } else {
+        group_by_block(row_block, m, num_blocks, blocks->row_offsets, blocks->rows, NULL);
+        group_by_block(block_id, n, num_blocks, blocks->variable_offsets, blocks->variables,
+                       blocks->local_index);
+    }
+    
+    free(parent);
+    free(block_id);
+    free(row_block);
+    free(has_rows);
+    return status;
+}
+
+int problem_blocks_extract(JobContext* ctx, const ProblemData* data,
+                           const ProblemBlocks* blocks, cuopt_int_t block, ProblemData* out) {
+    memset(out, 0, sizeof(ProblemData));
+    const cuopt_int_t* rows = blocks->rows + blocks->row_offsets[block];
+    const cuopt_int_t* variables = blocks->variables + blocks->variable_offsets[block];
+    size_t m = (size_t)(blocks->row_offsets[block + 1] - blocks->row_offsets[block]);
+    size_t n = (size_t)(blocks->variable_offsets[block + 1] - blocks->variable_offsets[block]);
+    size_t nnz = 0;
+    for (size_t i = 0; i < m; i++) {
+        nnz += (size_t)(data->row_offsets[rows[i] + 1] - data->row_offsets[rows[i]]);
+    }
+    
+    out->num_constraints = (cuopt_int_t)m;
+    out->num_variables = (cuopt_int_t)n;
+    out->nnz = (cuopt_int_t)nnz;
+    out->objective_sense = data->objective_sense;
+    out->objective_scaling_factor = data->objective_scaling_factor;
+    out->row_offsets = malloc((m + 1) * sizeof(cuopt_int_t));
+    out->column_indices = malloc((nnz ? nnz : 1) * sizeof(cuopt_int_t));
+    out->matrix_values = malloc((nnz ? nnz : 1) * sizeof(cuopt_float_t));
+    out->objective_coefficients = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    out->variable_types = malloc(n ? n : 1);
+    int ok = out->row_offsets && out->column_indices && out->matrix_values &&
+             out->objective_coefficients && out->variable_types;
+    if (ok && data->constraint_lower_bounds && data->constraint_upper_bounds) {
+        out->constraint_lower_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+        out->constraint_upper_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+        ok = out->constraint_lower_bounds && out->constraint_upper_bounds;
+    }
+    if (ok && data->variable_lower_bounds && data->variable_upper_bounds) {
+        out->variable_lower_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+        out->variable_upper_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+        ok = out->variable_lower_bounds && out->variable_upper_bounds;
+    }
+    if (!ok) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        free_problem_data(out);
+        return -1;
+    }
+    
+    size_t k = 0;
+    out->row_offsets[0] = 0;
+    for (size_t i = 0; i < m; i++) {
+        cuopt_int_t row = rows[i];
+        for (cuopt_int_t e = data->row_offsets[row]; e < data->row_offsets[row + 1]; e++, k++) {
+            out->column_indices[k] = blocks->local_index[data->column_indices[e]];
+            out->matrix_values[k] = data->matrix_values[e];
+        }
+        out->row_offsets[i + 1] = (cuopt_int_t)k;
+        if (out->constraint_lower_bounds) {
+            out->constraint_lower_bounds[i] = data->constraint_lower_bounds[row];
+            out->constraint_upper_bounds[i] = data->constraint_upper_bounds[row];
+        }
+    }
+    for (size_t j = 0; j < n; j++) {
+        cuopt_int_t variable = variables[j];
+        out->objective_coefficients[j] = data->objective_coefficients[variable];
+        out->variable_types[j] = data->variable_types ? data->variable_types[variable]
+                                                      : CUOPT_CONTINUOUS;
+        if (out->variable_lower_bounds) {
+            out->variable_lower_bounds[j] = data->variable_lower_bounds[variable];
+            out->variable_upper_bounds[j] = data->variable_upper_bounds[variable];
+        }
+    }
+    return 0;
+}
+
+void problem_blocks_scatter(const ProblemBlocks* blocks, cuopt_int_t block,
+                            const cuopt_float_t* block_values, cuopt_float_t* values) {
+    const cuopt_int_t* variables = blocks->variables + blocks->variable_offsets[block];
+    cuopt_int_t n = blocks->variable_offsets[block + 1] - blocks->variable_offsets[block];
+    for (cuopt_int_t j = 0; j < n; j++) {
+        values[variables[j]] = block_values[j];
+    }
+}
+
+void problem_blocks_scatter_rows(const ProblemBlocks* blocks, cuopt_int_t block,
+                                 const cuopt_float_t* block_values, cuopt_float_t* values) {
+    const cuopt_int_t* rows = blocks->rows + blocks->row_offsets[block];
+    cuopt_int_t m = blocks->row_offsets[block + 1] - blocks->row_offsets[block];
+    for (cuopt_int_t i = 0; i < m; i++) {
+        values[rows[i]] = block_values[i];
+    }
+}
+
+void problem_blocks_free(ProblemBlocks* blocks) {
+    free(blocks->row_offsets);
+    free(blocks->rows);
+    free(blocks->variable_offsets);
+    free(blocks->variables);
+    free(blocks->local_index);
+    memset(blocks, 0, sizeof(ProblemBlocks));
+}
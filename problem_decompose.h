@@ -0,0 +1,57 @@
+/*
+ * problem_decompose.h - Splitting a problem into independent blocks
+ *
+ * A problem whose constraint matrix is block diagonal up to a permutation
+ * is really several problems: the connected components of the bipartite
+ * graph between constraints and variables (an edge per nonzero) never
+ * share a variable or a constraint. The components are found with a
+ * union-find over the variables, run in parallel over chunks of rows:
+ * every row joins the variables it touches. Unions are lock-free, always
+ * linking the larger root under the smaller one with a compare-and-swap,
+ * so each component ends up named after its smallest variable.
+ *
+ * Variables that appear in no row and rows without nonzeros do not couple
+ * anything; they are collected into one extra block instead of becoming
+ * thousands of one-variable problems.
+ */
+
+#ifndef PROBLEM_DECOMPOSE_H
+#define PROBLEM_DECOMPOSE_H
+
+#include "cuopt_json_to_c_api.h"
+
+typedef struct {
+    cuopt_int_t num_blocks;
+    // Constraints and variables of block b, in their original order, are
+    // rows[row_offsets[b] .. row_offsets[b + 1]) and likewise for variables
+    cuopt_int_t* row_offsets;
+    cuopt_int_t* rows;
+    cuopt_int_t* variable_offsets;
+    cuopt_int_t* variables;
+    cuopt_int_t* local_index;  // position of each variable within its block
+} ProblemBlocks;
+
+// Find the independent blocks of `data`, on the job's thread pool. The
+// column indices are used unchecked, so `data` must have passed
+// load_problem's CSR check. Returns 0 on success (num_blocks may be 1), -1
+// on failure.
+int problem_blocks_find(JobContext* ctx, const ProblemData* data, ProblemBlocks* blocks);
+
+// Build block `block` of `data` as a problem of its own, with variables and
+// constraints renumbered in their original order and no objective offset.
+// Returns 0 on success, -1 on failure (an error has been printed).
+int problem_blocks_extract(JobContext* ctx, const ProblemData* data,
+                           const ProblemBlocks* blocks, cuopt_int_t block, ProblemData* out);
+
+// Copy the values of block `block`'s variables into their places in the
+// full variable vector
+void problem_blocks_scatter(const ProblemBlocks* blocks, cuopt_int_t block,
+                            const cuopt_float_t* block_values, cuopt_float_t* values);
+
+// Same for the values of block `block`'s constraints, e.g. its duals
+void problem_blocks_scatter_rows(const ProblemBlocks* blocks, cuopt_int_t block,
+                                 const cuopt_float_t* block_values, cuopt_float_t* values);
+
+void problem_blocks_free(ProblemBlocks* blocks);
+
+#endif // PROBLEM_DECOMPOSE_H
@@ -0,0 +1,152 @@
+/*
+ * problem_pack.c - Block-diagonal packing of small independent LPs
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "problem_pack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int problem_data_is_mip(const ProblemData* data) {
+    if (!data->variable_types) {
+        return 0;
+    }
+    for (cuopt_int_t i = 0; i < data->num_variables; i++) {
+        if (data->variable_types[i] == CUOPT_INTEGER) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int problem_pack_eligible(const ProblemData* data) {
+    // The pack has one objective scale, so scaled problems stay on their own
+    if (problem_data_is_mip(data) ||
+        (data->objective_scaling_factor != 0.0 && data->objective_scaling_factor != 1.0)) {
+        return 0;
+    }
+    return data->num_constraints == 0 ||
+           (data->constraint_lower_bounds && data->constraint_upper_bounds);
+}
+
+int problem_pack_build(JobContext* ctx, const ProblemData* problems, size_t count,
+                       ProblemPack* pack) {
+    memset(pack, 0, sizeof(ProblemPack));
+    
+    // Sizes of the pack, checked against the range of cuopt_int_t
+    int64_t num_constraints = 0, num_variables = 0, nnz = 0;
+    for (size_t i = 0; i < count; i++) {
+        num_constraints += problems[i].num_constraints;
+        num_variables += problems[i].num_variables;
+        nnz += problems[i].nnz;
+    }
+    const int64_t limit = sizeof(cuopt_int_t) >= sizeof(int64_t) ? INT64_MAX : INT32_MAX;
+    if (num_constraints > limit || num_variables > limit || nnz > limit) {
+        job_printf(ctx, "Error: Packed problem is too large\n");
+        return -1;
+    }
+    
+    ProblemData* packed = &pack->data;
+    packed->num_constraints = (cuopt_int_t)num_constraints;
+    packed->num_variables = (cuopt_int_t)num_variables;
+    packed->nnz = (cuopt_int_t)nnz;
+    packed->objective_sense = CUOPT_MINIMIZE;
+    
+    size_t m = (size_t)num_constraints, n = (size_t)num_variables, z = (size_t)nnz;
+    pack->count = count;
+    pack->variable_offsets = malloc((count + 1) * sizeof(cuopt_int_t));
+    pack->constraint_offsets = malloc((count + 1) * sizeof(cuopt_int_t));
+    packed->row_offsets = malloc((m + 1) * sizeof(cuopt_int_t));
+    packed->column_indices = malloc((z ? z : 1) * sizeof(cuopt_int_t));
+    packed->matrix_values = malloc((z ? z : 1) * sizeof(cuopt_float_t));
+    packed->constraint_lower_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    packed->constraint_upper_bounds = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    packed->objective_coefficients = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    packed->variable_lower_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    packed->variable_upper_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    packed->variable_types = malloc(n ? n : 1);
+    if (!pack->variable_offsets || !pack->constraint_offsets || !packed->row_offsets ||
+        !packed->column_indices || !packed->matrix_values || !packed->constraint_lower_bounds ||
+        !packed->constraint_upper_bounds || !packed->objective_coefficients ||
+        !packed->variable_lower_bounds || !packed->variable_upper_bounds ||
+        !packed->variable_types) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        problem_pack_free(pack);
+        return -1;
+    }
+    
+    // Lay the blocks out along the diagonal
+    cuopt_int_t row_base = 0, column_base = 0, nnz_base = 0;
+    packed->row_offsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        const ProblemData* block = &problems[i];
+        pack->constraint_offsets[i] = row_base;
+        pack->variable_offsets[i] = column_base;
+        
+        for (cuopt_int_t r = 0; r < block->num_constraints; r++) {
+            packed->row_offsets[row_base + r + 1] = nnz_base + block->row_offsets[r + 1];
+        }
+        for (cuopt_int_t k = 0; k < block->nnz; k++) {
+            packed->column_indices[nnz_base + k] = column_base + block->column_indices[k];
+        }
+        memcpy(packed->matrix_values + nnz_base, block->matrix_values,
+               (size_t)block->nnz * sizeof(cuopt_float_t));
+        memcpy(packed->constraint_lower_bounds + row_base, block->constraint_lower_bounds,
+               (size_t)block->num_constraints * sizeof(cuopt_float_t));
+        memcpy(packed->constraint_upper_bounds + row_base, block->constraint_upper_bounds,
+               (size_t)block->num_constraints * sizeof(cuopt_float_t));
+        
+        // The pack minimizes, so maximization blocks enter negated
+        double sign = block->objective_sense == CUOPT_MINIMIZE ? 1.0 : -1.0;
+        for (cuopt_int_t j = 0; j < block->num_variables; j++) {
+            size_t column = (size_t)(column_base + j);
+            packed->objective_coefficients[column] = sign * block->objective_coefficients[j];
+            packed->variable_lower_bounds[column] = problem_variable_lower_bound(block, j);
+            packed->variable_upper_bounds[column] = problem_variable_upper_bound(block, j);
+        }
+        packed->objective_offset += sign * block->objective_offset;
+        
+        row_base += block->num_constraints;
+        column_base += block->num_variables;
+        nnz_base += block->nnz;
+    }
+    pack->constraint_offsets[count] = row_base;
+    pack->variable_offsets[count] = column_base;
+    memset(packed->variable_types, CUOPT_CONTINUOUS, n);
+    return 0;
+}
+
+double problem_pack_block_objective(const ProblemPack* pack, size_t block,
+                                    const ProblemData* data, const cuopt_float_t* primal) {
+    const cuopt_float_t* x = primal + pack->variable_offsets[block];
+    double objective = data->objective_offset;
+    for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+        objective += (double)data->objective_coefficients[j] * x[j];
+    }
+    return objective;
+}
+
+void problem_pack_block_duals(const ProblemPack* pack, size_t block, const ProblemData* data,
+                              const cuopt_float_t* dual, const cuopt_float_t* reduced_costs,
+                              cuopt_float_t* block_dual, cuopt_float_t* block_reduced_costs) {
+    // Maximization blocks were solved negated, which negates their duals;
+    // adding 0.0 keeps a negated zero from showing up as -0
+    cuopt_float_t sign = data->objective_sense == CUOPT_MINIMIZE ? 1.0 : -1.0;
+    const cuopt_float_t* y = dual + pack->constraint_offsets[block];
+    const cuopt_float_t* d = reduced_costs + pack->variable_offsets[block];
+    for (cuopt_int_t i = 0; i < data->num_constraints; i++) {
+        block_dual[i] = sign * y[i] + 0.0;
+    }
+    for (cuopt_int_t j = 0; j < data->num_variables; j++) {
+        block_reduced_costs[j] = sign * d[j] + 0.0;
+    }
+}
+
+void problem_pack_free(ProblemPack* pack) {
+    free(pack->variable_offsets);
+    free(pack->constraint_offsets);
+    free_problem_data(&pack->data);
+    memset(pack, 0, sizeof(ProblemPack));
+}
@@ -0,0 +1,57 @@
+/*
+ * problem_pack.h - Block-diagonal packing of small independent LPs
+ *
+ * Solving thousands of tiny LPs one by one pays the problem creation and
+ * solver start-up cost every time. A pack concatenates K problems into one
+ * block-diagonal problem: the constraint matrices are placed along the
+ * diagonal, the variable and constraint vectors are concatenated and the
+ * objectives are summed. Since no constraint couples two blocks, an
+ * optimal solution of the pack restricted to block i is an optimal
+ * solution of problem i.
+ *
+ * The pack is always minimized; blocks of maximization problems enter with
+ * their objective negated. MIPs are never packed, because a single MIP gap
+ * over the sum of objectives is not the gap of each problem.
+ */
+
+#ifndef PROBLEM_PACK_H
+#define PROBLEM_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cuopt_json_to_c_api.h"
+
+typedef struct {
+    size_t count;                     // number of blocks
+    cuopt_int_t* variable_offsets;    // count + 1 entries: first variable of each block
+    cuopt_int_t* constraint_offsets;  // count + 1 entries: first constraint of each block
+    ProblemData data;                 // the block-diagonal problem
+} ProblemPack;
+
+// 1 if `data` has integer variables
+int problem_data_is_mip(const ProblemData* data);
+
+// 1 if `data` can be a block of a pack: an LP whose constraint bounds are
+// present and whose objective is not scaled
+int problem_pack_eligible(const ProblemData* data);
+
+// Build the block-diagonal problem of `count` eligible problems. Returns 0
+// on success, -1 on failure (an error has been printed).
+int problem_pack_build(JobContext* ctx, const ProblemData* problems, size_t count,
+                       ProblemPack* pack);
+
+// Objective of block `block` (which was built from `data`) in its own sense
+// and with its own offset, given the primal solution of the whole pack.
+// The block's own primal values start at primal + variable_offsets[block].
+double problem_pack_block_objective(const ProblemPack* pack, size_t block,
+                                    const ProblemData* data, const cuopt_float_t* primal);
+
+// Copy the duals and reduced costs of block `block` out of those of the
+// whole pack, in the block's own sense
+void problem_pack_block_duals(const ProblemPack* pack, size_t block, const ProblemData* data,
+                              const cuopt_float_t* dual, const cuopt_float_t* reduced_costs,
+                              cuopt_float_t* block_dual, cuopt_float_t* block_reduced_costs);
+
+void problem_pack_free(ProblemPack* pack);
+
+#endif // PROBLEM_PACK_H
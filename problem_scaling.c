@@ -0,0 +1,336 @@
+/*
+ * problem_scaling.c - Objective scaling and matrix equilibration
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "problem_scaling.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SCALING_HAVE_SSE2 1
+#include <immintrin.h>
+#endif
+
+// Row and column passes after which equilibration stops
+#define SCALING_MAX_PASSES 20
+
+typedef struct {
+    const ProblemData* data;
+    ScalingMethod method;
+    cuopt_float_t* values;                 // matrix being scaled in place
+    const cuopt_int_t* column_offsets;     // positions in `values` of each column's entries
+    const cuopt_int_t* column_positions;
+    cuopt_float_t* scale;                  // row or column scales, accumulated
+    size_t count;
+    size_t chunk_size;
+    int changed;                           // set if any factor of the step was not 1
+} ScalingJob;
+
+// Smallest and largest nonzero magnitude of values[0, count); 0 and 0 if
+// all are zero
+static void magnitude_range(const cuopt_float_t* values, size_t count, cuopt_float_t* min_out,
+                            cuopt_float_t* max_out) {
+    double low = INFINITY, high = 0.0;
+    size_t i = 0;
+#ifdef SCALING_HAVE_SSE2
+    if (sizeof(cuopt_float_t) == sizeof(double)) {
+        const double* v = (const double*)values;
+        const __m128d sign = _mm_set1_pd(-0.0);
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d infinity = _mm_set1_pd(INFINITY);
+        __m128d vlow = infinity, vhigh = zero;
+        for (; i + 2 <= count; i += 2) {
+            __m128d a = _mm_andnot_pd(sign, _mm_loadu_pd(v + i));
+            // Zeros must not become the minimum: replace them by infinity
+            __m128d is_zero = _mm_cmpeq_pd(a, zero);
+            __m128d nonzero = _mm_or_pd(_mm_and_pd(is_zero, infinity), _mm_andnot_pd(is_zero, a));
+            vlow = _mm_min_pd(vlow, nonzero);
+            vhigh = _mm_max_pd(vhigh, a);
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, vlow);
+        low = fmin(lanes[0], lanes[1]);
+        _mm_storeu_pd(lanes, vhigh);
+        high = fmax(lanes[0], lanes[1]);
+    }
+#endif
+    for (; i < count; i++) {
+        double a = fabs(values[i]);
+        if (a != 0.0 && a < low) {
+            low = a;
+        }
+        if (a > high) {
+            high = a;
+        }
+    }
+    *min_out = high > 0.0 ? low : 0.0;
+    *max_out = high;
+}
+
+// values[0, count) *= factor
+static void scale_values(cuopt_float_t* values, size_t count, cuopt_float_t factor) {
+    size_t i = 0;
+#ifdef SCALING_HAVE_SSE2
+    if (sizeof(cuopt_float_t) == sizeof(double)) {
+        double* v = (double*)values;
+        const __m128d f = _mm_set1_pd(factor);
+        for (; i + 2 <= count; i += 2) {
+            _mm_storeu_pd(v + i, _mm_mul_pd(_mm_loadu_pd(v + i), f));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        values[i] *= factor;
+    }
+}
+
+// Factor that brings a row or column with the given magnitudes towards 1,
+// rounded to a power of two
+static cuopt_float_t scale_factor(ScalingMethod method, cuopt_float_t low, cuopt_float_t high) {
+    if (high == 0.0) {
+        return 1.0;
+    }
+    double norm = method == SCALING_RUIZ ? sqrt(high) : sqrt(low) * sqrt(high);
+    return exp2(round(-log2(norm)));
+}
+
+static void scale_rows(void* arg, size_t chunk) {
+    ScalingJob* job = arg;
+    const ProblemData* data = job->data;
+    size_t begin, end;
+    thread_pool_chunk_range(chunk, job->chunk_size, job->count, &begin, &end);
+    int changed = 0;
+    for (size_t row = begin; row < end; row++) {
+        cuopt_float_t* values = job->values + data->row_offsets[row];
+        size_t length = (size_t)(data->row_offsets[row + 1] - data->row_offsets[row]);
+        cuopt_float_t low, high;
+        magnitude_range(values, length, &low, &high);
+        cuopt_float_t factor = scale_factor(job->method, low, high);
+        if (factor != 1.0) {
+            scale_values(values, length, factor);
+            job->scale[row] *= factor;
+            changed = 1;
+        }
+    }
+    if (changed) {
+        __atomic_store_n(&job->changed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void scale_columns(void* arg, size_t chunk) {
+    ScalingJob* job = arg;
+    const ProblemData* data = job->data;
+    size_t begin, end;
+    thread_pool_chunk_range(chunk, job->chunk_size, job->count, &begin, &end);
+    int changed = 0;
+    for (size_t j = begin; j < end; j++) {
+        // Scaling an integer variable would break its integrality
+        if (data->variable_types && data->variable_types[j] == CUOPT_INTEGER) {
+            continue;
+        }
+        double low = INFINITY, high = 0.0;
+        for (cuopt_int_t k = job->column_offsets[j]; k < job->column_offsets[j + 1]; k++) {
+            double a = fabs(job->values[job->column_positions[k]]);
+            if (a != 0.0 && a < low) {
+                low = a;
+            }
+            if (a > high) {
+                high = a;
+            }
+        }
+        cuopt_float_t factor = scale_factor(job->method, low, high);
+        if (factor != 1.0) {
+            for (cuopt_int_t k = job->column_offsets[j]; k < job->column_offsets[j + 1]; k++) {
+                job->values[job->column_positions[k]] *= factor;
+            }
+            job->scale[j] *= factor;
+            changed = 1;
+        }
+    }
+    if (changed) {
+        __atomic_store_n(&job->changed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Positions of every column's entries in the CSR arrays
+static int column_positions(const ProblemData* data, cuopt_int_t** offsets_out,
+                            cuopt_int_t** positions_out) {
+    size_t n = (size_t)data->num_variables, nnz = (size_t)data->nnz;
+    cuopt_int_t* offsets = calloc(n + 1, sizeof(cuopt_int_t));
+    cuopt_int_t* positions = malloc((nnz ? nnz : 1) * sizeof(cuopt_int_t));
+    if (!offsets || !positions) {
+        free(offsets);
+        free(positions);
+        return -1;
+    }
+    for (size_t k = 0; k < nnz; k++) {
+        offsets[data->column_indices[k] + 1]++;
+    }
+    for (size_t j = 0; j < n; j++) {
+        offsets[j + 1] += offsets[j];
+    }
+    for (size_t k = 0; k < nnz; k++) {
+        positions[offsets[data->column_indices[k]]++] = (cuopt_int_t)k;
+    }
+    // Undo the shift left by the scatter
+    for (size_t j = n; j > 0; j--) {
+        offsets[j] = offsets[j - 1];
+    }
+    offsets[0] = 0;
+    *offsets_out = offsets;
+    *positions_out = positions;
+    return 0;
+}
+
+// Alternate row and column passes until no factor changes
+static int equilibrate(JobContext* ctx, const ProblemData* data, ScalingMethod method,
+                       ProblemScaling* scaling) {
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    ThreadPool* pool = job_thread_pool(ctx);
+    cuopt_int_t* offsets = NULL;
+    cuopt_int_t* positions = NULL;
+    scaling->row_scale = malloc((m ? m : 1) * sizeof(cuopt_float_t));
+    scaling->column_scale = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    if (!scaling->row_scale || !scaling->column_scale ||
+        column_positions(data, &offsets, &positions) != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < m; i++) {
+        scaling->row_scale[i] = 1.0;
+    }
+    for (size_t j = 0; j < n; j++) {
+        scaling->column_scale[j] = 1.0;
+    }
+    
+    ScalingJob rows = { data, method, scaling->matrix_values, offsets, positions,
+                        scaling->row_scale, m, thread_pool_chunk_size(pool, m), 0 };
+    ScalingJob columns = rows;
+    columns.scale = scaling->column_scale;
+    columns.count = n;
+    columns.chunk_size = thread_pool_chunk_size(pool, n);
+    while (scaling->passes < SCALING_MAX_PASSES) {
+        scaling->passes++;
+        rows.changed = 0;
+        columns.changed = 0;
+        thread_pool_parallel_for(pool, thread_pool_chunk_count(m, rows.chunk_size), scale_rows,
+                                 &rows);
+        thread_pool_parallel_for(pool, thread_pool_chunk_count(n, columns.chunk_size),
+                                 scale_columns, &columns);
+        if (!rows.changed && !columns.changed) {
+            break;
+        }
+    }
+    free(offsets);
+    free(positions);
+    return 0;
+}
+
+static cuopt_float_t* copy_array(const cuopt_float_t* values, size_t count) {
+    cuopt_float_t* copy = malloc((count ? count : 1) * sizeof(cuopt_float_t));
+    if (copy && count) {
+        memcpy(copy, values, count * sizeof(cuopt_float_t));
+    }
+    return copy;
+}
+
+int problem_scaling_run(JobContext* ctx, const ProblemData* data, ScalingMethod method,
+                        ProblemScaling* scaling) {
+    memset(scaling, 0, sizeof(ProblemScaling));
+    size_t m = (size_t)data->num_constraints, n = (size_t)data->num_variables;
+    size_t nnz = (size_t)data->nnz;
+    scaling->objective_scale = data->objective_scaling_factor > 0.0
+                                   ? data->objective_scaling_factor : 1.0;
+    
+    scaling->matrix_values = copy_array(data->matrix_values, nnz);
+    scaling->objective_coefficients = copy_array(data->objective_coefficients, n);
+    scaling->variable_lower_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    scaling->variable_upper_bounds = malloc((n ? n : 1) * sizeof(cuopt_float_t));
+    int ok = scaling->matrix_values && scaling->objective_coefficients &&
+             scaling->variable_lower_bounds && scaling->variable_upper_bounds;
+    if (ok && data->constraint_lower_bounds && data->constraint_upper_bounds) {
+        scaling->constraint_lower_bounds = copy_array(data->constraint_lower_bounds, m);
+        scaling->constraint_upper_bounds = copy_array(data->constraint_upper_bounds, m);
+        ok = scaling->constraint_lower_bounds && scaling->constraint_upper_bounds;
+    }
+    
+    cuopt_float_t low, high;
+    magnitude_range(data->matrix_values, nnz, &low, &high);
+    scaling->range_before = high > 0.0 ? high / low : 1.0;
+    if (ok && method != SCALING_NONE && equilibrate(ctx, data, method, scaling) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+        problem_scaling_free(scaling);
+        return -1;
+    }
+    magnitude_range(scaling->matrix_values, nnz, &low, &high);
+    scaling->range_after = high > 0.0 ? high / low : 1.0;
+    
+    // Rows scale with R; the variables of the scaled problem are C^-1 x
+    for (size_t i = 0; scaling->row_scale && scaling->constraint_lower_bounds && i < m; i++) {
+        if (!bound_is_infinite(scaling->constraint_lower_bounds[i])) {
+            scaling->constraint_lower_bounds[i] *= scaling->row_scale[i];
+        }
+        if (!bound_is_infinite(scaling->constraint_upper_bounds[i])) {
+            scaling->constraint_upper_bounds[i] *= scaling->row_scale[i];
+        }
+    }
+    for (size_t j = 0; j < n; j++) {
+        cuopt_float_t column = scaling->column_scale ? scaling->column_scale[j] : 1.0;
+        cuopt_float_t lower = problem_variable_lower_bound(data, (cuopt_int_t)j);
+        cuopt_float_t upper = problem_variable_upper_bound(data, (cuopt_int_t)j);
+        scaling->variable_lower_bounds[j] = bound_is_infinite(lower) ? lower : lower / column;
+        scaling->variable_upper_bounds[j] = bound_is_infinite(upper) ? upper : upper / column;
+        scaling->objective_coefficients[j] *= scaling->objective_scale * column;
+    }
+    scaling->objective_offset = data->objective_offset * scaling->objective_scale;
+    return 0;
+}
+
+void problem_scaling_unscale_primal(const ProblemScaling* scaling, cuopt_float_t* values,
+                                    cuopt_int_t num_variables) {
+    if (!scaling->column_scale) {
+        return;
+    }
+    for (cuopt_int_t j = 0; j < num_variables; j++) {
+        values[j] *= scaling->column_scale[j];
+    }
+}
+
+void problem_scaling_unscale_dual(const ProblemScaling* scaling, cuopt_float_t* values,
+                                  cuopt_int_t num_constraints) {
+    for (cuopt_int_t i = 0; i < num_constraints; i++) {
+        cuopt_float_t row = scaling->row_scale ? scaling->row_scale[i] : 1.0;
+        values[i] *= row / scaling->objective_scale;
+    }
+}
+
+void problem_scaling_unscale_reduced_costs(const ProblemScaling* scaling, cuopt_float_t* values,
+                                           cuopt_int_t num_variables) {
+    for (cuopt_int_t j = 0; j < num_variables; j++) {
+        cuopt_float_t column = scaling->column_scale ? scaling->column_scale[j] : 1.0;
+        values[j] /= column * scaling->objective_scale;
+    }
+}
+
+cuopt_float_t problem_scaling_unscale_objective(const ProblemScaling* scaling,
+                                                cuopt_float_t value) {
+    return value / scaling->objective_scale;
+}
+
+void problem_scaling_free(ProblemScaling* scaling) {
+    free(scaling->row_scale);
+    free(scaling->column_scale);
+    free(scaling->matrix_values);
+    free(scaling->objective_coefficients);
+    free(scaling->constraint_lower_bounds);
+    free(scaling->constraint_upper_bounds);
+    free(scaling->variable_lower_bounds);
+    free(scaling->variable_upper_bounds);
+    memset(scaling, 0, sizeof(ProblemScaling));
+}
@@ -0,0 +1,75 @@
+/*
+ * problem_scaling.h - Objective scaling and matrix equilibration
+ *
+ * Badly scaled models (coefficients spanning many orders of magnitude)
+ * cost the solver iterations. Before the problem is created, the objective
+ * can be multiplied by the input's scalability_factor and the constraint
+ * matrix equilibrated, A' = R A C, with one of
+ *
+ *   - geometric mean scaling: every row, then every column, is divided by
+ *     sqrt(min |a| * max |a|) over its nonzeros;
+ *   - Ruiz scaling: every row, then every column, is divided by the square
+ *     root of its largest |a|, which drives all norms towards 1.
+ *
+ * Passes repeat until no factor changes or the pass limit is reached.
+ * Factors are rounded to powers of two, so scaling adds no rounding error,
+ * and integer columns are never scaled, so integrality is preserved. Row
+ * passes run over chunks of rows, column passes over chunks of columns, on
+ * the job's thread pool; the per-row min/max and the row rescaling use
+ * SSE2 where available.
+ *
+ * The variables of the scaled problem are x' = C^-1 x and its objective is
+ * the original one times the scalability factor s, so a solution maps back
+ * with x = C x' and objective / s. Duals and reduced costs of an LP map
+ * back with y = R y' / s and d = C^-1 d' / s.
+ */
+
+#ifndef PROBLEM_SCALING_H
+#define PROBLEM_SCALING_H
+
+#include "cuopt_json_to_c_api.h"
+
+typedef struct {
+    cuopt_float_t objective_scale;     // scalability_factor the objective was multiplied by
+    cuopt_float_t* row_scale;          // R and C, NULL without equilibration
+    cuopt_float_t* column_scale;
+    // Scaled copies of the arrays that change (constraint bounds stay NULL
+    // if the problem has none)
+    cuopt_float_t* matrix_values;
+    cuopt_float_t* objective_coefficients;
+    cuopt_float_t objective_offset;
+    cuopt_float_t* constraint_lower_bounds;
+    cuopt_float_t* constraint_upper_bounds;
+    cuopt_float_t* variable_lower_bounds;
+    cuopt_float_t* variable_upper_bounds;
+    int passes;
+    cuopt_float_t range_before;        // max |a| / min |a| over the nonzeros
+    cuopt_float_t range_after;
+} ProblemScaling;
+
+// Scale `data` with `method` and its objective_scaling_factor. Row and
+// column passes trust the row offsets and column indices, so `data` must
+// have passed load_problem's CSR check. Returns 0 on success, -1 on
+// failure (an error has been printed).
+int problem_scaling_run(JobContext* ctx, const ProblemData* data, ScalingMethod method,
+                        ProblemScaling* scaling);
+
+// Map a primal solution of the scaled problem back to the original
+// variables, in place
+void problem_scaling_unscale_primal(const ProblemScaling* scaling, cuopt_float_t* values,
+                                    cuopt_int_t num_variables);
+
+// Map the duals (one per constraint) or reduced costs (one per variable)
+// of the scaled problem back, in place
+void problem_scaling_unscale_dual(const ProblemScaling* scaling, cuopt_float_t* values,
+                                  cuopt_int_t num_constraints);
+void problem_scaling_unscale_reduced_costs(const ProblemScaling* scaling, cuopt_float_t* values,
+                                           cuopt_int_t num_variables);
+
+// Map an objective value (or bound) of the scaled problem back
+cuopt_float_t problem_scaling_unscale_objective(const ProblemScaling* scaling,
+                                                cuopt_float_t value);
+
+void problem_scaling_free(ProblemScaling* scaling);
+
+#endif // PROBLEM_SCALING_H
@@ -0,0 +1,387 @@
+/*
+ * shm_handoff.c - Shared-memory problem hand-off for co-located clients
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "shm_handoff.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "job_context.h"
+#include "problem_binary.h"
+
+#define SHM_CONTROL_MAGIC "CUOPTSHM"
+#define SHM_CONTROL_VERSION 2
+
+// Waiters wake at least this often to notice a peer that died
+#define LIVENESS_CHECK_MS 1000
+
+// The state word holds the phase in its low two bits and the pid of the
+// client that owns the request above them, so a claim and its owner are
+// published by a single compare-and-swap
+enum {
+    SHM_IDLE = 0,
+    SHM_CLAIMED = 1,
+    SHM_REQUEST = 2,
+    SHM_DONE = 3
+};
+
+#define STATE_PHASE(state) ((state) & 3u)
+#define STATE_OWNER(state) ((pid_t)((state) >> 2))
+#define MAKE_STATE(pid, phase) (((uint32_t)(pid) << 2) | (phase))
+
+typedef struct {
+    char magic[8];                 // SHM_CONTROL_MAGIC, written last by the server
+    uint32_t version;
+    uint32_t state;                // doorbell futex word
+    int32_t server_pid;
+    int32_t objective_sense;       // request: sense and offset of the problem
+    uint64_t sequence;             // requests answered so far
+    char segment[SHM_NAME_SIZE];   // request: problem segment name
+    uint64_t segment_size;
+    uint64_t primal_offset;        // request: end of the image, start of the primal
+    double objective_offset;
+    double objective_scaling_factor;
+    ShmResult result;              // reply
+} ShmControl;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signo) {
+    (void)signo;
+    stop_requested = 1;
+}
+
+// Sleep until *word no longer holds `value`, a signal arrives or the
+// timeout passes
+static void doorbell_wait(uint32_t* word, uint32_t value, int timeout_ms) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+#if defined(__linux__)
+    // Not FUTEX_PRIVATE_FLAG: the word is shared between processes
+    syscall(SYS_futex, word, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else
+    // Without futexes, poll
+    (void)timeout;
+    struct timespec pause = { 0, 50000 };
+    if (__atomic_load_n(word, __ATOMIC_ACQUIRE) == value) {
+        nanosleep(&pause, NULL);
+    }
+#endif
+}
+
+static void doorbell_ring(uint32_t* word) {
+#if defined(__linux__)
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+static uint32_t load_state(ShmControl* control) {
+    return __atomic_load_n(&control->state, __ATOMIC_ACQUIRE);
+}
+
+static void store_state(ShmControl* control, uint32_t state) {
+    __atomic_store_n(&control->state, state, __ATOMIC_RELEASE);
+    doorbell_ring(&control->state);
+}
+
+static int process_alive(pid_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// POSIX shm names are "/name"; accept them with or without the slash
+static int control_name(char* out, size_t size, const char* service) {
+    int n = snprintf(out, size, "%s%s", service[0] == '/' ? "" : "/", service);
+    if (n < 0 || (size_t)n >= size || strchr(out + 1, '/')) {
+        printf("Error: Invalid shared memory name '%s'\n", service);
+        return -1;
+    }
+    return 0;
+}
+
+static ShmControl* map_control(int fd) {
+    void* mapping = mmap(NULL, sizeof(ShmControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return mapping == MAP_FAILED ? NULL : mapping;
+}
+
+// Map the client's segment, solve it in place and fill control->result
+static void handle_request(ShmControl* control, ShmSolveFn solve, void* user) {
+    ShmResult result;
+    memset(&result, 0, sizeof(result));
+    result.status = -1;
+    
+    char name[SHM_NAME_SIZE];
+    memcpy(name, control->segment, sizeof(name));
+    name[sizeof(name) - 1] = '\0';
+    uint64_t primal_offset = control->primal_offset;
+    
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        printf("Error: Cannot open problem segment %s\n", name);
+        control->result = result;
+        return;
+    }
+    struct stat st;
+    void* mapping = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &st) == 0 && (uint64_t)st.st_size == control->segment_size) {
+        size = (size_t)st.st_size;
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Error: Cannot map problem segment %s\n", name);
+        control->result = result;
+        return;
+    }
+    
+    // The image ends where the primal solution starts; the arrays stay
+    // where the client wrote them
+    ProblemData data;
+    memset(&data, 0, sizeof(ProblemData));
+    if (primal_offset <= size && primal_offset % sizeof(cuopt_float_t) == 0 &&
+        problem_binary_attach(NULL, mapping, (size_t)primal_offset, &data, 0) == 0 &&
+        (size - primal_offset) / sizeof(cuopt_float_t) >= (uint64_t)data.num_variables) {
+        data.objective_sense = control->objective_sense;
+        data.objective_offset = control->objective_offset;
+        data.objective_scaling_factor = control->objective_scaling_factor;
+        solve(user, &data, (cuopt_float_t*)((char*)mapping + primal_offset), &result);
+    } else {
+        printf("Error: Problem segment %s is malformed\n", name);
+    }
+    munmap(mapping, size);
+    control->result = result;
+}
+
+int shm_serve(const char* service, ShmSolveFn solve, void* user) {
+    char name[SHM_NAME_SIZE];
+    if (control_name(name, sizeof(name), service) != 0) {
+        return -1;
+    }
+    
+    // Refuse to take over a control block whose server is still running
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd >= 0) {
+        ShmControl* existing = map_control(fd);
+        close(fd);
+        int running = existing && memcmp(existing->magic, SHM_CONTROL_MAGIC, 8) == 0 &&
+                      process_alive(existing->server_pid);
+        if (existing) {
+            munmap(existing, sizeof(ShmControl));
+        }
+        if (running) {
+            printf("Error: Another solver is already serving on %s\n", name);
+            return -1;
+        }
+        shm_unlink(name);
+    }
+    
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, sizeof(ShmControl)) != 0) {
+        printf("Error: Cannot create shared memory %s (%s)\n", name, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(name);
+        }
+        return -1;
+    }
+    ShmControl* control = map_control(fd);
+    close(fd);
+    if (!control) {
+        printf("Error: Cannot map shared memory %s\n", name);
+        shm_unlink(name);
+        return -1;
+    }
+    control->version = SHM_CONTROL_VERSION;
+    control->server_pid = (int32_t)getpid();
+    __atomic_store_n(&control->state, SHM_IDLE, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(control->magic, SHM_CONTROL_MAGIC, sizeof(control->magic));
+    
+    // No SA_RESTART, so a signal interrupts the futex wait
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    
+    printf("Serving on shared memory %s\n", name);
+    fflush(stdout);
+    
+    while (!stop_requested) {
+        uint32_t state = load_state(control);
+        if (STATE_PHASE(state) != SHM_REQUEST) {
+            // A client that died between claiming and releasing the
+            // control block would otherwise block everyone else
+            if (state != SHM_IDLE && !process_alive(STATE_OWNER(state)) &&
+                __atomic_compare_exchange_n(&control->state, &state, SHM_IDLE, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                printf("Warning: Client %d exited during a request, releasing %s\n",
+                       (int)STATE_OWNER(state), name);
+                if (STATE_PHASE(state) == SHM_DONE) {
+                    // Its segment would otherwise outlive it
+                    char segment[SHM_NAME_SIZE];
+                    memcpy(segment, control->segment, sizeof(segment));
+                    segment[sizeof(segment) - 1] = '\0';
+                    shm_unlink(segment);
+                }
+                doorbell_ring(&control->state);
+                continue;
+            }
+            doorbell_wait(&control->state, state, LIVENESS_CHECK_MS);
+            continue;
+        }
+    
+        double start = wall_clock_seconds();
+        handle_request(control, solve, user);
+        control->result.handle_seconds = wall_clock_seconds() - start;
+        control->sequence++;
+        store_state(control, MAKE_STATE(STATE_OWNER(state), SHM_DONE));
+    
+        printf("[SHM] request %llu from %d: %s in %.3f s\n", (unsigned long long)control->sequence,
+               (int)STATE_OWNER(state), control->result.status == 0 ? "ok" : "failed",
+               control->result.handle_seconds);
+        fflush(stdout);
+    }
+    
+    printf("Shutting down\n");
+    memset(control->magic, 0, sizeof(control->magic));
+    munmap(control, sizeof(ShmControl));
+    shm_unlink(name);
+    return 0;
+}
+
+int shm_problem_create(ShmProblem* shm, cuopt_int_t num_constraints, cuopt_int_t num_variables,
+                       cuopt_int_t nnz, unsigned absent) {
+    static unsigned long counter = 0;
+    memset(shm, 0, sizeof(ShmProblem));
+    
+    ProblemBinaryHeader header;
+    uint64_t image_size = problem_binary_layout(&header, num_constraints, num_variables, nnz, absent);
+    shm->primal_offset = image_size;
+    shm->size = (size_t)(image_size + (uint64_t)num_variables * sizeof(cuopt_float_t));
+    
+    unsigned long id = __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+    snprintf(shm->name, sizeof(shm->name), "/cuopt-problem.%ld.%lu", (long)getpid(), id);
+    int fd = shm_open(shm->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        printf("Error: Cannot create shared memory %s (%s)\n", shm->name, strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)shm->size) != 0) {
+        printf("Error: Cannot size shared memory %s to %zu bytes\n", shm->name, shm->size);
+        close(fd);
+        shm_unlink(shm->name);
+        return -1;
+    }
+    void* mapping = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Error: Cannot map shared memory %s\n", shm->name);
+        shm_unlink(shm->name);
+        return -1;
+    }
+    shm->base = mapping;
+    
+    memcpy(mapping, &header, sizeof(header));
+    if (problem_binary_attach(NULL, mapping, (size_t)image_size, &shm->problem, 0) != 0) {
+        shm_problem_destroy(shm);
+        return -1;
+    }
+    shm->primal = (cuopt_float_t*)((char*)mapping + shm->primal_offset);
+    return 0;
+}
+
+int shm_problem_submit(const char* service, ShmProblem* shm, ShmResult* result) {
+    char name[SHM_NAME_SIZE];
+    if (control_name(name, sizeof(name), service) != 0) {
+        return -1;
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    ShmControl* control = fd >= 0 ? map_control(fd) : NULL;
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!control || memcmp(control->magic, SHM_CONTROL_MAGIC, 8) != 0 ||
+        control->version != SHM_CONTROL_VERSION) {
+        printf("Error: No solver is serving on shared memory %s\n", name);
+        if (control) {
+            munmap(control, sizeof(ShmControl));
+        }
+        return -1;
+    }
+    
+    pid_t self = getpid();
+    int status = -1;
+    
+    // Wait for the control block to become idle and claim it
+    for (;;) {
+        uint32_t state = load_state(control);
+        if (state == SHM_IDLE) {
+            if (__atomic_compare_exchange_n(&control->state, &state, MAKE_STATE(self, SHM_CLAIMED), 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            continue;
+        }
+        if (!process_alive(control->server_pid)) {
+            printf("Error: The solver serving on %s has exited\n", name);
+            goto DONE;
+        }
+        doorbell_wait(&control->state, state, LIVENESS_CHECK_MS);
+    }
+    
+    memset(control->segment, 0, sizeof(control->segment));
+    memcpy(control->segment, shm->name, strlen(shm->name));
+    control->segment_size = shm->size;
+    control->primal_offset = shm->primal_offset;
+    control->objective_sense = shm->problem.objective_sense;
+    control->objective_offset = shm->problem.objective_offset;
+    control->objective_scaling_factor = shm->problem.objective_scaling_factor;
+    store_state(control, MAKE_STATE(self, SHM_REQUEST));
+    
+    for (;;) {
+        uint32_t state = load_state(control);
+        if (state == MAKE_STATE(self, SHM_DONE)) {
+            break;
+        }
+        if (!process_alive(control->server_pid)) {
+            printf("Error: The solver serving on %s exited during the request\n", name);
+            goto DONE;
+        }
+        doorbell_wait(&control->state, state, LIVENESS_CHECK_MS);
+    }
+    *result = control->result;
+    store_state(control, SHM_IDLE);
+    status = 0;
+    
+DONE:
+    munmap(control, sizeof(ShmControl));
+    return status;
+}
+
+void shm_problem_destroy(ShmProblem* shm) {
+    if (shm->base) {
+        munmap(shm->base, shm->size);
+        shm_unlink(shm->name);
+    }
+    memset(shm, 0, sizeof(ShmProblem));
+}
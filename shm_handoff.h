@@ -0,0 +1,72 @@
+/*
+ * shm_handoff.h - Shared-memory problem hand-off for co-located clients
+ *
+ * A solver started with `--serve-shm NAME` owns a small POSIX shared-memory
+ * control block, /NAME. A client hands over a problem without serializing
+ * it:
+ *
+ *   1. shm_problem_create() makes a private segment holding a .cuopt.bin
+ *      image (header plus 64-byte aligned CSR, bound and objective arrays)
+ *      followed by room for the primal solution, and points a ProblemData
+ *      straight into it. The client fills the arrays in place.
+ *   2. shm_problem_submit() claims the control block, posts the segment
+ *      name and rings the doorbell, a futex on the control block's state
+ *      word. The server maps the segment, calls cuOptCreateRangedProblem
+ *      on the mapped arrays, writes the primal solution into the segment
+ *      and rings back.
+ *
+ * One request is in flight at a time; other clients wait on the same futex
+ * for the control block to become idle. Segments are removed by the client
+ * in shm_problem_destroy().
+ */
+
+#ifndef SHM_HANDOFF_H
+#define SHM_HANDOFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cuopt_json_to_c_api.h"
+
+#define SHM_NAME_SIZE 64
+
+// Outcome of a solve, as written back into the control block
+typedef struct {
+    int32_t status;               // CUOPT_SUCCESS, the failing API status, or -1
+    int32_t termination_status;
+    double objective_value;
+    double solver_time;           // as reported by the solver
+    double handle_seconds;        // from the doorbell to the reply, on the server
+} ShmResult;
+
+// A problem segment owned by a client
+typedef struct {
+    char name[SHM_NAME_SIZE];
+    void* base;
+    size_t size;
+    uint64_t primal_offset;
+    ProblemData problem;          // arrays point into the segment
+    cuopt_float_t* primal;        // filled by the server after a solve
+} ShmProblem;
+
+// Solve the mapped problem, writing num_variables values to `primal`
+typedef void (*ShmSolveFn)(void* user, const ProblemData* data, cuopt_float_t* primal,
+                           ShmResult* result);
+
+// Serve requests on the control block `service` until SIGINT or SIGTERM.
+// Returns 0 on a clean shutdown, -1 if the control block could not be set up.
+int shm_serve(const char* service, ShmSolveFn solve, void* user);
+
+// Create a segment for a problem of the given sizes and point
+// `shm->problem` into it. Sections whose bit (1 << ProblemSectionId) is set
+// in `absent` get no storage and stay NULL. Returns 0 on success.
+int shm_problem_create(ShmProblem* shm, cuopt_int_t num_constraints, cuopt_int_t num_variables,
+                       cuopt_int_t nnz, unsigned absent);
+
+// Hand the filled problem to the server at `service` and wait for the
+// solve. Returns 0 if the request was answered (see result->status).
+int shm_problem_submit(const char* service, ShmProblem* shm, ShmResult* result);
+
+// Unmap and remove the segment
+void shm_problem_destroy(ShmProblem* shm);
+
+#endif // SHM_HANDOFF_H
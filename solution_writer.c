@@ -0,0 +1,443 @@
+/*
+ * solution_writer.c - Solution files written with --solution-out
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "solution_writer.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "fast_dtoa.h"
+#include "name_table.h"
+
+// Values formatted by one task; large enough that a chunk is one big write
+#define SOLUTION_CHUNK_VALUES 16384
+
+// Chunks per thread formatted in one round, so uneven chunks still balance
+#define CHUNKS_PER_THREAD 4
+
+// Bytes one value can take in any text format: CSV section, index,
+// separators and the number itself; names come on top of this
+#define MAX_LINE_BYTES (FAST_DTOA_BUFFER_SIZE + 48)
+
+// Fastest gzip level: solutions are mostly repeated short numbers, which
+// compress well even so
+#define GZIP_LEVEL 1
+
+// deflate output buffer, and the most handed to deflate at once (its
+// counters are 32-bit)
+#define GZIP_BUFFER_BYTES (1 << 20)
+#define GZIP_MAX_INPUT (1u << 30)
+
+// Where the bytes of a solution file go: straight to the file, or through
+// deflate with a gzip wrapper
+typedef struct {
+    FILE* file;
+    z_stream* stream;          // NULL without compression
+    unsigned char* buffer;     // GZIP_BUFFER_BYTES of deflate output
+} SolutionSink;
+
+typedef struct {
+    const cuopt_float_t* values;   // NULL to write `names` as a JSON array
+    const NameTable* names;        // CSV labels, NULL to label by index
+    const char* section;           // first CSV column
+    size_t count;
+    size_t first;         // first value of the round
+    SolutionFormat format;
+    char** buffers;       // one per chunk of the round, grown for long names
+    size_t* capacities;
+    size_t* lengths;      // SIZE_MAX if a buffer could not grow
+} FormatJob;
+
+static int has_suffix(const char* name, const char* suffix) {
+    size_t n = strlen(name), m = strlen(suffix);
+    return n >= m && strcmp(name + n - m, suffix) == 0;
+}
+
+int solution_path_compressed(const char* filename) {
+    return has_suffix(filename, ".gz");
+}
+
+SolutionFormat solution_format_for_path(const char* filename) {
+    size_t length = strlen(filename) - (solution_path_compressed(filename) ? 3 : 0);
+    if (length >= 5 && strncmp(filename + length - 5, ".json", 5) == 0) {
+        return SOLUTION_FORMAT_JSON;
+    }
+    if (length >= 4 && strncmp(filename + length - 4, ".bin", 4) == 0) {
+        return SOLUTION_FORMAT_BINARY;
+    }
+    return SOLUTION_FORMAT_CSV;
+}
+
+// Run deflate over `size` bytes (none with Z_FINISH) and write what it
+// produces
+static int deflate_to_file(SolutionSink* sink, const void* data, size_t size, int flush) {
+    z_stream* stream = sink->stream;
+    stream->next_in = (Bytef*)data;
+    stream->avail_in = (uInt)size;
+    for (;;) {
+        stream->next_out = sink->buffer;
+        stream->avail_out = GZIP_BUFFER_BYTES;
+        int status = deflate(stream, flush);
+        if (status == Z_STREAM_ERROR) {
+            return -1;
+        }
+        size_t produced = GZIP_BUFFER_BYTES - stream->avail_out;
+        if (produced && fwrite(sink->buffer, 1, produced, sink->file) != produced) {
+            return -1;
+        }
+        // Input is used up once deflate leaves output space unused; the
+        // final block is done at Z_STREAM_END
+        if (flush == Z_FINISH ? status == Z_STREAM_END : stream->avail_out != 0) {
+            return 0;
+        }
+    }
+}
+
+static int sink_write(SolutionSink* sink, const void* data, size_t size) {
+    if (!sink->stream) {
+        return fwrite(data, 1, size, sink->file) == size ? 0 : -1;
+    }
+    const char* bytes = data;
+    while (size > 0) {
+        size_t piece = size < GZIP_MAX_INPUT ? size : GZIP_MAX_INPUT;
+        if (deflate_to_file(sink, bytes, piece, Z_NO_FLUSH) != 0) {
+            return -1;
+        }
+        bytes += piece;
+        size -= piece;
+    }
+    return 0;
+}
+
+static int sink_open(SolutionSink* sink, const char* filename) {
+    memset(sink, 0, sizeof(SolutionSink));
+    sink->file = fopen(filename, "wb");
+    if (!sink->file) {
+        return -1;
+    }
+    if (solution_path_compressed(filename)) {
+        sink->stream = calloc(1, sizeof(z_stream));
+        sink->buffer = malloc(GZIP_BUFFER_BYTES);
+        // 15 + 16: largest window, gzip header and trailer instead of zlib's
+        if (!sink->stream || !sink->buffer ||
+            deflateInit2(sink->stream, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            free(sink->stream);
+            free(sink->buffer);
+            fclose(sink->file);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Finish the gzip stream, flush and fsync the file and close it; the file
+// is only complete on disk once this returns 0
+static int sink_close(SolutionSink* sink, int failed) {
+    if (sink->stream) {
+        if (!failed) {
+            failed = deflate_to_file(sink, NULL, 0, Z_FINISH) != 0;
+        }
+        deflateEnd(sink->stream);
+        free(sink->stream);
+        free(sink->buffer);
+    }
+    if (!failed) {
+        failed = fflush(sink->file) != 0 || fsync(fileno(sink->file)) != 0;
+    }
+    if (fclose(sink->file) != 0) {
+        failed = 1;
+    }
+    return failed ? -1 : 0;
+}
+
+static char* write_index(char* p, size_t value) {
+    char digits[24];
+    int length = 0;
+    do {
+        digits[length++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (length) {
+        *p++ = digits[--length];
+    }
+    return p;
+}
+
+// JSON has no spelling for infinities and NaN
+static char* write_json_number(char* p, cuopt_float_t value) {
+    if (!isfinite(value)) {
+        memcpy(p, "null", 4);
+        return p + 4;
+    }
+    return p + fast_dtoa((double)value, p);
+}
+
+// CSV fields with separators, quotes or line breaks are quoted, with
+// quotes doubled
+static char* write_csv_name(char* p, const char* name) {
+    if (!name[strcspn(name, ",\"\r\n")]) {
+        size_t length = strlen(name);
+        memcpy(p, name, length);
+        return p + length;
+    }
+    *p++ = '"';
+    for (; *name; name++) {
+        if (*name == '"') {
+            *p++ = '"';
+        }
+        *p++ = *name;
+    }
+    *p++ = '"';
+    return p;
+}
+
+static char* write_json_string(char* p, const char* name) {
+    static const char hex[] = "0123456789abcdef";
+    *p++ = '"';
+    for (; *name; name++) {
+        unsigned char c = (unsigned char)*name;
+        if (c == '"' || c == '\\') {
+            *p++ = '\\';
+            *p++ = (char)c;
+        } else if (c < 0x20) {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        } else {
+            *p++ = (char)c;
+        }
+    }
+    *p++ = '"';
+    return p;
+}
+
+// Make sure the chunk's buffer holds its lines, names escaped at worst
+// (6 bytes a character in JSON) included
+static int reserve_chunk(FormatJob* job, size_t chunk, size_t begin, size_t end) {
+    size_t needed = (end - begin) * MAX_LINE_BYTES;
+    if (job->names) {
+        // The chunk's names are contiguous in the arena
+        const NameTable* names = job->names;
+        size_t last = end < (size_t)names->count ? names->offsets[end] : names->arena_size;
+        needed += 6 * (last - names->offsets[begin]) + 2 * (end - begin);
+    }
+    if (needed <= job->capacities[chunk]) {
+        return 0;
+    }
+    char* buffer = realloc(job->buffers[chunk], needed);
+    if (!buffer) {
+        return -1;
+    }
+    job->buffers[chunk] = buffer;
+    job->capacities[chunk] = needed;
+    return 0;
+}
+
+// Format the values of one chunk of the round into its buffer
+static void format_chunk(void* arg, size_t chunk) {
+    FormatJob* job = arg;
+    size_t begin = job->first + chunk * SOLUTION_CHUNK_VALUES;
+    size_t end = begin + SOLUTION_CHUNK_VALUES < job->count ? begin + SOLUTION_CHUNK_VALUES : job->count;
+    if (reserve_chunk(job, chunk, begin, end) != 0) {
+        job->lengths[chunk] = SIZE_MAX;
+        return;
+    }
+    char* p = job->buffers[chunk];
+    for (size_t i = begin; i < end; i++) {
+        if (job->format == SOLUTION_FORMAT_CSV) {
+            size_t length = strlen(job->section);
+            memcpy(p, job->section, length);
+            p[length] = ',';
+            p += length + 1;
+            p = job->names ? write_csv_name(p, name_table_get(job->names, (cuopt_int_t)i))
+                           : write_index(p, i);
+            *p++ = ',';
+            p += fast_dtoa((double)job->values[i], p);
+            *p++ = '\n';
+        } else {
+            if (i > 0) {
+                *p++ = ',';
+            }
+            memcpy(p, "\n    ", 5);
+            p += 5;
+            p = job->values ? write_json_number(p, job->values[i])
+                            : write_json_string(p, name_table_get(job->names, (cuopt_int_t)i));
+        }
+    }
+    job->lengths[chunk] = (size_t)(p - job->buffers[chunk]);
+}
+
+// Format `values` (or, without them, the JSON strings of `names`) round by
+// round on the thread pool and write each round's buffers in order
+static int write_values(JobContext* ctx, SolutionSink* sink, SolutionFormat format,
+                        const char* section, const cuopt_float_t* values, const NameTable* names,
+                        size_t count) {
+    size_t num_chunks = (count + SOLUTION_CHUNK_VALUES - 1) / SOLUTION_CHUNK_VALUES;
+    ThreadPool* pool = job_thread_pool(ctx);
+    size_t round_chunks = (size_t)thread_pool_size(pool) * CHUNKS_PER_THREAD;
+    if (round_chunks > num_chunks) {
+        round_chunks = num_chunks;
+    }
+    if (round_chunks == 0) {
+        return 0;
+    }
+    
+    char** buffers = calloc(round_chunks, sizeof(char*));
+    size_t* capacities = calloc(round_chunks, sizeof(size_t));
+    size_t* lengths = calloc(round_chunks, sizeof(size_t));
+    int failed = !buffers || !capacities || !lengths;
+    if (failed) {
+        job_printf(ctx, "Error: Memory allocation failed\n");
+    }
+    
+    FormatJob job = { values, names, section, count, 0, format, buffers, capacities, lengths };
+    for (size_t chunk = 0; chunk < num_chunks && !failed; chunk += round_chunks) {
+        size_t chunks = num_chunks - chunk < round_chunks ? num_chunks - chunk : round_chunks;
+        job.first = chunk * SOLUTION_CHUNK_VALUES;
+        thread_pool_parallel_for(pool, chunks, format_chunk, &job);
+        for (size_t c = 0; c < chunks && !failed; c++) {
+            if (lengths[c] == SIZE_MAX) {
+                job_printf(ctx, "Error: Memory allocation failed\n");
+                failed = 1;
+            } else {
+                failed = sink_write(sink, buffers[c], lengths[c]) != 0;
+            }
+        }
+    }
+    
+    for (size_t c = 0; buffers && c < round_chunks; c++) {
+        free(buffers[c]);
+    }
+    free(buffers);
+    free(capacities);
+    free(lengths);
+    return failed ? -1 : 0;
+}
+
+// The duals and reduced costs are written only when the solve produced them
+static int has_duals(const SolveResult* result) {
+    return result->has_duals && result->dual_solution && result->reduced_costs;
+}
+
+static int write_binary(SolutionSink* sink, const SolveResult* result, const ProblemData* problem) {
+    size_t n = (size_t)problem->num_variables, m = (size_t)problem->num_constraints;
+    SolutionBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SOLUTION_BINARY_MAGIC, sizeof(header.magic));
+    header.version = SOLUTION_BINARY_VERSION;
+    header.float_size = (uint32_t)sizeof(cuopt_float_t);
+    header.num_variables = problem->num_variables;
+    header.termination_status = result->termination_status;
+    header.flags = has_duals(result) ? SOLUTION_BINARY_HAS_DUALS : 0;
+    header.objective_value = result->objective_value;
+    header.num_constraints = problem->num_constraints;
+    if (sink_write(sink, &header, sizeof(header)) != 0 ||
+        sink_write(sink, result->primal_solution, n * sizeof(cuopt_float_t)) != 0) {
+        return -1;
+    }
+    if (!has_duals(result)) {
+        return 0;
+    }
+    if (sink_write(sink, result->reduced_costs, n * sizeof(cuopt_float_t)) != 0) {
+        return -1;
+    }
+    return sink_write(sink, result->dual_solution, m * sizeof(cuopt_float_t));
+}
+
+static int sink_puts(SolutionSink* sink, const char* text) {
+    return sink_write(sink, text, strlen(text));
+}
+
+// Write `"key": [...]` with the values, or without them the names
+static int write_json_array(JobContext* ctx, SolutionSink* sink, const char* key,
+                            const cuopt_float_t* values, const NameTable* names, size_t count) {
+    char head[64];
+    snprintf(head, sizeof(head), ",\n  \"%s\": [", key);
+    if (sink_puts(sink, head) != 0 ||
+        write_values(ctx, sink, SOLUTION_FORMAT_JSON, NULL, values, names, count) != 0) {
+        return -1;
+    }
+    return sink_puts(sink, count > 0 ? "\n  ]" : "]");
+}
+
+static int write_json(JobContext* ctx, SolutionSink* sink, const SolveResult* result,
+                      const ProblemData* problem) {
+    size_t n = (size_t)problem->num_variables, m = (size_t)problem->num_constraints;
+    char objective[FAST_DTOA_BUFFER_SIZE + 1];
+    *write_json_number(objective, result->objective_value) = '\0';
+    char head[256];
+    snprintf(head, sizeof(head), "{\n  \"termination_status\": %d,\n  \"termination\": \"%s\",\n"
+             "  \"objective_value\": %s", (int)result->termination_status,
+             termination_status_to_string(result->termination_status), objective);
+    if (sink_puts(sink, head) != 0 ||
+        (problem->variable_names &&
+         write_json_array(ctx, sink, "variable_names", NULL, problem->variable_names, n) != 0) ||
+        write_json_array(ctx, sink, "primal_solution", result->primal_solution, NULL, n) != 0) {
+        return -1;
+    }
+    if (has_duals(result) &&
+        (write_json_array(ctx, sink, "reduced_costs", result->reduced_costs, NULL, n) != 0 ||
+         (problem->row_names &&
+          write_json_array(ctx, sink, "row_names", NULL, problem->row_names, m) != 0) ||
+         write_json_array(ctx, sink, "dual_solution", result->dual_solution, NULL, m) != 0)) {
+        return -1;
+    }
+    return sink_puts(sink, "\n}\n");
+}
+
+static int write_csv(JobContext* ctx, SolutionSink* sink, const SolveResult* result,
+                     const ProblemData* problem) {
+    size_t n = (size_t)problem->num_variables, m = (size_t)problem->num_constraints;
+    if (sink_puts(sink, "section,name,value\n") != 0 ||
+        write_values(ctx, sink, SOLUTION_FORMAT_CSV, "primal", result->primal_solution,
+                     problem->variable_names, n) != 0) {
+        return -1;
+    }
+    if (!has_duals(result)) {
+        return 0;
+    }
+    if (write_values(ctx, sink, SOLUTION_FORMAT_CSV, "reduced_cost", result->reduced_costs,
+                     problem->variable_names, n) != 0) {
+        return -1;
+    }
+    return write_values(ctx, sink, SOLUTION_FORMAT_CSV, "dual", result->dual_solution,
+                        problem->row_names, m);
+}
+
+int solution_write(JobContext* ctx, const char* filename, const SolveResult* result,
+                   const ProblemData* problem) {
+    SolutionSink sink;
+    if (sink_open(&sink, filename) != 0) {
+        job_printf(ctx, "Error: Cannot create file %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    
+    int failed;
+    switch (solution_format_for_path(filename)) {
+        case SOLUTION_FORMAT_BINARY:
+            failed = write_binary(&sink, result, problem);
+            break;
+        case SOLUTION_FORMAT_JSON:
+            failed = write_json(ctx, &sink, result, problem);
+            break;
+        default:
+            failed = write_csv(ctx, &sink, result, problem);
+            break;
+    }
+    failed = sink_close(&sink, failed) != 0;
+    
+    if (failed) {
+        job_printf(ctx, "Error: Failed to write %s\n", filename);
+        remove(filename);
+        return -1;
+    }
+    return 0;
+}
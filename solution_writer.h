@@ -0,0 +1,71 @@
+/*
+ * solution_writer.h - Solution files written with --solution-out
+ *
+ * The format follows the file extension:
+ *
+ *   .json   {"termination_status", "termination", "objective_value",
+ *            "variable_names", "primal_solution", "reduced_costs",
+ *            "row_names", "dual_solution"}, non-finite values as null
+ *   .bin    SolutionBinaryHeader followed by the primal, reduced costs and
+ *           duals as raw cuopt_float_t values in host byte order
+ *   other   CSV with a "section,name,value" header and one line per value,
+ *           the section being primal, reduced_cost or dual
+ *
+ * Reduced costs and duals are written only when the solve produced them
+ * (LPs), and names only when the input had them; CSV labels values by
+ * index otherwise.
+ *
+ * A further ".gz" suffix (e.g. "solution.csv.gz") compresses the file with
+ * gzip on the way out. Files are fsync'd before the write counts as done.
+ *
+ * Text values are written with fast_dtoa, the shortest decimal that reads
+ * back as the same double, so a solution survives a round trip through
+ * the file exactly. Large solutions are formatted in chunks on the job's
+ * thread pool, each chunk into its own buffer, and the buffers are handed
+ * to the file in order with one large write each.
+ */
+
+#ifndef SOLUTION_WRITER_H
+#define SOLUTION_WRITER_H
+
+#include <stdint.h>
+#include "cuopt_json_to_c_api.h"
+
+#define SOLUTION_BINARY_MAGIC "CUOPTSOL"
+#define SOLUTION_BINARY_VERSION 2
+
+// SolutionBinaryHeader.flags: reduced costs and duals follow the primal
+#define SOLUTION_BINARY_HAS_DUALS 1u
+
+typedef enum {
+    SOLUTION_FORMAT_CSV,
+    SOLUTION_FORMAT_JSON,
+    SOLUTION_FORMAT_BINARY
+} SolutionFormat;
+
+typedef struct {
+    char magic[8];                 // SOLUTION_BINARY_MAGIC, not NUL-terminated
+    uint32_t version;              // SOLUTION_BINARY_VERSION
+    uint32_t float_size;           // sizeof(cuopt_float_t) of the writer
+    int64_t num_variables;
+    int32_t termination_status;
+    uint32_t flags;                // SOLUTION_BINARY_HAS_DUALS
+    double objective_value;
+    int64_t num_constraints;
+} SolutionBinaryHeader;
+
+// Format for `filename`, from its extension (ignoring a ".gz" suffix)
+SolutionFormat solution_format_for_path(const char* filename);
+
+// 1 if `filename` ends in ".gz", i.e. is written gzip-compressed
+int solution_path_compressed(const char* filename);
+
+// Write the termination status, objective and solution vectors of `result`
+// to `filename`, sized and named by `problem` (only its num_variables,
+// num_constraints, variable_names and row_names are used). Returns 0 on
+// success, -1 on failure (an error has been printed and the partial file
+// removed).
+int solution_write(JobContext* ctx, const char* filename, const SolveResult* result,
+                   const ProblemData* problem);
+
+#endif // SOLUTION_WRITER_H
@@ -0,0 +1,506 @@
+/*
+ * solver_service.c - Solver daemon on a Unix domain socket
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "solver_service.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "input_file.h"
+#include "job_context.h"
+
+#define RECEIVE_CHUNK_SIZE (1 << 20)
+
+typedef struct {
+    int fd;
+    unsigned long id;
+    char* body;
+    size_t length;
+    double accepted_at;
+    double received_at;
+} ServiceRequest;
+
+// A connection whose request body is still arriving
+typedef struct {
+    ServiceRequest request;   // body and length grow as data arrives
+    size_t capacity;
+    double deadline;          // dropped if nothing arrives before this
+} Receiving;
+
+typedef struct {
+    ServiceHandler handler;
+    void* user;
+    
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    ServiceRequest* ring;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    int closed;
+} Service;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signo) {
+    (void)signo;
+    stop_requested = 1;
+}
+
+void service_buffer_printf(ServiceBuffer* buffer, const char* format, ...) {
+    if (buffer->failed) {
+        return;
+    }
+    for (;;) {
+        size_t available = buffer->capacity - buffer->length;
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buffer->data ? buffer->data + buffer->length : NULL, available, format, args);
+        va_end(args);
+        if (n < 0) {
+            buffer->failed = 1;
+            return;
+        }
+        if ((size_t)n < available) {
+            buffer->length += (size_t)n;
+            return;
+        }
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (capacity - buffer->length <= (size_t)n) {
+            capacity *= 2;
+        }
+        char* grown = realloc(buffer->data, capacity);
+        if (!grown) {
+            buffer->failed = 1;
+            return;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+}
+
+// Write all of `length` bytes; clients that went away are not an error
+// worth more than dropping the response
+static int send_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static void send_line(int fd, const char* format, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) {
+        send_all(fd, line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+    }
+}
+
+// Read what has arrived on a connection without blocking, at most one
+// chunk so that other clients get their turn. Returns 1 once the client has
+// shut down its write side, 0 if more is to come and -1 on an error.
+static int receive_some(Receiving* receiving) {
+    ServiceRequest* request = &receiving->request;
+    if (request->length == receiving->capacity) {
+        if (receiving->capacity >= SERVICE_MAX_REQUEST_BYTES) {
+            return -1;
+        }
+        size_t capacity = receiving->capacity ? receiving->capacity * 2 : RECEIVE_CHUNK_SIZE;
+        char* grown = realloc(request->body, capacity);
+        if (!grown) {
+            return -1;
+        }
+        request->body = grown;
+        receiving->capacity = capacity;
+    }
+    ssize_t n = recv(request->fd, request->body + request->length,
+                     receiving->capacity - request->length, 0);
+    if (n < 0) {
+        return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    request->length += (size_t)n;
+    return 0;
+}
+
+static int set_blocking(int fd, int blocking) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) {
+        return -1;
+    }
+    flags = blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK;
+    return fcntl(fd, F_SETFL, flags);
+}
+
+// Tell the client why its request was not taken and close the connection
+static void drop_request(ServiceRequest* request, const char* error) {
+    send_line(request->fd, "{\"event\":\"result\",\"request\":%lu,\"ok\":false,"
+              "\"error\":\"%s\"}\n", request->id, error);
+    close(request->fd);
+    free(request->body);
+    printf("[SERVE] request %lu: dropped, %s\n", request->id, error);
+    fflush(stdout);
+}
+
+// Hand a fully received request to the solver thread
+static void enqueue_request(Service* service, ServiceRequest* request) {
+    request->received_at = wall_clock_seconds();
+    if (set_blocking(request->fd, 1) != 0) {
+        drop_request(request, "could not receive request");
+        return;
+    }
+    pthread_mutex_lock(&service->mutex);
+    size_t position = service->count + 1;
+    pthread_mutex_unlock(&service->mutex);
+    // Sent before the push: once queued, the solver thread owns the socket
+    send_line(request->fd, "{\"event\":\"queued\",\"request\":%lu,\"position\":%zu}\n",
+              request->id, position);
+    
+    pthread_mutex_lock(&service->mutex);
+    service->ring[(service->head + service->count) % service->capacity] = *request;
+    service->count++;
+    pthread_cond_signal(&service->not_empty);
+    pthread_mutex_unlock(&service->mutex);
+}
+
+// Solver thread: answer queued requests one at a time
+static void* solver_main(void* arg) {
+    Service* service = arg;
+    for (;;) {
+        pthread_mutex_lock(&service->mutex);
+        while (service->count == 0 && !service->closed) {
+            pthread_cond_wait(&service->not_empty, &service->mutex);
+        }
+        if (service->count == 0) {
+            pthread_mutex_unlock(&service->mutex);
+            break;
+        }
+        ServiceRequest request = service->ring[service->head];
+        service->head = (service->head + 1) % service->capacity;
+        service->count--;
+        pthread_mutex_unlock(&service->mutex);
+        
+        double started_at = wall_clock_seconds();
+        ServiceBuffer response;
+        memset(&response, 0, sizeof(response));
+        service_buffer_printf(&response, "{\"event\":\"result\",\"request\":%lu,", request.id);
+        int status = service->handler(service->user, request.body, request.length, &response);
+        double finished_at = wall_clock_seconds();
+        service_buffer_printf(&response,
+                              ",\"timing\":{\"receive\":%.6f,\"queue_wait\":%.6f,\"handle\":%.6f,"
+                              "\"total\":%.6f}}\n",
+                              request.received_at - request.accepted_at,
+                              started_at - request.received_at, finished_at - started_at,
+                              finished_at - request.accepted_at);
+        free(request.body);
+        
+        if (response.failed) {
+            send_line(request.fd, "{\"event\":\"result\",\"request\":%lu,\"ok\":false,"
+                      "\"error\":\"response too large\"}\n", request.id);
+        } else {
+            send_all(request.fd, response.data, response.length);
+        }
+        free(response.data);
+        close(request.fd);
+        
+        printf("[SERVE] request %lu: %s in %.3f s (queued %.3f s)\n", request.id,
+               status == 0 ? "ok" : "failed", finished_at - request.accepted_at,
+               started_at - request.received_at);
+        fflush(stdout);
+    }
+    return NULL;
+}
+
+static int open_listener(const char* socket_path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("Error: Socket path too long: %s\n", socket_path);
+        return -1;
+    }
+    strcpy(address.sun_path, socket_path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Error: Cannot create socket\n");
+        return -1;
+    }
+    // A socket file left behind by a previous server would make bind fail
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 64) != 0) {
+        printf("Error: Cannot listen on %s (%s)\n", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int service_run(const char* socket_path, int queue_depth, ServiceHandler handler, void* user) {
+    Service service;
+    memset(&service, 0, sizeof(service));
+    service.handler = handler;
+    service.user = user;
+    service.capacity = queue_depth > 0 ? (size_t)queue_depth : 1;
+    service.ring = calloc(service.capacity, sizeof(ServiceRequest));
+    // Connections whose body is still arriving, and the listener plus
+    // those connections to poll
+    Receiving* receiving = calloc(service.capacity, sizeof(Receiving));
+    struct pollfd* fds = calloc(service.capacity + 1, sizeof(struct pollfd));
+    if (!service.ring || !receiving || !fds) {
+        printf("Error: Memory allocation failed\n");
+        free(service.ring);
+        free(receiving);
+        free(fds);
+        return -1;
+    }
+    
+    int listener = open_listener(socket_path);
+    if (listener >= 0 && set_blocking(listener, 0) != 0) {
+        close(listener);
+        listener = -1;
+    }
+    if (listener < 0) {
+        free(service.ring);
+        free(receiving);
+        free(fds);
+        return -1;
+    }
+    
+    // No SA_RESTART, so a signal interrupts poll() and ends the loop
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    
+    pthread_mutex_init(&service.mutex, NULL);
+    pthread_cond_init(&service.not_empty, NULL);
+    // The stop signals go to this thread, so that they interrupt poll()
+    sigset_t stop_signals, previous;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &previous);
+    pthread_t solver;
+    int started = pthread_create(&solver, NULL, solver_main, &service) == 0;
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (!started) {
+        printf("Error: Could not start solver thread\n");
+        close(listener);
+        unlink(socket_path);
+        free(service.ring);
+        free(receiving);
+        free(fds);
+        return -1;
+    }
+    
+    printf("Serving on %s (queue depth %zu)\n", socket_path, service.capacity);
+    fflush(stdout);
+    
+    // Bodies are received here, a chunk at a time from whichever clients
+    // have data, so a slow client does not hold up the others. Connections
+    // still arriving count against the queue depth.
+    unsigned long next_id = 0;
+    size_t num_receiving = 0;
+    while (!stop_requested) {
+        double now = wall_clock_seconds();
+        double first_deadline = 0.0;
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+        for (size_t i = 0; i < num_receiving; i++) {
+            fds[i + 1].fd = receiving[i].request.fd;
+            fds[i + 1].events = POLLIN;
+            if (i == 0 || receiving[i].deadline < first_deadline) {
+                first_deadline = receiving[i].deadline;
+            }
+        }
+        int timeout = -1;
+        if (num_receiving > 0) {
+            double wait = first_deadline - now;
+            timeout = wait > 0.0 ? (int)(wait * 1000.0) + 1 : 0;
+        }
+        if (poll(fds, num_receiving + 1, timeout) < 0) {
+            continue;
+        }
+        
+        // Iterate backwards, so that a finished connection can be replaced
+        // by the last one, which has already had its turn
+        now = wall_clock_seconds();
+        for (size_t i = num_receiving; i-- > 0;) {
+            Receiving* connection = &receiving[i];
+            int state = 0;
+            if (fds[i + 1].revents) {
+                state = receive_some(connection);
+                connection->deadline = now + SERVICE_RECEIVE_TIMEOUT;
+            } else if (now >= connection->deadline) {
+                state = -2;
+            }
+            if (state == 0) {
+                continue;
+            }
+            if (state == 1) {
+                enqueue_request(&service, &connection->request);
+            } else {
+                drop_request(&connection->request, state == -2 ? "receive timed out"
+                                                               : "could not receive request");
+            }
+            *connection = receiving[--num_receiving];
+        }
+        
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        unsigned long id = ++next_id;
+        double accepted_at = wall_clock_seconds();
+        
+        // Only this thread adds requests, so the queue cannot fill up
+        // between this check and the push once the body has arrived
+        pthread_mutex_lock(&service.mutex);
+        size_t waiting = service.count + num_receiving;
+        pthread_mutex_unlock(&service.mutex);
+        if (waiting >= service.capacity) {
+            send_line(fd, "{\"event\":\"rejected\",\"request\":%lu,"
+                      "\"reason\":\"queue full\"}\n", id);
+            close(fd);
+            printf("[SERVE] request %lu: rejected, queue full\n", id);
+            continue;
+        }
+        if (set_blocking(fd, 0) != 0) {
+            close(fd);
+            continue;
+        }
+        
+        Receiving* connection = &receiving[num_receiving++];
+        memset(connection, 0, sizeof(Receiving));
+        connection->request.fd = fd;
+        connection->request.id = id;
+        connection->request.accepted_at = accepted_at;
+        connection->deadline = accepted_at + SERVICE_RECEIVE_TIMEOUT;
+    }
+    
+    // Finish what was already received, then shut down; requests still
+    // arriving are dropped
+    printf("Shutting down, finishing queued requests\n");
+    close(listener);
+    unlink(socket_path);
+    for (size_t i = 0; i < num_receiving; i++) {
+        drop_request(&receiving[i].request, "server shutting down");
+    }
+    free(receiving);
+    free(fds);
+    pthread_mutex_lock(&service.mutex);
+    service.closed = 1;
+    pthread_cond_signal(&service.not_empty);
+    pthread_mutex_unlock(&service.mutex);
+    pthread_join(solver, NULL);
+    
+    pthread_cond_destroy(&service.not_empty);
+    pthread_mutex_destroy(&service.mutex);
+    free(service.ring);
+    return 0;
+}
+
+int service_client(const char* socket_path, const char* filename) {
+    InputFile input;
+    if (input_file_open(NULL, filename, &input) != 0) {
+        return -1;
+    }
+    
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("Error: Socket path too long: %s\n", socket_path);
+        input_file_close(&input);
+        return -1;
+    }
+    strcpy(address.sun_path, socket_path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        printf("Error: Cannot connect to %s (%s)\n", socket_path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        input_file_close(&input);
+        return -1;
+    }
+    
+    // A server with a full queue answers and hangs up without reading the
+    // request, so a failed send still leaves its rejection to read
+    int sent = send_all(fd, input.data, input.size);
+    input_file_close(&input);
+    shutdown(fd, SHUT_WR);
+    
+    // Echo the events as they arrive. Only the last line (the result or
+    // rejection) decides the exit status, so keep just the current line.
+    char chunk[65536];
+    ServiceBuffer line;
+    memset(&line, 0, sizeof(line));
+    int ok = 0;
+    size_t received = 0;
+    for (;;) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        fwrite(chunk, 1, (size_t)n, stdout);
+        received += (size_t)n;
+        for (ssize_t i = 0; i < n; i++) {
+            if (chunk[i] == '\n') {
+                if (line.data && strstr(line.data, "\"event\":\"result\"")) {
+                    ok = strstr(line.data, "\"ok\":true") != NULL;
+                }
+                line.length = 0;
+                if (line.data) {
+                    line.data[0] = '\0';
+                }
+            } else if (line.length < 256) {
+                // The status fields come first, so the line prefix is enough
+                service_buffer_printf(&line, "%c", chunk[i]);
+            }
+        }
+    }
+    free(line.data);
+    if (sent != 0 && received == 0) {
+        printf("Error: Failed to send request\n");
+    }
+    fflush(stdout);
+    close(fd);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,61 @@
+/*
+ * solver_service.h - Solver daemon on a Unix domain socket
+ *
+ * `--serve SOCKET` keeps the process, libcuopt and the solver settings
+ * resident and answers requests from local clients. A request is one
+ * connection: the client writes a cuOpt JSON problem and shuts down its
+ * write side; the server streams back newline-delimited JSON events:
+ *
+ *   {"event":"queued","request":N,"position":P}
+ *   {"event":"result","request":N,"ok":true,...,"timing":{...}}
+ *
+ * or a single {"event":"rejected",...} when the request queue is full.
+ * The accepting thread also receives the bodies, polling all connections
+ * and reading whichever has data, so a slow client does not hold up the
+ * others; one that sends nothing for SERVICE_RECEIVE_TIMEOUT seconds is
+ * dropped. Connections still being received count against the queue
+ * depth. Received requests are solved one at a time by a solver thread, in
+ * the order their bodies completed.
+ */
+
+#ifndef SOLVER_SERVICE_H
+#define SOLVER_SERVICE_H
+
+#include <stddef.h>
+
+// Largest request body accepted
+#define SERVICE_MAX_REQUEST_BYTES ((size_t)4 << 30)
+
+// Seconds a client may send nothing before its request is dropped
+#define SERVICE_RECEIVE_TIMEOUT 10.0
+
+// Growable text buffer for building responses
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    int failed;   // an allocation failed; the contents are truncated
+} ServiceBuffer;
+
+// Append formatted text to `buffer`
+void service_buffer_printf(ServiceBuffer* buffer, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// Solve one request. Appends the fields of the result event (comma
+// separated "key":value pairs, starting with "ok") to `response` and
+// returns 0 on success or -1 if the request failed.
+typedef int (*ServiceHandler)(void* user, const char* request, size_t length, ServiceBuffer* response);
+
+// Listen on `socket_path` until SIGINT or SIGTERM, keeping at most
+// `queue_depth` requests being received or waiting. Returns 0 on a clean shutdown,
+// -1 if the socket could not be set up.
+int service_run(const char* socket_path, int queue_depth, ServiceHandler handler, void* user);
+
+// Send `filename` to the server at `socket_path` and copy its events to
+// stdout. Returns 0 if the server reported success.
+int service_client(const char* socket_path, const char* filename);
+
+#endif // SOLVER_SERVICE_H
@@ -0,0 +1,184 @@
+/*
+ * thread_pool.c - Minimal fork-join thread pool
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Items below which a chunk is not worth a thread
+#define MIN_CHUNK_ITEMS 4096
+
+// Chunks per thread, so uneven items still balance out
+#define CHUNKS_PER_THREAD 4
+
+struct ThreadPool {
+    int num_threads;
+    pthread_t* workers;  // num_threads - 1 workers
+    
+    pthread_mutex_t loop_lock;  // serializes loops from different callers
+    pthread_mutex_t mutex;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    
+    // Current loop; generation changes every time a loop is published
+    unsigned long generation;
+    ThreadPoolTask task;
+    void* arg;
+    size_t count;
+    size_t next_index;     // claimed with atomic increments
+    int active_workers;    // workers still inside the current loop
+    int shutdown;
+};
+
+// Claim indices of the current loop until none are left
+static void run_loop(ThreadPool* pool, ThreadPoolTask task, void* arg, size_t count) {
+    for (;;) {
+        size_t index = __atomic_fetch_add(&pool->next_index, 1, __ATOMIC_RELAXED);
+        if (index >= count) {
+            break;
+        }
+        task(arg, index);
+    }
+}
+
+static void* worker_main(void* data) {
+    ThreadPool* pool = data;
+    unsigned long seen_generation = 0;
+    
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen_generation) {
+            pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        seen_generation = pool->generation;
+        ThreadPoolTask task = pool->task;
+        void* arg = pool->arg;
+        size_t count = pool->count;
+        pthread_mutex_unlock(&pool->mutex);
+        
+        run_loop(pool, task, arg, count);
+        
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->active_workers == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+ThreadPool* thread_pool_create(int num_threads) {
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+    }
+    
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) {
+        printf("Error: Memory allocation failed\n");
+        return NULL;
+    }
+    pool->num_threads = num_threads;
+    pthread_mutex_init(&pool->loop_lock, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+    
+    if (num_threads > 1) {
+        pool->workers = calloc((size_t)num_threads - 1, sizeof(pthread_t));
+        if (!pool->workers) {
+            printf("Error: Memory allocation failed\n");
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+        for (int i = 0; i < num_threads - 1; i++) {
+            if (pthread_create(&pool->workers[i], NULL, worker_main, pool) != 0) {
+                // Run with the workers we managed to start
+                printf("Warning: Could only start %d of %d threads\n", i + 1, num_threads);
+                pool->num_threads = i + 1;
+                break;
+            }
+        }
+    }
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+    
+    if (pool->workers) {
+        for (int i = 0; i < pool->num_threads - 1; i++) {
+            pthread_join(pool->workers[i], NULL);
+        }
+        free(pool->workers);
+    }
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->loop_lock);
+    free(pool);
+}
+
+int thread_pool_size(const ThreadPool* pool) {
+    return pool ? pool->num_threads : 1;
+}
+
+size_t thread_pool_chunk_size(const ThreadPool* pool, size_t count) {
+    size_t num_chunks = (size_t)thread_pool_size(pool) * CHUNKS_PER_THREAD;
+    size_t size = (count + num_chunks - 1) / num_chunks;
+    return size < MIN_CHUNK_ITEMS ? MIN_CHUNK_ITEMS : size;
+}
+
+size_t thread_pool_chunk_count(size_t count, size_t chunk_size) {
+    return (count + chunk_size - 1) / chunk_size;
+}
+
+void thread_pool_chunk_range(size_t chunk, size_t chunk_size, size_t count, size_t* begin,
+                             size_t* end) {
+    *begin = chunk * chunk_size;
+    *end = *begin + chunk_size < count ? *begin + chunk_size : count;
+}
+
+void thread_pool_parallel_for(ThreadPool* pool, size_t count, ThreadPoolTask task, void* arg) {
+    if (!pool || pool->num_threads <= 1 || count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+    
+    pthread_mutex_lock(&pool->loop_lock);
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next_index = 0;
+    pool->active_workers = pool->num_threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+    
+    run_loop(pool, task, arg, count);
+    
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->active_workers > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_mutex_unlock(&pool->loop_lock);
+}
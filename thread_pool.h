@@ -0,0 +1,45 @@
+/*
+ * thread_pool.h - Minimal fork-join thread pool
+ *
+ * A fixed set of worker threads that execute parallel-for loops. The
+ * calling thread takes part in every loop, so a pool of size 1 has no
+ * worker threads and runs everything inline.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+typedef struct ThreadPool ThreadPool;
+
+// Body of a parallel loop, called once per index
+typedef void (*ThreadPoolTask)(void* arg, size_t index);
+
+// Create a pool running loops on `num_threads` threads in total (including
+// the caller). num_threads <= 0 means one thread per online CPU.
+ThreadPool* thread_pool_create(int num_threads);
+void thread_pool_destroy(ThreadPool* pool);
+
+// Number of threads loops are spread over (1 for a NULL pool)
+int thread_pool_size(const ThreadPool* pool);
+
+// Run task(arg, i) for every i in [0, count) and wait for all of them.
+// A NULL pool runs the loop on the calling thread. Loops started from
+// different threads run one after another; a task must not start a loop on
+// the same pool.
+void thread_pool_parallel_for(ThreadPool* pool, size_t count, ThreadPoolTask task, void* arg);
+
+// Items per chunk when a loop over `count` items (rows, variables, ...) is
+// split into a few chunks per thread, so uneven items still balance out,
+// but no chunk smaller than is worth a thread
+size_t thread_pool_chunk_size(const ThreadPool* pool, size_t count);
+
+// Number of chunks of `chunk_size` items covering `count` items
+size_t thread_pool_chunk_count(size_t count, size_t chunk_size);
+
+// Items [*begin, *end) of chunk `chunk`
+void thread_pool_chunk_range(size_t chunk, size_t chunk_size, size_t count, size_t* begin,
+                             size_t* end);
+
+#endif // THREAD_POOL_H
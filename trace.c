@@ -0,0 +1,348 @@
+/*
+ * trace.c - Phase timestamps as a Chrome trace-event file
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Events per buffer chunk; a thread's buffer is a list of chunks
+#define TRACE_CHUNK_EVENTS 4096
+
+typedef struct {
+    const char* phase;         // as passed to log_timestamp, or a span's new name
+    uint64_t time_ns;          // CLOCK_MONOTONIC
+    int rename;                // renames the span the previous event closed;
+                               // the name is then an owned copy
+} TraceEvent;
+
+typedef struct TraceChunk {
+    struct TraceChunk* next;
+    size_t count;
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+} TraceChunk;
+
+typedef struct TraceThread {
+    struct TraceThread* next;  // all registered threads, newest first
+    int tid;
+    TraceChunk* first;
+    TraceChunk* last;
+    size_t dropped;            // events lost to a failed allocation
+} TraceThread;
+
+// One event as written: a span begin (B) or end (E), or an instant (i)
+typedef struct {
+    const char* name;
+    size_t length;
+    uint64_t time_ns;
+    char ph;
+} TraceOutput;
+
+static FILE* trace_file = NULL;
+static const char* trace_filename = NULL;
+static uint64_t trace_start_ns = 0;
+
+// Registration only; events are appended without a lock
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static TraceThread* trace_threads = NULL;
+static int trace_next_tid = 1;
+
+static __thread TraceThread* trace_current = NULL;
+
+static uint64_t timespec_ns(const struct timespec* time) {
+    return (uint64_t)time->tv_sec * 1000000000u + (uint64_t)time->tv_nsec;
+}
+
+// Give the calling thread its buffer; NULL if out of memory
+static TraceThread* register_thread(void) {
+    TraceThread* thread = calloc(1, sizeof(TraceThread));
+    if (!thread) {
+        return NULL;
+    }
+    pthread_mutex_lock(&trace_mutex);
+    thread->tid = trace_next_tid++;
+    thread->next = trace_threads;
+    trace_threads = thread;
+    pthread_mutex_unlock(&trace_mutex);
+    trace_current = thread;
+    return thread;
+}
+
+// Room for one more event in the buffer of `thread`; NULL if out of memory
+static TraceEvent* append_event(TraceThread* thread) {
+    TraceChunk* chunk = thread->last;
+    if (!chunk || chunk->count == TRACE_CHUNK_EVENTS) {
+        chunk = malloc(sizeof(TraceChunk));
+        if (!chunk) {
+            thread->dropped++;
+            return NULL;
+        }
+        chunk->next = NULL;
+        chunk->count = 0;
+        if (thread->last) {
+            thread->last->next = chunk;
+        } else {
+            thread->first = chunk;
+        }
+        thread->last = chunk;
+    }
+    return &chunk->events[chunk->count++];
+}
+
+static int has_suffix(const char* phase, size_t length, const char* suffix, size_t suffix_length) {
+    return length > suffix_length &&
+           memcmp(phase + length - suffix_length, suffix, suffix_length) == 0;
+}
+
+void trace_record(const char* phase, const struct timespec* now) {
+    TraceThread* thread = trace_current ? trace_current : register_thread();
+    if (!thread) {
+        return;
+    }
+    TraceEvent* event = append_event(thread);
+    if (event) {
+        event->phase = phase;
+        event->time_ns = timespec_ns(now);
+        event->rename = 0;
+    }
+}
+
+void trace_name_span(const char* name) {
+    TraceThread* thread = trace_current;
+    if (!thread || !thread->last || thread->last->count == 0) {
+        return;
+    }
+    const TraceEvent* previous = &thread->last->events[thread->last->count - 1];
+    size_t previous_length = strlen(previous->phase);
+    if (previous->rename || !has_suffix(previous->phase, previous_length, "_END", 4)) {
+        return;
+    }
+    // Only X_END followed by X_<something>: the span is already called X
+    // when the names match, and any other phase is unrelated
+    size_t base = previous_length - 4;
+    size_t length = strlen(name);
+    if (length <= base + 1 || memcmp(name, previous->phase, base) != 0 || name[base] != '_') {
+        return;
+    }
+    char* copy = malloc(length + 1);
+    if (!copy) {
+        thread->dropped++;
+        return;
+    }
+    memcpy(copy, name, length + 1);
+    uint64_t time_ns = previous->time_ns;
+    TraceEvent* event = append_event(thread);
+    if (!event) {
+        free(copy);
+        return;
+    }
+    event->phase = copy;
+    event->time_ns = time_ns;
+    event->rename = 1;
+}
+
+// Write `length` bytes of `name` as a JSON string
+static void write_name(FILE* file, const char* name, size_t length) {
+    fputc('"', file);
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)name[i];
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if (c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static void write_event(FILE* file, long pid, int tid, const TraceOutput* event) {
+    uint64_t offset = event->time_ns > trace_start_ns ? event->time_ns - trace_start_ns : 0;
+    fputs(",\n{\"name\":", file);
+    write_name(file, event->name, event->length);
+    fprintf(file, ",\"ph\":\"%c\",\"pid\":%ld,\"tid\":%d,\"ts\":%llu.%03llu", event->ph, pid,
+            tid, (unsigned long long)(offset / 1000), (unsigned long long)(offset % 1000));
+    fputs(event->ph == 'i' ? ",\"s\":\"t\"}" : "}", file);
+}
+
+// Write the events of one thread, using `out` (two entries per event) and
+// `stack` (one per event) as scratch. Spans are closed innermost first: an
+// _END closes any span opened inside its own that is still open (an error
+// path skipped its _END), an _END without a matching _START is dropped, and
+// spans still open at the end close at the thread's last event. A rename
+// right after an _END gives the span it closed the new name, begin and end.
+static void write_thread(FILE* file, long pid, const TraceThread* thread, TraceOutput* out,
+                         size_t* stack) {
+    size_t count = 0, depth = 0;
+    size_t closed_begin = SIZE_MAX, closed_end = 0;  // span the previous event closed
+    uint64_t last_ns = 0;
+    for (const TraceChunk* chunk = thread->first; chunk; chunk = chunk->next) {
+        for (size_t i = 0; i < chunk->count; i++) {
+            const TraceEvent* event = &chunk->events[i];
+            size_t length = strlen(event->phase);
+            if (event->rename) {
+                if (closed_begin != SIZE_MAX) {
+                    out[closed_begin].name = out[closed_end].name = event->phase;
+                    out[closed_begin].length = out[closed_end].length = length;
+                }
+                closed_begin = SIZE_MAX;
+                continue;
+            }
+            closed_begin = SIZE_MAX;
+            last_ns = event->time_ns;
+            TraceOutput* output = &out[count];
+            output->name = event->phase;
+            output->length = length;
+            output->time_ns = event->time_ns;
+            if (has_suffix(event->phase, length, "_START", 6)) {
+                output->ph = 'B';
+                output->length = length - 6;
+                stack[depth++] = count++;
+            } else if (has_suffix(event->phase, length, "_END", 4)) {
+                size_t open = depth;
+                while (open > 0 && (out[stack[open - 1]].length != length - 4 ||
+                                    memcmp(out[stack[open - 1]].name, event->phase,
+                                           length - 4) != 0)) {
+                    open--;
+                }
+                if (open == 0) {
+                    continue;
+                }
+                while (depth >= open) {
+                    const TraceOutput* begin = &out[stack[--depth]];
+                    out[count] = *begin;
+                    out[count].ph = 'E';
+                    out[count].time_ns = event->time_ns;
+                    count++;
+                }
+                closed_begin = stack[depth];
+                closed_end = count - 1;
+            } else {
+                output->ph = 'i';
+                count++;
+            }
+        }
+    }
+    while (depth > 0) {
+        out[count] = out[stack[--depth]];
+        out[count].ph = 'E';
+        out[count].time_ns = last_ns;
+        count++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        write_event(file, pid, thread->tid, &out[i]);
+    }
+}
+
+// Write the buffered events at exit and release the buffers
+static void trace_flush(void) {
+    FILE* file = trace_file;
+    if (!file) {
+        return;
+    }
+    trace_file = NULL;
+    long pid = (long)getpid();
+
+    // Threads in the order they first recorded, with the largest buffer
+    // sizing the span stack
+    pthread_mutex_lock(&trace_mutex);
+    TraceThread* threads = NULL;
+    while (trace_threads) {
+        TraceThread* thread = trace_threads;
+        trace_threads = thread->next;
+        thread->next = threads;
+        threads = thread;
+    }
+    pthread_mutex_unlock(&trace_mutex);
+    size_t max_events = 0, dropped = 0;
+    for (const TraceThread* thread = threads; thread; thread = thread->next) {
+        size_t events = 0;
+        for (const TraceChunk* chunk = thread->first; chunk; chunk = chunk->next) {
+            events += chunk->count;
+        }
+        if (events > max_events) {
+            max_events = events;
+        }
+        dropped += thread->dropped;
+    }
+    size_t scratch = max_events ? max_events : 1;
+    TraceOutput* out = malloc(2 * scratch * sizeof(TraceOutput));
+    size_t* stack = malloc(scratch * sizeof(size_t));
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":1,"
+            "\"args\":{\"name\":\"cuopt_json_to_c_api\"}}", pid);
+    for (const TraceThread* thread = threads; thread; thread = thread->next) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%d,"
+                "\"args\":{\"name\":", pid, thread->tid);
+        if (thread->tid == 1) {
+            fputs("\"main\"}}", file);
+        } else {
+            fprintf(file, "\"thread %d\"}}", thread->tid);
+        }
+        if (out && stack) {
+            write_thread(file, pid, thread, out, stack);
+        }
+    }
+    fputs("\n]}\n", file);
+
+    if (fclose(file) != 0 || !out || !stack) {
+        fprintf(stderr, "Error: Failed to write trace file '%s'\n", trace_filename);
+    } else if (dropped > 0) {
+        fprintf(stderr, "Warning: %zu trace event(s) were dropped for lack of memory\n", dropped);
+    }
+    free(out);
+    free(stack);
+    while (threads) {
+        TraceThread* thread = threads;
+        threads = thread->next;
+        while (thread->first) {
+            TraceChunk* chunk = thread->first;
+            thread->first = chunk->next;
+            for (size_t i = 0; i < chunk->count; i++) {
+                if (chunk->events[i].rename) {
+                    free((char*)chunk->events[i].phase);
+                }
+            }
+            free(chunk);
+        }
+        free(thread);
+    }
+}
+
+int trace_open(const char* filename) {
+    if (trace_file) {
+        printf("Error: Tracing is already enabled\n");
+        return -1;
+    }
+    // Open now, so a bad path fails before anything runs
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        printf("Error: Cannot open trace file '%s'\n", filename);
+        return -1;
+    }
+    if (!register_thread() || atexit(trace_flush) != 0) {
+        printf("Error: Memory allocation failed\n");
+        fclose(file);
+        return -1;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    trace_start_ns = timespec_ns(&now);
+    trace_filename = filename;
+    trace_file = file;
+    return 0;
+}
+
+int trace_enabled(void) {
+    return trace_file != NULL;
+}
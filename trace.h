@@ -0,0 +1,41 @@
+/*
+ * trace.h - Phase timestamps as a Chrome trace-event file
+ *
+ * With --trace, every log_timestamp() call is also recorded as a trace
+ * event, whether or not --timing prints it. A phase "X_START" opens a span
+ * and "X_END" closes it; any other phase becomes an instant event. The
+ * span is named after the log_phase_duration() that reports it, so trace
+ * and --timing output match: X, or X_TOTAL where the duration right after
+ * X_END is reported as that. Spans nest in the order they were opened on
+ * their thread, so a trace shows JSON_PARSE_TOTAL containing
+ * CSR_MATRIX_PARSE and so on.
+ *
+ * Recording only appends a pointer to the phase name and a timestamp to a
+ * buffer owned by the calling thread, so no lock is taken after a thread's
+ * first event. The buffers are written out when the program exits, as the
+ * JSON object format read by Perfetto and chrome://tracing, with one track
+ * per thread. Timestamp phase names must outlive the trace (every caller
+ * passes a string literal); span names taken from a duration are copied.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <time.h>
+
+// Start tracing to `filename`, which is written at exit. Call from the main
+// thread before any other thread starts. Returns 0 on success, -1 on
+// failure (an error has been printed).
+int trace_open(const char* filename);
+
+// Nonzero once trace_open() has succeeded
+int trace_enabled(void);
+
+// Record `phase`, reached at `now` (CLOCK_MONOTONIC), on the calling thread
+void trace_record(const char* phase, const struct timespec* now);
+
+// Name the span that the calling thread's last event (X_END) closed `name`,
+// if `name` extends X with a suffix such as _TOTAL. `name` is copied.
+void trace_name_span(const char* name);
+
+#endif // TRACE_H